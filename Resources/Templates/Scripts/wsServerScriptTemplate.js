@@ -17,4 +17,15 @@ function wsMessageReceived(connectionId, message)
 function wsDataReceived(connectionId, data)
 {
 	script.log("Websocket data received from "+connectionId+" : " +data);
-}
\ No newline at end of file
+}
+
+/*
+Clients can be gathered in named groups, so a message is sent to all the clients of a group in one go.
+Groups are emptied when clients disconnect.
+
+local.addClientToGroup(connectionId, "dashboards");
+local.removeClientFromGroup(connectionId, "dashboards");
+local.getGroupClients("dashboards"); //returns the connection ids of the group
+local.sendToGroup("dashboards", message);
+local.sendBytesToGroup("dashboards", bytes);
+*/
\ No newline at end of file
@@ -70,6 +70,8 @@ ChataigneEngine::ChataigneEngine() :
 
 
 	getAppSettings()->addChildControllableContainer(&defaultBehaviors);
+
+	compactSessionFormat = getAppSettings()->addBoolParameter("Compact Session Format", "If checked, sessions are saved in a compressed binary container that loads much faster, especially for big sessions. Files saved this way can't be opened with older versions of Chataigne.", false);
 }
 
 ChataigneEngine::~ChataigneEngine()
@@ -85,6 +87,7 @@ ChataigneEngine::~ChataigneEngine()
 #endif
 
 	ConsequenceStaggerLauncher::deleteInstance();
+	MetronomeScheduler::deleteInstance();
 
 	ZeroconfManager::deleteInstance();
 	CommunityModuleManager::deleteInstance();
@@ -93,6 +96,7 @@ ChataigneEngine::~ChataigneEngine()
 	ChataigneSequenceManager::deleteInstance();
 	StateManager::deleteInstance();
 	ModuleManager::deleteInstance();
+	ConnectionSupervisor::deleteInstance();
 
 	MIDIManager::deleteInstance();
 	DMXManager::deleteInstance();
@@ -130,6 +134,24 @@ var ChataigneEngine::getJSONData(bool includeNonOverriden)
 {
 	var data = Engine::getJSONData(includeNonOverriden);
 
+	if (compactSessionFormat->boolValue())
+	{
+		SessionArchive archive;
+		archive.addSection(ModuleManager::getInstance()->shortName, ModuleManager::getInstance()->getJSONData());
+		archive.addSection(CVGroupManager::getInstance()->shortName, CVGroupManager::getInstance()->getJSONData());
+		archive.addSection(StateManager::getInstance()->shortName, StateManager::getInstance()->getJSONData());
+
+		//layers hold most of the data (automation keys, audio clips...), they are decoded in parallel on load and only built when each sequence is first used
+		var seqData = ChataigneSequenceManager::getInstance()->getJSONData();
+		SessionArchive::packDeferredProperty(seqData, "layers");
+		archive.addSection(ChataigneSequenceManager::getInstance()->shortName, seqData);
+
+		archive.addSection(ModuleRouterManager::getInstance()->shortName, ModuleRouterManager::getInstance()->getJSONData());
+
+		data.getDynamicObject()->setProperty("sessionArchive", archive.toBase64());
+		return data;
+	}
+
 	var mData = ModuleManager::getInstance()->getJSONData();
 	if (!mData.isVoid() && mData.getDynamicObject()->getProperties().size() > 0) data.getDynamicObject()->setProperty(ModuleManager::getInstance()->shortName, mData);
 
@@ -158,31 +180,61 @@ void ChataigneEngine::loadJSONDataInternalEngine(var data, ProgressTask* loading
 
 	ModuleManager::getInstance()->factory->updateCustomModules(false);
 
-	moduleTask->start();
-	ModuleManager::getInstance()->loadJSONData(data.getProperty(ModuleManager::getInstance()->shortName, var()));
-	moduleTask->setProgress(1);
-	moduleTask->end();
+	StringArray timings;
+	double loadStartTime = Time::getMillisecondCounterHiRes();
 
-	cvTask->start();
-	CVGroupManager::getInstance()->loadJSONData(data.getProperty(CVGroupManager::getInstance()->shortName, var()));
-	cvTask->setProgress(1);
-	cvTask->end();
+	var sessionData = data;
+	var archiveData = data.getProperty("sessionArchive", var());
+	if (archiveData.isString())
+	{
+		//compact session, all sections are decoded in parallel before building the managers
+		double t = Time::getMillisecondCounterHiRes();
+		SessionArchive archive;
+		if (!archive.loadFromBase64(archiveData.toString()))
+		{
+			NLOGERROR(niceName, "Session archive is corrupted, can't load the session");
+			for (auto& t : { moduleTask, cvTask, stateTask, sequenceTask, routerTask }) t->end();
+			return;
+		}
 
-	stateTask->start();
-	StateManager::getInstance()->loadJSONData(data.getProperty(StateManager::getInstance()->shortName, var()));
-	stateTask->setProgress(1);
-	stateTask->end();
+		archive.decodeAll();
 
-	sequenceTask->start();
-	ChataigneSequenceManager::getInstance()->loadJSONData(data.getProperty(ChataigneSequenceManager::getInstance()->shortName, var()));
-	sequenceTask->setProgress(1);
-	sequenceTask->end();
+		sessionData = var(new DynamicObject());
+		for (auto& s : archive.sections)
+		{
+			if (!s->isValid) NLOGWARNING(niceName, "Could not decode session section " << s->name);
+			sessionData.getDynamicObject()->setProperty(s->name, s->data);
+			timings.add(s->name + " decode : " + String(s->decodeTime, 1) + "ms");
+		}
+
+		timings.add("Archive total decode : " + String(Time::getMillisecondCounterHiRes() - t, 1) + "ms");
+	}
+
+	loadManagerData(ModuleManager::getInstance(), sessionData, moduleTask, timings);
+	loadManagerData(CVGroupManager::getInstance(), sessionData, cvTask, timings);
+	loadManagerData(StateManager::getInstance(), sessionData, stateTask, timings);
+	loadManagerData(ChataigneSequenceManager::getInstance(), sessionData, sequenceTask, timings);
+
+	//layers of compact sessions that something points to must exist before the routers and the links are resolved, the others are built on first use
+	double layersTime = Time::getMillisecondCounterHiRes();
+	ChataigneSequenceManager::getInstance()->loadDeferredLayers(sessionData);
+	timings.add("Referenced sequence layers : " + String(Time::getMillisecondCounterHiRes() - layersTime, 1) + "ms");
+
+	loadManagerData(ModuleRouterManager::getInstance(), sessionData, routerTask, timings);
+
+	NLOG(niceName, "Session loaded in " << String(Time::getMillisecondCounterHiRes() - loadStartTime, 1) << "ms :\n" << timings.joinIntoString("\n"));
+}
+
+void ChataigneEngine::loadManagerData(ControllableContainer* manager, var data, ProgressTask* task, StringArray& timings)
+{
+	double t = Time::getMillisecondCounterHiRes();
 
-	routerTask->start();
-	ModuleRouterManager::getInstance()->loadJSONData(data.getProperty(ModuleRouterManager::getInstance()->shortName, var()));
-	routerTask->setProgress(1);
-	routerTask->end();
+	task->start();
+	manager->loadJSONData(data.getProperty(manager->shortName, var()));
+	task->setProgress(1);
+	task->end();
 
+	timings.add(manager->niceName + " : " + String(Time::getMillisecondCounterHiRes() - t, 1) + "ms");
 }
 
 void ChataigneEngine::childStructureChanged(ControllableContainer* cc)
@@ -25,11 +25,13 @@ public:
 
 	//Global Settings
 	ControllableContainer defaultBehaviors;
+	BoolParameter* compactSessionFormat;
 	
 	void clearInternal() override;
 
 	var getJSONData(bool includeNonOverriden = false) override;
 	void loadJSONDataInternalEngine(var data, ProgressTask * loadingTask) override;
+	void loadManagerData(ControllableContainer* manager, var data, ProgressTask* task, StringArray& timings);
 
 	void childStructureChanged(ControllableContainer * cc) override;
 	void controllableFeedbackUpdate(ControllableContainer * cc, Controllable * c) override;
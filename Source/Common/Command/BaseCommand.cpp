@@ -202,22 +202,37 @@ void BaseCommand::trigger(int multiplexIndex)
 	triggerInternal(multiplexIndex);
 }
 
-void BaseCommand::setValue(var value, int multiplexIndex)
+void BaseCommand::triggerMultiplexRange(int startIndex, int endIndex)
 {
-	updateMappingInputValue(value, multiplexIndex);
+	if (moduleRef.wasObjectDeleted())
+	{
+		DBG("Module removed, not processing that");
+		return;
+	}
+
+	triggerMultiplexRangeInternal(startIndex, endIndex);
+}
+
+void BaseCommand::triggerMultiplexRangeInternal(int startIndex, int endIndex)
+{
+	for (int i = startIndex; i < endIndex; i++) triggerInternal(i);
+}
+
+void BaseCommand::setValue(var value, int multiplexIndex, const BigInteger* changedComponents)
+{
+	updateMappingInputValue(value, multiplexIndex, changedComponents);
 	setValueInternal(value, multiplexIndex);
 	trigger(multiplexIndex);
 }
 
-
-void BaseCommand::updateMappingInputValue(var value, int multiplexIndex)
+void BaseCommand::updateMappingInputValue(var value, int multiplexIndex, const BigInteger* changedComponents)
 {
-	for (auto& pLink : paramLinks) if(pLink != nullptr) pLink->updateMappingInputValue(value, multiplexIndex);
+	for (auto& pLink : paramLinks) if(pLink != nullptr) pLink->updateMappingInputValue(value, multiplexIndex, changedComponents);
 	if (customValuesManager != nullptr)
 	{
 		for (auto& cv : customValuesManager->items)
 		{
-			if (cv->paramLink != nullptr) cv->paramLink->updateMappingInputValue(value, multiplexIndex);
+			if (cv->paramLink != nullptr) cv->paramLink->updateMappingInputValue(value, multiplexIndex, changedComponents);
 		}
 	}
 }
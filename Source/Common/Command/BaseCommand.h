@@ -55,10 +55,12 @@ public:
 	virtual void setMappingValueType(Controllable::Type type);
     virtual void trigger(int multiplexIndex = 0); //for trigger, will check validity of module
     virtual void triggerInternal(int multiplexIndex) {} // to be overriden
-	virtual void setValue(var value, int multiplexIndex); //for mapping context
+	virtual void triggerMultiplexRange(int startIndex, int endIndex); //trigger all indices in [startIndex, endIndex[ at once, will check validity of module
+	virtual void triggerMultiplexRangeInternal(int startIndex, int endIndex); //default calls triggerInternal for each index, override to batch
+	virtual void setValue(var value, int multiplexIndex, const BigInteger* changedComponents = nullptr); //for mapping context, changedComponents tells which components changed since the last call (nullptr means all)
 	virtual void setValueInternal(var value, int multiplexIndex) {}
 
-	virtual void updateMappingInputValue(var value, int multiplexIndex);
+	virtual void updateMappingInputValue(var value, int multiplexIndex, const BigInteger* changedComponents = nullptr);
 
 	virtual void setInputNamesFromParams(Array<WeakReference<Parameter>> outParams) override;
 
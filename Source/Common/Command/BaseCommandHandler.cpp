@@ -48,6 +48,11 @@ void BaseCommandHandler::triggerCommand(int multiplexIndex)
 	if (command != nullptr) command->trigger(multiplexIndex);
 }
 
+void BaseCommandHandler::triggerCommandMultiplexRange(int startIndex, int endIndex)
+{
+	if (command != nullptr) command->triggerMultiplexRange(startIndex, endIndex);
+}
+
 void BaseCommandHandler::setCommand(CommandDefinition* commandDef)
 {
 	if (!commandDefinition.wasObjectDeleted() && commandDefinition == commandDef) return;
@@ -42,6 +42,7 @@ public:
 	var ghostCommandData;
 
 	virtual void triggerCommand(int multiplexIndex = 0); //to override and call back for checking (e.g. enable in Consequence)
+	virtual void triggerCommandMultiplexRange(int startIndex, int endIndex); //same as above, for a whole multiplex range at once
 
 	virtual void setCommand(CommandDefinition*);
 
@@ -11,6 +11,9 @@
 #include "CommonIncludes.h"
 #include "MainIncludes.h"
 
+#include "Timecode/TimecodeChaser.cpp"
+#include "Session/SessionArchive.cpp"
+
 #include "MIDI/MIDIDevice.cpp"
 #include "MIDI/MIDIDeviceParameter.cpp"
 #include "MIDI/MIDIManager.cpp"
@@ -22,6 +25,8 @@
 
 #include "Zeroconf/ZeroconfManager.cpp" 
 
+#include "Connection/ConnectionSupervisor.cpp"
+
 #include "LTC/ltc.c"
 #include "LTC/timecode.c"
 #include "LTC/encoder.c"
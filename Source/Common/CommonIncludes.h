@@ -27,6 +27,9 @@ using namespace SimpleBLE;
 #endif
 
 
+#include "Timecode/TimecodeChaser.h"
+#include "Session/SessionArchive.h"
+
 #include "MIDI/MIDIDevice.h"
 #include "MIDI/MIDIManager.h"
 #include "MIDI/MIDIDeviceParameter.h"
@@ -43,6 +46,8 @@ using namespace SimpleBLE;
 
 #include "Zeroconf/ZeroconfManager.h"
 
+#include "Connection/ConnectionSupervisor.h"
+
 #include "InputSystem/InputSystemManager.h"
 #include "InputSystem/InputDeviceHelpers.h"
 
@@ -0,0 +1,289 @@
+/*
+  ==============================================================================
+
+	ConnectionSupervisor.cpp
+	Created: 19 Oct 2026 2:41:17pm
+	Author:  bkupe
+
+  ==============================================================================
+*/
+
+juce_ImplementSingleton(ConnectionSupervisor)
+
+ConnectionSupervisor::ConnectionSupervisor() :
+	Thread("Connection Supervisor"),
+	minRetryDelay(500),
+	maxRetryDelay(30000),
+	pool(4)
+{
+	startThread();
+}
+
+ConnectionSupervisor::~ConnectionSupervisor()
+{
+	stopThread(1000);
+	pool.removeAllJobs(true, 4000);
+}
+
+void ConnectionSupervisor::Client::addConnectionValues(ControllableContainer* cc)
+{
+	connectionState = cc->addEnumParameter("Connection State", "State of the connection, as handled by the reconnect supervisor");
+	connectionState->addOption("Disconnected", DISCONNECTED)->addOption("Connecting", CONNECTING)->addOption("Connected", CONNECTED)->addOption("Waiting Retry", WAITING_RETRY);
+	connectionState->setControllableFeedbackOnly(true);
+
+	connectionLatency = cc->addFloatParameter("Connection Latency", "Time in milliseconds taken by the last connection, or by the last round trip measured by the health probe when the protocol has one", 0, 0);
+	connectionLatency->setControllableFeedbackOnly(true);
+}
+
+void ConnectionSupervisor::addClient(Client* c, int connectTimeoutMS, int probeIntervalMS)
+{
+	GenericScopedLock lock(entriesLock);
+	if (getEntry(c) != nullptr) return;
+
+	Entry* e = entries.add(new Entry());
+	e->client = c;
+	e->job.reset(new SupervisorJob(this, e));
+	e->connectTimeout = connectTimeoutMS;
+	e->probeInterval = probeIntervalMS;
+
+	notify();
+}
+
+void ConnectionSupervisor::removeClient(Client* c)
+{
+	std::unique_ptr<Entry> e;
+	{
+		GenericScopedLock lock(entriesLock);
+		e.reset(getEntry(c));
+		if (e == nullptr) return;
+		entries.removeObject(e.get(), false);
+
+		for (int i = stateUpdates.size() - 1; i >= 0; i--) if (stateUpdates.getReference(i).client == c) stateUpdates.remove(i);
+	}
+
+	//a queued job is just dropped, a running one is waited for as it's using the client
+	pool.removeJob(e->job.get(), true, -1);
+
+	//and updates being applied right now may still target this client
+	GenericScopedLock lock(applyLock);
+}
+
+void ConnectionSupervisor::resetClient(Client* c)
+{
+	{
+		GenericScopedLock lock(entriesLock);
+		Entry* e = getEntry(c);
+		if (e == nullptr) return;
+
+		e->numFailures = 0;
+		e->nextTime = 0;
+		if (e->state != CONNECTING) setState(e, DISCONNECTED);
+	}
+
+	applyStateUpdates();
+	notify();
+}
+
+void ConnectionSupervisor::connectionAttemptStarted(Client* c)
+{
+	{
+		GenericScopedLock lock(entriesLock);
+		Entry* e = getEntry(c);
+		if (e == nullptr) return;
+
+		e->numFailures = 0;
+		e->attemptTime = Time::getMillisecondCounterHiRes();
+		setState(e, CONNECTING);
+	}
+
+	applyStateUpdates();
+}
+
+int ConnectionSupervisor::getRetryDelay(int numFailures)
+{
+	//exponential back-off with jitter, between half and full delay
+	double delay = jmin<double>(maxRetryDelay, minRetryDelay * std::pow(2.0, jmin(numFailures, 16)));
+	return (int)(delay * (.5 + random.nextDouble() * .5));
+}
+
+ConnectionSupervisor::Entry* ConnectionSupervisor::getEntry(Client* c)
+{
+	for (auto& e : entries) if (e->client == c) return e;
+	return nullptr;
+}
+
+void ConnectionSupervisor::setState(Entry* e, ConnectionState state)
+{
+	e->state = state;
+
+	StateUpdate u;
+	u.client = e->client;
+	u.state = state;
+	stateUpdates.add(u);
+}
+
+void ConnectionSupervisor::setLatency(Entry* e, double latencyMS)
+{
+	StateUpdate u;
+	u.client = e->client;
+	u.isLatency = true;
+	u.latency = latencyMS;
+	stateUpdates.add(u);
+}
+
+void ConnectionSupervisor::applyStateUpdates()
+{
+	GenericScopedLock applyScope(applyLock);
+
+	Array<StateUpdate> updates;
+	{
+		GenericScopedLock lock(entriesLock);
+		updates.swapWith(stateUpdates);
+	}
+
+	for (auto& u : updates)
+	{
+		{
+			//removed in the meantime, removeClient is now waiting for applyLock before deleting it
+			GenericScopedLock lock(entriesLock);
+			if (getEntry(u.client) == nullptr) continue;
+		}
+
+		if (u.isLatency)
+		{
+			if (u.client->connectionLatency != nullptr) u.client->connectionLatency->setValue(u.latency);
+		}
+		else
+		{
+			if (u.client->connectionState != nullptr) u.client->connectionState->setValueWithData(u.state);
+		}
+	}
+}
+
+void ConnectionSupervisor::startAttempt(Entry* e, double now)
+{
+	e->attemptTime = now;
+	e->busy = true;
+	setState(e, CONNECTING);
+
+	e->job->isProbe = false;
+	pool.addJob(e->job.get(), false);
+}
+
+void ConnectionSupervisor::startProbe(Entry* e)
+{
+	e->busy = true;
+
+	e->job->isProbe = true;
+	pool.addJob(e->job.get(), false);
+}
+
+ConnectionSupervisor::SupervisorJob::SupervisorJob(ConnectionSupervisor* supervisor, Entry* e) :
+	ThreadPoolJob("Connection Supervisor Job"),
+	supervisor(supervisor),
+	entry(e),
+	isProbe(false)
+{
+}
+
+ThreadPoolJob::JobStatus ConnectionSupervisor::SupervisorJob::runJob()
+{
+	if (isProbe)
+	{
+		double latency = -1;
+		bool ok = entry->client->probeConnection(latency);
+		entry->probeLatency = latency;
+		entry->probeFailed = !ok;
+	}
+	else
+	{
+		entry->client->attemptConnection();
+	}
+
+	entry->busy = false;
+	supervisor->notify();
+	return jobHasFinished;
+}
+
+void ConnectionSupervisor::run()
+{
+	while (!threadShouldExit())
+	{
+		double now = Time::getMillisecondCounterHiRes();
+
+		{
+			GenericScopedLock lock(entriesLock);
+
+			for (auto& e : entries)
+			{
+				if (e->busy || pool.contains(e->job.get())) continue; //the job can only be queued again once the pool released it
+
+				if (!e->client->isSupervisedConnectionNeeded())
+				{
+					if (e->state != DISCONNECTED) setState(e, DISCONNECTED);
+					e->numFailures = 0;
+					e->nextTime = 0;
+					continue;
+				}
+
+				bool connected = e->client->isSupervisedConnected();
+
+				switch (e->state)
+				{
+				case CONNECTED:
+					if (e->probeFailed || !connected)
+					{
+						//lost, first retry comes quickly but still jittered
+						e->probeFailed = false;
+						e->numFailures = 0;
+						e->nextTime = now + getRetryDelay(0);
+						setState(e, WAITING_RETRY);
+					}
+					else
+					{
+						double latency = e->probeLatency.exchange(-1);
+						if (latency >= 0) setLatency(e, latency);
+						if (now >= e->nextTime)
+						{
+							e->nextTime = now + e->probeInterval;
+							startProbe(e);
+						}
+					}
+					break;
+
+				case CONNECTING:
+					if (connected)
+					{
+						setLatency(e, now - e->attemptTime);
+						e->numFailures = 0;
+						e->nextTime = now + e->probeInterval;
+						setState(e, CONNECTED);
+					}
+					else if (now - e->attemptTime > e->connectTimeout)
+					{
+						e->numFailures++;
+						e->nextTime = now + getRetryDelay(e->numFailures);
+						setState(e, WAITING_RETRY);
+					}
+					break;
+
+				case DISCONNECTED:
+				case WAITING_RETRY:
+					if (connected)
+					{
+						e->nextTime = now + e->probeInterval;
+						setState(e, CONNECTED);
+					}
+					else if (now >= e->nextTime)
+					{
+						startAttempt(e, now);
+					}
+					break;
+				}
+			}
+		}
+
+		applyStateUpdates();
+		wait(20);
+	}
+}
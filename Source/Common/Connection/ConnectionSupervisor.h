@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+	ConnectionSupervisor.h
+	Created: 19 Oct 2026 2:41:17pm
+	Author:  bkupe
+
+  ==============================================================================
+*/
+
+#pragma once
+
+/*
+Shared reconnect and keep-alive scheduler for client modules.
+Connection attempts and health probes run on a small thread pool, never on the message thread, so an unreachable host
+can't stall the UI or the other connections. Retries are spaced with a jittered exponential back-off so a network blip
+doesn't make all the clients reconnect at the same time.
+*/
+class ConnectionSupervisor :
+	public Thread
+{
+public:
+	juce_DeclareSingleton(ConnectionSupervisor, true);
+
+	ConnectionSupervisor();
+	~ConnectionSupervisor();
+
+	enum ConnectionState { DISCONNECTED, CONNECTING, CONNECTED, WAITING_RETRY };
+
+	class Client
+	{
+	public:
+		virtual ~Client() {}
+
+		EnumParameter* connectionState = nullptr;
+		FloatParameter* connectionLatency = nullptr;
+
+		void addConnectionValues(ControllableContainer* cc);
+
+		virtual bool isSupervisedConnectionNeeded() { return true; } //false when disabled or when there is nothing to connect to
+		virtual bool isSupervisedConnected() = 0;
+		virtual void attemptConnection() = 0; //called from a pool thread, it may block for a short connect timeout or connect asynchronously
+		//called from a pool thread while connected, false if the connection is dead.
+		//latencyMS is only set when the probe measured a real round trip, it stays at -1 otherwise and nothing is published
+		virtual bool probeConnection(double& /*latencyMS*/) { return isSupervisedConnected(); }
+	};
+
+	int minRetryDelay; //ms
+	int maxRetryDelay; //ms
+
+	void addClient(Client* c, int connectTimeoutMS = 5000, int probeIntervalMS = 5000);
+	void removeClient(Client* c); //cancels a queued attempt or probe of this client, or waits for the running one
+	void resetClient(Client* c); //settings have changed, retry now
+	void connectionAttemptStarted(Client* c); //the client started an attempt by itself, wait for it before retrying
+
+	int getRetryDelay(int numFailures);
+
+	void run() override;
+
+private:
+	struct Entry;
+
+	class SupervisorJob :
+		public ThreadPoolJob
+	{
+	public:
+		SupervisorJob(ConnectionSupervisor* supervisor, Entry* e);
+
+		ConnectionSupervisor* supervisor;
+		Entry* entry;
+		bool isProbe;
+
+		JobStatus runJob() override;
+	};
+
+	struct Entry
+	{
+		Client* client = nullptr;
+		ConnectionState state = DISCONNECTED;
+		int connectTimeout = 5000;
+		int probeInterval = 5000;
+		int numFailures = 0;
+		double nextTime = 0;
+		double attemptTime = 0;
+		std::atomic<bool> busy{ false };
+		std::atomic<bool> probeFailed{ false };
+		std::atomic<double> probeLatency{ -1 };
+		std::unique_ptr<SupervisorJob> job;
+	};
+
+	//Parameter changes are collected under entriesLock and applied after releasing it, so listeners never run with it held
+	struct StateUpdate
+	{
+		Client* client = nullptr;
+		bool isLatency = false;
+		ConnectionState state = DISCONNECTED;
+		double latency = 0;
+	};
+
+	CriticalSection entriesLock;
+	OwnedArray<Entry> entries;
+	Array<StateUpdate> stateUpdates;
+	CriticalSection applyLock; //held while applying updates, so a client can't be deleted in between
+	ThreadPool pool;
+	Random random;
+
+	Entry* getEntry(Client* c);
+	void setState(Entry* e, ConnectionState state);
+	void setLatency(Entry* e, double latencyMS);
+	void applyStateUpdates();
+	void startAttempt(Entry* e, double now);
+	void startProbe(Entry* e);
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ConnectionSupervisor)
+};
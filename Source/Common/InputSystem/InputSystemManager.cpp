@@ -13,9 +13,10 @@ juce_ImplementSingleton(InputSystemManager)
 InputSystemManager::InputSystemManager() :
 	Thread("ISM"),
 	isBeingDestroyed(false),
+	updateInterval(20),
 	inputQueuedNotifier(10)
 {
-
+	SDL_SetHint(SDL_HINT_JOYSTICK_ALLOW_BACKGROUND_EVENTS, "1");
 	isInit = SDL_Init(SDL_INIT_GAMECONTROLLER | SDL_INIT_EVENTS) == 0;
 
 	if (!isInit)
@@ -27,26 +28,24 @@ InputSystemManager::InputSystemManager() :
 	checkDevices();
 
 	startThread();
-	startTimerHz(1);
 }
 
 InputSystemManager::~InputSystemManager()
 {
 	isBeingDestroyed = true;
-	stopTimer();
+	cancelPendingUpdate();
 	stopThread(1000);
 	SDL_Quit();
 }
 
 void InputSystemManager::checkDevices()
 {
-#if JUCE_MAC
-    SDL_JoystickUpdate();
-#endif
-    
-    int numDevices = SDL_NumJoysticks();
+	int numDevices = SDL_NumJoysticks();
 	for (int i = 0; i < numDevices; ++i)
 	{
+		//opening an opened device again would only add a reference in SDL
+		if (getGamepadForInstanceID(SDL_JoystickGetDeviceInstanceID(i)) != nullptr) continue;
+
 		if (SDL_IsGameController(i))
 		{
 			SDL_GameController* g = SDL_GameControllerOpen(i);
@@ -55,8 +54,7 @@ void InputSystemManager::checkDevices()
 				LOG("Unable to open gamepad : " << SDL_GetError());
 				continue;
 			}
-			Gamepad* gp = getGamepadForSDL(g);
-			if (gp == nullptr) addGamepad(new Gamepad(g));
+			addGamepad(new Gamepad(g));
 		}
 		else
 		{
@@ -66,8 +64,7 @@ void InputSystemManager::checkDevices()
 				LOG("Unable to open joystick : " << SDL_GetError());
 				continue;
 			}
-			Gamepad* jj = getGamepadForSDL(j);
-			if (jj == nullptr) addGamepad(new Gamepad(j));
+			addGamepad(new Gamepad(j));
 		}
 	}
 
@@ -87,9 +84,30 @@ void InputSystemManager::checkDevices()
 	for (auto& g : gamepadsToRemove) removeGamepad(g);
 }
 
+void InputSystemManager::requestUpdateRate(void* requester, int rate)
+{
+	GenericScopedLock lock(rateLock);
+	if (rate > 0) requestedRates.set(requester, rate);
+	else requestedRates.remove(requester);
+
+	int maxRate = 50;
+	if (requestedRates.size() > 0)
+	{
+		maxRate = 1;
+		for (HashMap<void*, int>::Iterator it(requestedRates); it.next();) maxRate = jmax(maxRate, it.getValue());
+	}
+
+	updateInterval = jmax(1, 1000 / jmin(maxRate, 1000));
+}
+
 Gamepad* InputSystemManager::addGamepad(Gamepad * g)
 {
-	gamepads.add(g);
+	{
+		GenericScopedLock lock(gamepads.getLock());
+		gamepads.add(g);
+		gamepadMap.set(g->getDevID(), g);
+	}
+
 	LOG("Gamepad added : " << g->getName());
 	inputListeners.call(&InputManagerListener::gamepadAdded, g);
 	inputQueuedNotifier.addMessage(new InputSystemEvent(InputSystemEvent::GAMEPAD_ADDED, g));
@@ -98,14 +116,19 @@ Gamepad* InputSystemManager::addGamepad(Gamepad * g)
 
 void InputSystemManager::removeGamepad(Gamepad* g)
 {
-	if (!gamepads.contains(g)) return;
-	gamepads.removeObject(g, false);
+	{
+		GenericScopedLock lock(gamepads.getLock());
+		if (!gamepads.contains(g)) return;
+		gamepads.removeObject(g, false);
+		gamepadMap.remove(g->getDevID());
+	}
 	
 	LOG("Gamepad removed : " << g->getName());
 	
 	inputListeners.call(&InputManagerListener::gamepadRemoved, g);
 	inputQueuedNotifier.addMessage(new InputSystemEvent(InputSystemEvent::GAMEPAD_REMOVED, g));
-	SDL_GameControllerClose(g->gamepad);
+	if (g->joystick != nullptr) SDL_JoystickClose(g->joystick);
+	else SDL_GameControllerClose(g->gamepad);
 	delete g;
 
 }
@@ -113,13 +136,21 @@ void InputSystemManager::removeGamepad(Gamepad* g)
 
 Gamepad* InputSystemManager::getGamepadForSDL(SDL_Joystick* tj)
 {
-	for (auto& g : gamepads) if (g->joystick != nullptr && g->joystick == tj) return g;
-	return nullptr;
+	Gamepad* g = getGamepadForInstanceID(SDL_JoystickInstanceID(tj));
+	return g != nullptr && g->joystick == tj ? g : nullptr;
 }
+
 Gamepad* InputSystemManager::getGamepadForSDL(SDL_GameController* tg)
 {
-	for (auto& g : gamepads) if (g->gamepad == tg) return g;
-	return nullptr;
+	Gamepad* g = getGamepadForInstanceID(SDL_JoystickInstanceID(SDL_GameControllerGetJoystick(tg)));
+	return g != nullptr && g->gamepad == tg ? g : nullptr;
+}
+
+Gamepad* InputSystemManager::getGamepadForInstanceID(SDL_JoystickID id)
+{
+	if (id < 0) return nullptr;
+	GenericScopedLock lock(gamepads.getLock());
+	return gamepadMap[id];
 }
 
 Gamepad* InputSystemManager::getGamepadForID(SDL_JoystickGUID id)
@@ -140,51 +171,91 @@ Gamepad* InputSystemManager::getGamepadForName(String name)
 	return nullptr;
 }
 
+void InputSystemManager::handleEvent(const SDL_Event& e)
+{
+	//called with the gamepads lock held, the gamepads found here stay valid until they're updated
+	switch (e.type)
+	{
+	case SDL_JOYDEVICEADDED:
+	case SDL_JOYDEVICEREMOVED:
+		triggerAsyncUpdate(); //devices are opened and closed from the message thread
+		break;
+
+	//game controllers also send joystick events with the raw indices, only the mapped ones are used for them
+	case SDL_CONTROLLERAXISMOTION:
+		if (Gamepad* g = getGamepadForInstanceID(e.caxis.which)) if (g->gamepad != nullptr) g->setAxis(e.caxis.axis, e.caxis.value);
+		break;
+
+	case SDL_CONTROLLERBUTTONDOWN:
+	case SDL_CONTROLLERBUTTONUP:
+		if (Gamepad* g = getGamepadForInstanceID(e.cbutton.which)) if (g->gamepad != nullptr) g->setButton(e.cbutton.button, e.cbutton.state == SDL_PRESSED);
+		break;
+
+	case SDL_JOYAXISMOTION:
+		if (Gamepad* g = getGamepadForInstanceID(e.jaxis.which)) if (g->joystick != nullptr) g->setAxis(e.jaxis.axis, e.jaxis.value);
+		break;
+
+	case SDL_JOYBUTTONDOWN:
+	case SDL_JOYBUTTONUP:
+		if (Gamepad* g = getGamepadForInstanceID(e.jbutton.which)) if (g->joystick != nullptr) g->setButton(e.jbutton.button, e.jbutton.state == SDL_PRESSED);
+		break;
+
+	default:
+		break;
+	}
+}
 
 void InputSystemManager::run()
 {
+	uint32 nextDispatchTime = Time::getMillisecondCounter();
+
 	while (!threadShouldExit())
 	{
-		wait(20); //50fps
-
-		if (Engine::mainEngine->isClearing || Engine::mainEngine->isLoadingFile) continue;
-        
-       // MessageManager::getInstance()->callFunctionOnMessageThread([](void *)->void*{SDL_Event e; SDL_PollEvent(&e); return nullptr;}, nullptr);
-        
-        int numDevices = SDL_NumJoysticks();
-        if(numDevices != gamepads.size())
-        {
-            DBG("Gamepad num change !");
-            continue;
-        }
-        SDL_JoystickUpdate();
-		SDL_GameControllerUpdate();
-
-		gamepads.getLock().enter();
-		for (auto& g : gamepads)
+		uint32 now = Time::getMillisecondCounter();
+		int remaining = (int)(nextDispatchTime - now);
+		if (remaining > 0)
 		{
-			if (g != nullptr) g->update();
+			wait(remaining);
+			continue;
 		}
-		gamepads.getLock().exit();
+
+		nextDispatchTime = now + updateInterval;
+
+		//events are polled at the update rate and coalesced in the gamepads. SDL_WaitEventTimeout is not used,
+		//older SDL versions implement it with 10ms sleeps, which would cap the rate at 100Hz.
+		//The lock is held while handling events so a gamepad can't be removed between its lookup and its update
+		GenericScopedLock lock(gamepads.getLock());
+
+		SDL_Event e;
+		while (SDL_PollEvent(&e)) handleEvent(e);
+
+		if (Engine::mainEngine->isClearing || Engine::mainEngine->isLoadingFile) continue;
+
+		for (auto& g : gamepads) g->dispatchChanges();
 	}
 }
 
-void InputSystemManager::timerCallback()
+void InputSystemManager::handleAsyncUpdate()
 {
-    checkDevices();
+	checkDevices();
 }
 
 Gamepad::Gamepad(SDL_GameController* gamepad) :
 	gamepad(gamepad),
-	joystick(nullptr)
+	joystick(nullptr),
+	devID(SDL_JoystickInstanceID(SDL_GameControllerGetJoystick(gamepad))),
+	forceFullUpdate(true)
 {
-
+	readState();
 }
 
 Gamepad::Gamepad(SDL_Joystick* joystick) :
 	gamepad(nullptr),
-	joystick(joystick)
+	joystick(joystick),
+	devID(SDL_JoystickInstanceID(joystick)),
+	forceFullUpdate(true)
 {
+	readState();
 }
 
 Gamepad::~Gamepad()
@@ -192,32 +263,54 @@ Gamepad::~Gamepad()
 	masterReference.clear();
 }
 
-void Gamepad::update()
+void Gamepad::readState()
 {
 	int numAxes = joystick != nullptr ? SDL_JoystickNumAxes(joystick) : SDL_CONTROLLER_AXIS_MAX;
 	int numButtons = joystick != nullptr ? SDL_JoystickNumButtons(joystick) : SDL_CONTROLLER_BUTTON_MAX;
 
-	Array<float> axes;
-	Array<bool> buttons;
+	axes.clear();
+	buttons.clear();
+
+	for (int i = 0; i < numAxes; ++i) axes.add(joystick != nullptr ? SDL_JoystickGetAxis(joystick, i) : SDL_GameControllerGetAxis(gamepad, (SDL_GameControllerAxis)i));
+	for (int i = 0; i < numButtons; ++i) buttons.add(joystick != nullptr ? (SDL_JoystickGetButton(joystick, i) > 0) : (SDL_GameControllerGetButton(gamepad, (SDL_GameControllerButton)i) > 0));
+}
+
+void Gamepad::setAxis(int index, int value)
+{
+	if (index < 0 || index >= axes.size() || axes[index] == value) return;
+	axes.set(index, value);
+	changedAxes.setBit(index);
+}
+
+void Gamepad::setButton(int index, bool value)
+{
+	if (index < 0 || index >= buttons.size() || buttons[index] == value) return;
+	buttons.set(index, value);
+	changedButtons.setBit(index);
+}
 
-	for (int i = 0; i < numAxes; ++i)
+void Gamepad::dispatchChanges()
+{
+	if (forceFullUpdate.exchange(false))
 	{
-		float val = joystick != nullptr ? (float)SDL_JoystickGetAxis(joystick, i) : (float)SDL_GameControllerGetAxis(gamepad, (SDL_GameControllerAxis)i);
-		axes.add(val);
+		changedAxes.setRange(0, axes.size(), true);
+		changedButtons.setRange(0, buttons.size(), true);
 	}
 
-	for (int i = 0; i < numButtons; ++i)
+	if (changedAxes.isZero() && changedButtons.isZero()) return;
+
+	for (int i = changedAxes.findNextSetBit(0); i >= 0; i = changedAxes.findNextSetBit(i + 1))
 	{
-		bool val = joystick != nullptr ? (SDL_JoystickGetButton(joystick, i) > 0) : (SDL_GameControllerGetButton(gamepad, (SDL_GameControllerButton)i) > 0);
-		buttons.add(val);
+		gamepadListeners.call(&GamepadListener::gamepadAxisChanged, this, i, getNormalizedAxis(axes[i]));
 	}
 
-	gamepadListeners.call(&GamepadListener::gamepadValuesUpdated, axes, buttons);
-}
+	for (int i = changedButtons.findNextSetBit(0); i >= 0; i = changedButtons.findNextSetBit(i + 1))
+	{
+		gamepadListeners.call(&GamepadListener::gamepadButtonChanged, this, i, (bool)buttons[i]);
+	}
 
-SDL_JoystickID Gamepad::getDevID()
-{
-	return joystick != nullptr ? SDL_JoystickInstanceID(joystick) : SDL_JoystickInstanceID(SDL_GameControllerGetJoystick(gamepad));
+	changedAxes.clear();
+	changedButtons.clear();
 }
 
 String Gamepad::getName()
@@ -27,26 +27,36 @@ public:
 
 	SDL_GameController* gamepad;
 	SDL_Joystick* joystick;
+	SDL_JoystickID devID;
 
-	//ControllableContainer axesCC;
-	//ControllableContainer buttonsCC;
+	//Last known state, written by the input thread from SDL events
+	Array<int> axes;
+	Array<bool> buttons;
+	BigInteger changedAxes;
+	BigInteger changedButtons;
+	std::atomic<bool> forceFullUpdate;
 
-	//float axisOffset[SDL_JOYSTICK_AXIS_MAX];
-	//float axisDeadZone[SDL_JOYSTICK_AXIS_MAX];
+	void readState();
+	void setAxis(int index, int value);
+	void setButton(int index, bool value);
+	void dispatchChanges();
+	void sendAllValues() { forceFullUpdate = true; }
 
-	virtual void update();
-	SDL_JoystickID getDevID();
+	SDL_JoystickID getDevID() const { return devID; }
 
 	String getName();
 
 	static String getAxisName(int index);
 	static String getButtonName(int index);
+	static float getNormalizedAxis(int rawValue) { return jmap<float>(rawValue, INT16_MIN, INT16_MAX, -1, 1); }
 
+	//Only called for the axes and buttons that changed since the last dispatch
 	class GamepadListener
 	{
 	public:
 		virtual ~GamepadListener() {}
-		virtual void gamepadValuesUpdated(Array<float> axes, Array<bool> buttons) {}
+		virtual void gamepadAxisChanged(Gamepad* g, int index, float value) {}
+		virtual void gamepadButtonChanged(Gamepad* g, int index, bool value) {}
 	};
 
 	ListenerList<GamepadListener> gamepadListeners;
@@ -84,7 +94,7 @@ public:
 
 class InputSystemManager :
 	public Thread,
-	public Timer
+	public AsyncUpdater
 {
 public:
 	juce_DeclareSingleton(InputSystemManager, true);
@@ -97,8 +107,14 @@ public:
 
 	//OwnedArray<Joystick, CriticalSection> joysticks;
 	OwnedArray<Gamepad, CriticalSection> gamepads;
+	HashMap<SDL_JoystickID, Gamepad*> gamepadMap; //by instance id, guarded by the gamepads lock
+
+	CriticalSection rateLock;
+	HashMap<void*, int> requestedRates;
+	std::atomic<int> updateInterval; //ms between two dispatches of the changes
 
 	void checkDevices();
+	void requestUpdateRate(void* requester, int rate); //the highest requested rate is used, 0 removes the request
 
 	Gamepad* addGamepad(Gamepad* controller);
 	void removeGamepad(Gamepad* g);
@@ -107,12 +123,14 @@ public:
 
 	Gamepad* getGamepadForSDL(SDL_GameController* g);
 	Gamepad* getGamepadForSDL(SDL_Joystick* j);
+	Gamepad* getGamepadForInstanceID(SDL_JoystickID id);
 	Gamepad* getGamepadForID(SDL_JoystickGUID id);
 	Gamepad* getGamepadForName(String name);
 
+	void handleEvent(const SDL_Event& e);
 
 	void run() override;
-	void timerCallback() override;
+	void handleAsyncUpdate() override;
 
 	class InputManagerListener
 	{
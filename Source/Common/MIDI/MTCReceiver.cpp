@@ -11,8 +11,13 @@
 MTCReceiver::MTCReceiver(MIDIInputDevice* device) :
 	isPlaying(false),
 	hours(0), minutes(0), seconds(0), frames(0), type(MidiMessage::SmpteTimecodeType::fps30),
+	divider(30),
+	baseTime(0),
+	quarterFramesSinceBase(0),
 	device(nullptr)
 {
+	for (int i = 0; i < 8; i++) pieces[i] = 0;
+
 	MIDIManager::getInstance()->addMIDIManagerListener(this);
 	setDevice(device);
 }
@@ -43,48 +48,67 @@ void MTCReceiver::setDevice(MIDIInputDevice* newDevice)
 
 double MTCReceiver::getTime()
 {
-	return (double)(hours * 3600 + minutes * 60 + seconds) + (frames * 1.0 / divider);
+	return baseTime + quarterFramesSinceBase / (4 * divider);
 }
 
-void MTCReceiver::fullFrameTimecodeReceived(const MidiMessage& m)
+double MTCReceiver::getChasedTime()
+{
+	return chaser.getSourceTimeAt(TimecodeChaser::getHostTime());
+}
+
+void MTCReceiver::setType(MidiMessage::SmpteTimecodeType newType)
 {
-	m.getFullFrameParameters(hours, minutes, seconds, frames, type);
+	type = newType;
 	switch (type)
 	{
-	case MidiMessage::fps24: divider = 24;
-	case MidiMessage::fps25: divider = 25;
-	case MidiMessage::fps30: divider = 30;
-	case MidiMessage::fps30drop: divider = 29.997;
+	case MidiMessage::fps24: divider = 24; break;
+	case MidiMessage::fps25: divider = 25; break;
+	case MidiMessage::fps30: divider = 30; break;
+	case MidiMessage::fps30drop: divider = 30000.0 / 1001.0; break;
 	}
 
+	chaser.setFrameRate(divider);
+}
+
+void MTCReceiver::fullFrameTimecodeReceived(const MidiMessage& m)
+{
+	MidiMessage::SmpteTimecodeType newType;
+	m.getFullFrameParameters(hours, minutes, seconds, frames, newType);
+	if (newType != type) setType(newType);
+
+	//full frame is a locate message, the chaser has to relock on it
+	baseTime = TimecodeChaser::getTimeForTimecode(hours, minutes, seconds, frames, divider, type == MidiMessage::fps30drop);
+	quarterFramesSinceBase = 0;
+	chaser.reset();
+	chaser.pushSourceTime(baseTime, TimecodeChaser::getHostTime());
+
 	mtcListeners.call(&MTCListener::mtcTimeUpdated, true);
 
 }
 
 void MTCReceiver::quarterFrameTimecodeReceived(const MidiMessage& m)
 {
+	double hostTime = TimecodeChaser::getHostTime();
+
 	int piece = m.getQuarterFrameSequenceNumber();
 	pieces[piece] = m.getQuarterFrameValue();
 
+	//each quarter frame moves the time forward by a quarter of a frame, no need to wait for the complete sequence
+	quarterFramesSinceBase++;
+
 	if ((Piece)piece == Piece::RateAndHourMSB)
 	{
 		frames = (pieces[(int)Piece::FrameLSB] & 0x0F) | ((pieces[(int)Piece::FrameMSB] & 0x01) << 4);
 		seconds = (pieces[(int)Piece::SecondLSB] & 0x0F) | ((pieces[(int)Piece::SecondMSB] & 0x03) << 4);
 		minutes = (pieces[(int)Piece::MinuteLSB] & 0x0F) | ((pieces[(int)Piece::MinuteMSB] & 0x03) << 4);
 		hours = (pieces[(int)Piece::HourLSB] & 0x0F) | ((pieces[(int)Piece::RateAndHourMSB] & 0x01) << 4);
-		MidiMessage::SmpteTimecodeType newType = (MidiMessage::SmpteTimecodeType)(pieces[(int)Piece::RateAndHourMSB] & 0x03);
+		MidiMessage::SmpteTimecodeType newType = (MidiMessage::SmpteTimecodeType)((pieces[(int)Piece::RateAndHourMSB] >> 1) & 0x03);
 
-		if (type != newType)
-		{
-			type = newType;
-			switch (type)
-			{
-			case MidiMessage::fps24: divider = 24;
-			case MidiMessage::fps25: divider = 25;
-			case MidiMessage::fps30: divider = 30;
-			case MidiMessage::fps30drop: divider = 29.997;
-			}
-		}
+		if (type != newType) setType(newType);
+
+		//the decoded time is the one of the first piece, sent 7 quarter frames ago
+		baseTime = TimecodeChaser::getTimeForTimecode(hours, minutes, seconds, frames, divider, type == MidiMessage::fps30drop);
+		quarterFramesSinceBase = 7;
 
 		if (!isPlaying)
 		{
@@ -95,6 +119,8 @@ void MTCReceiver::quarterFrameTimecodeReceived(const MidiMessage& m)
 		startTimerHz(divider /  5);
 	}
 
+	if (isPlaying) chaser.pushSourceTime(getTime(), hostTime);
+
 	mtcListeners.call(&MTCListener::mtcTimeUpdated, false);
 }
 
@@ -106,6 +132,7 @@ void MTCReceiver::midiDeviceInRemoved(MIDIInputDevice* d)
 void MTCReceiver::timerCallback()
 {
 	isPlaying = false;
+	chaser.reset();
 	mtcListeners.call(&MTCListener::mtcStopped);
 	stopTimer();
 }
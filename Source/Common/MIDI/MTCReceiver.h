@@ -28,6 +28,11 @@ public:
 	MidiMessage::SmpteTimecodeType type;
 	double divider;
 
+	double baseTime; //time of the last complete quarter frame sequence, at the moment its first piece was sent
+	int quarterFramesSinceBase;
+
+	TimecodeChaser chaser;
+
 	enum class Piece {
 		FrameLSB = 0,
 		FrameMSB,
@@ -44,7 +49,10 @@ public:
 
 	void setDevice(MIDIInputDevice* newDevice);
 
-	double getTime();
+	double getTime(); //last decoded time, including quarter frames
+	double getChasedTime(); //filtered and extrapolated time, for followers
+
+	void setType(MidiMessage::SmpteTimecodeType newType);
 
 	void fullFrameTimecodeReceived(const MidiMessage &m) override;
 	void quarterFrameTimecodeReceived(const MidiMessage &m) override;
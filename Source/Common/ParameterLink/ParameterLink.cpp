@@ -239,10 +239,16 @@ void ParameterLink::setLinkedPresetParam(CVPresetMultiplexList* _list, const Str
 	}
 }
 
-void ParameterLink::updateMappingInputValue(var value, int multiplexIndex)
+void ParameterLink::updateMappingInputValue(var value, int multiplexIndex, const BigInteger* changedComponents)
 {
 	if (linkType != MAPPING_INPUT && !replacementHasMappingInputToken) return;
 
+	if (changedComponents != nullptr && isMappingInputUpToDate(value, multiplexIndex, *changedComponents))
+	{
+		mappingValues.set(multiplexIndex, value);
+		return;
+	}
+
 	var linkedInputValue = getInputMappingValue(value);
 	mappingValues.set(multiplexIndex, value);
 
@@ -253,12 +259,40 @@ void ParameterLink::updateMappingInputValue(var value, int multiplexIndex)
 	paramLinkNotifier.addMessage(new ParameterLinkEvent(ParameterLinkEvent::INPUT_VALUE_UPDATED, this)); //only for preview
 }
 
+bool ParameterLink::isMappingInputUpToDate(const var& value, int multiplexIndex, const BigInteger& changedComponents)
+{
+	//replacement strings can use any component, only direct links can be skipped
+	if (linkType != MAPPING_INPUT || replacementHasMappingInputToken) return false;
+	if (parameter == nullptr || parameter.wasObjectDeleted()) return false;
+	if (!value.isArray() || multiplexIndex >= mappingValues.size()) return false;
+
+	int numComponents = parameter->value.isArray() ? parameter->value.size() : 1;
+	int firstChanged = changedComponents.findNextSetBit(mappingValueIndex);
+	if (firstChanged >= 0 && firstChanged < mappingValueIndex + numComponents) return false;
+
+	//the mask only tells what changed since the last update, make sure this link actually received it
+	const var& prevValue = mappingValues.getReference(multiplexIndex);
+	if (!prevValue.isArray() || prevValue.size() != value.size()) return false;
+	for (int i = mappingValueIndex; i < mappingValueIndex + numComponents && i < value.size(); i++)
+	{
+		if (prevValue[i] != value[i]) return false;
+	}
+
+	return true;
+}
+
 void ParameterLink::listItemUpdated(int multiplexIndex)
 {
 	parameterLinkListeners.call(&ParameterLinkListener::listItemUpdated, this, multiplexIndex);
 	paramLinkNotifier.addMessage(new ParameterLinkEvent(ParameterLinkEvent::LIST_ITEM_UPDATED, this)); //only for preview
 }
 
+void ParameterLink::listItemsUpdated(const Array<int>& multiplexIndices)
+{
+	parameterLinkListeners.call(&ParameterLinkListener::listItemsUpdated, this, multiplexIndices);
+	paramLinkNotifier.addMessage(new ParameterLinkEvent(ParameterLinkEvent::LIST_ITEM_UPDATED, this)); //only for preview
+}
+
 String ParameterLink::getReplacementString(int multiplexIndex)
 {
 	replacementHasMappingInputToken = false;
@@ -589,6 +623,11 @@ void ParamLinkContainer::listItemUpdated(ParameterLink* p, int multiplexIndex)
 	paramLinkContainerListeners.call(&ParamLinkContainerListener::listItemUpdated, this, p, multiplexIndex);
 }
 
+void ParamLinkContainer::listItemsUpdated(ParameterLink* p, const Array<int>& multiplexIndices)
+{
+	paramLinkContainerListeners.call(&ParamLinkContainerListener::listItemsUpdated, this, p, multiplexIndices);
+}
+
 
 void ParamLinkContainer::linkParamToMappingIndex(Parameter* p, int mappingIndex)
 {
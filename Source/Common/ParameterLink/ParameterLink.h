@@ -52,6 +52,7 @@ public:
     void multiplexPreviewIndexChanged() override;
 
     void listItemUpdated(int multiplexIndex) override;
+    void listItemsUpdated(const Array<int>& multiplexIndices) override;
 
     void setLinkType(LinkType type);
 
@@ -64,7 +65,8 @@ public:
     WeakReference<Controllable> getLinkedTarget(int multiplexIndex);
     WeakReference<ControllableContainer> getLinkedTargetContainer(int multiplexIndex);
 
-    void updateMappingInputValue(var value, int multiplexIndex);
+    void updateMappingInputValue(var value, int multiplexIndex, const BigInteger* changedComponents = nullptr);
+    bool isMappingInputUpToDate(const var& value, int multiplexIndex, const BigInteger& changedComponents);
 
     void setInputNamesFromParams(Array<Parameter*> params);
     
@@ -86,6 +88,7 @@ public:
         virtual ~ParameterLinkListener() {}
         virtual void linkUpdated(ParameterLink* pLink) {}
         virtual void listItemUpdated(ParameterLink * pLink, int multiplexIndex) {}
+        virtual void listItemsUpdated(ParameterLink* pLink, const Array<int>& multiplexIndices) { for (auto& i : multiplexIndices) listItemUpdated(pLink, i); }
     };
 
     ListenerList<ParameterLinkListener, Array<ParameterLinkListener*, CriticalSection>> parameterLinkListeners;
@@ -126,6 +129,7 @@ public:
 
     virtual void linkUpdated(ParameterLink* p) override;
     virtual void listItemUpdated(ParameterLink* p, int multiplexIndex) override;
+    virtual void listItemsUpdated(ParameterLink* p, const Array<int>& multiplexIndices) override;
 
 
     template<class T>
@@ -168,6 +172,7 @@ public:
         virtual ~ParamLinkContainerListener() {}
         virtual void linkUpdated(ParamLinkContainer* container, ParameterLink* pLink) {}
         virtual void listItemUpdated(ParamLinkContainer * container, ParameterLink* pLink, int multiplexIndex) {}
+        virtual void listItemsUpdated(ParamLinkContainer* container, ParameterLink* pLink, const Array<int>& multiplexIndices) { for (auto& i : multiplexIndices) listItemUpdated(container, pLink, i); }
     };
 
 
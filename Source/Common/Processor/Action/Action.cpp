@@ -161,6 +161,20 @@ void Action::triggerConsequences(bool triggerTrue, int multiplexIndex)
 	}
 }
 
+void Action::triggerConsequencesMultiplexRange(bool triggerTrue, int startIndex, int endIndex)
+{
+	if (!enabled->boolValue() || forceDisabled) return;
+	if (isClearing) return;
+
+	if (!forceChecking)
+	{
+		if (triggerTrue) csmOn->triggerAllMultiplexRange(startIndex, endIndex);
+		else csmOff->triggerAllMultiplexRange(startIndex, endIndex);
+
+		for (int i = startIndex; i < endIndex; i++) notifyActionTriggered(triggerTrue, i);
+	}
+}
+
 var Action::getJSONData(bool includeNonOverriden)
 {
 	var data = Processor::getJSONData(includeNonOverriden);
@@ -194,7 +208,7 @@ void Action::onContainerTriggerTriggered(Trigger* t)
 	{
 		if (enabled->boolValue())
 		{
-			for (int i = 0; i < getMultiplexCount(); i++) triggerConsequences(t == triggerOn, i);
+			triggerConsequencesMultiplexRange(t == triggerOn, 0, getMultiplexCount());
 		}
 	}
 	else if (t == triggerPreview)
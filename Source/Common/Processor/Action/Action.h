@@ -49,6 +49,7 @@ public:
 	void forceCheck(bool triggerIfChanged);
 
 	virtual void triggerConsequences(bool triggerTrue, int multiplexIndex = 0);
+	virtual void triggerConsequencesMultiplexRange(bool triggerTrue, int startIndex, int endIndex);
 
 	void multiplexPreviewIndexChanged() override;
 
@@ -16,6 +16,8 @@ Condition::Condition(const String& n, var params, Multiplex* multiplex) :
 	BaseItem(n),
 	MultiplexTarget(multiplex),
 	forceDisabled(false),
+	countedEnabled(false),
+	isChangingEnabled(false),
 	conditionAsyncNotifier(30)
 {
 	isSelectable = false;
@@ -58,7 +60,9 @@ void Condition::onContainerParameterChangedInternal(Parameter* p)
 	BaseItem::onContainerParameterChangedInternal(p);
 	if (p == enabled)
 	{
+		isChangingEnabled = true;
 		for (int i = 0; i < getMultiplexCount(); i++) setValid(i, false);
+		isChangingEnabled = false;
 	}
 }
 
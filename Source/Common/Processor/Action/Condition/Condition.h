@@ -20,6 +20,9 @@ public:
 
 	bool forceDisabled;
 	Array<bool> isValids; //this could be simplified for non-iterative condition
+	Array<bool> countedValids; //state last accounted for in the parent ConditionManager's valid counters
+	bool countedEnabled; //enabled state last accounted for in the parent ConditionManager's enabled counter
+	bool isChangingEnabled; //invalidating itself after an enable change, the manager rechecks once afterwards
 
 	virtual void multiplexCountChanged() override;
 	virtual void multiplexPreviewIndexChanged() override;
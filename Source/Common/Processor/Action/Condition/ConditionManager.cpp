@@ -15,6 +15,8 @@ ConditionManager::ConditionManager(Multiplex* multiplex) :
 	BaseManager<Condition>("Conditions"),
 	activateDef(nullptr),
 	deactivateDef(nullptr),
+	numEnabledConditions(0),
+	validCountsDirty(false),
 	forceDisabled(false),
 	useValidationProgress(false),
 	isCheckingOtherConditionsWithSameSource(false),
@@ -26,10 +28,13 @@ ConditionManager::ConditionManager(Multiplex* multiplex) :
 	isValids.resize(getMultiplexCount());
 	validationProgresses.resize(getMultiplexCount());
 	validationTargets.resize(getMultiplexCount());
+	prevTimerTimes.resize(getMultiplexCount());
+	numValidConditions.resize(getMultiplexCount());
 
 	isValids.fill(false);
 	validationProgresses.fill(0);
 	validationTargets.fill(false);
+	numValidConditions.fill(0);
 
 	sequentialConditionIndices.resize(getMultiplexCount());
 
@@ -67,19 +72,31 @@ SEQUENTIAL will check the first, and when it gets validated, will check the next
 
 ConditionManager::~ConditionManager()
 {
+	stopTimer();
 }
 
 void ConditionManager::multiplexCountChanged()
 {
+	{
+		GenericScopedLock lock(validationLock);
+		pendingValidations.clear();
+		stopTimer();
+	}
+
 	isValids.resize(getMultiplexCount());
 	validationProgresses.resize(getMultiplexCount());
 	validationTargets.resize(getMultiplexCount());
+	prevTimerTimes.resize(getMultiplexCount());
 	sequentialConditionIndices.resize(getMultiplexCount());
 
 	isValids.fill(false);
 	validationProgresses.fill(0);
 	validationTargets.fill(false);
 	sequentialConditionIndices.fill(0);
+
+	//conditions may not have resized their own states yet, recount on next check
+	GenericScopedLock lock(validCountsLock);
+	validCountsDirty = true;
 }
 
 void ConditionManager::multiplexPreviewIndexChanged()
@@ -129,6 +146,13 @@ void ConditionManager::addItemInternal(Condition* c, var data)
 {
 	c->setForceDisabled(forceDisabled);
 	c->addConditionListener(this);
+
+	c->countedValids.resize(getMultiplexCount());
+	c->countedValids.fill(false);
+	c->countedEnabled = false;
+	updateEnabledCount(c);
+	updateConditionValidCounts(c);
+
 	conditionOperator->hideInEditor = items.size() <= 1;
 	StandardCondition* sc = dynamic_cast<StandardCondition*>(c);
 	if (sc != nullptr)
@@ -143,6 +167,20 @@ void ConditionManager::removeItemInternal(Condition* c)
 	c->removeConditionListener(this);
 	conditionOperator->hideInEditor = items.size() <= 1;
 
+	{
+		GenericScopedLock lock(validCountsLock);
+		if (!validCountsDirty)
+		{
+			for (int i = 0; i < c->countedValids.size() && i < numValidConditions.size(); i++)
+			{
+				if (c->countedValids[i]) numValidConditions.set(i, numValidConditions[i] - 1);
+			}
+		}
+		c->countedValids.fill(false);
+		if (c->countedEnabled) numEnabledConditions--;
+		c->countedEnabled = false;
+	}
+
 	sequentialConditionIndices.fill(0);
 	conditionManagerAsyncNotifier.addMessage(new ConditionManagerEvent(ConditionManagerEvent::SEQUENTIAL_CONDITION_INDEX_CHANGED, this));
 
@@ -252,12 +290,11 @@ void ConditionManager::checkAllConditions(int multiplexIndex, bool emptyIsValid,
 			setValidationProgress(multiplexIndex, valid ? 0 : 1);
 			validationTargets.set(multiplexIndex, valid);
 			
-			prevTimerTimes.set(multiplexIndex, Time::getMillisecondCounterHiRes() / 1000.0);
-			startTimer(multiplexIndex, 20);
+			startValidation(multiplexIndex);
 		}
 		else
 		{
-			stopTimer(multiplexIndex);
+			stopValidation(multiplexIndex);
 			setValidationProgress(multiplexIndex, valid);
 			validationTargets.set(multiplexIndex, valid);
 		}
@@ -279,6 +316,12 @@ void ConditionManager::checkAllConditions(int multiplexIndex, bool emptyIsValid,
 
 void ConditionManager::conditionValidationChanged(Condition* c, int multiplexIndex, bool dispatchOnChangeOnly)
 {
+	//counters must follow every transition, even those coming from the same source sync check
+	updateEnabledCount(c);
+	updateConditionValidCount(c, multiplexIndex);
+
+	//the enable change is followed by one recheck of all indices from the feedback
+	if (c->isChangingEnabled) return;
 	if (isCheckingOtherConditionsWithSameSource) return;
 
 	if (StandardCondition* sc = dynamic_cast<StandardCondition*>(c))
@@ -316,19 +359,60 @@ void ConditionManager::onContainerParameterChanged(Parameter* p)
 	}
 }
 
-void ConditionManager::timerCallback(int id)
+void ConditionManager::onControllableFeedbackUpdateInternal(ControllableContainer* cc, Controllable* c)
+{
+	BaseManager::onControllableFeedbackUpdateInternal(cc, c);
+
+	Condition* cond = dynamic_cast<Condition*>(c->parentContainer.get());
+	if (cond == nullptr || c != cond->enabled || !items.contains(cond)) return;
+
+	updateEnabledCount(cond);
+	updateConditionValidCounts(cond);
+
+	if (!Engine::mainEngine->isLoadingFile && !Engine::mainEngine->isClearing)
+	{
+		for (int i = 0; i < getMultiplexCount(); i++) checkAllConditions(i);
+	}
+}
+
+void ConditionManager::startValidation(int multiplexIndex)
+{
+	GenericScopedLock lock(validationLock);
+	prevTimerTimes.set(multiplexIndex, Time::getMillisecondCounterHiRes() / 1000.0);
+	pendingValidations.add(multiplexIndex);
+	if (!isTimerRunning()) startTimer(20);
+}
+
+void ConditionManager::stopValidation(int multiplexIndex)
+{
+	GenericScopedLock lock(validationLock);
+	pendingValidations.removeValue(multiplexIndex);
+	if (pendingValidations.isEmpty()) stopTimer();
+}
+
+void ConditionManager::timerCallback()
+{
+	Array<int> indices;
+	{
+		GenericScopedLock lock(validationLock);
+		for (int i = 0; i < pendingValidations.size(); i++) indices.add(pendingValidations[i]);
+	}
+
+	double curTime = Time::getMillisecondCounterHiRes() / 1000.0;
+	for (auto& id : indices) advanceValidation(id, curTime);
+}
+
+void ConditionManager::advanceValidation(int id, double curTime)
 {
 	if (!useValidationProgress)
 	{
 		setValid(id, validationTargets[id]);
-		stopTimer(id);
+		stopValidation(id);
 		return;
 	}
 
 	bool targetIsValid = validationTargets[id];
 
-
-	double curTime = Time::getMillisecondCounterHiRes() / 1000.0;
 	float diffProgress = (curTime - prevTimerTimes[id]) / (targetIsValid ? validationTime->floatValue() : invalidationTime->floatValue());
 
 	if (!targetIsValid) diffProgress = -diffProgress;
@@ -340,45 +424,30 @@ void ConditionManager::timerCallback(int id)
 	if (validationProgresses[id] == (int)targetIsValid)
 	{
 		setValid(id, validationTargets[id]);
-		stopTimer(id);
+		stopValidation(id);
 	}
 }
 
 void ConditionManager::afterLoadJSONDataInternal()
 {
+	recountValidConditions();
 	for (int i = 0; i < getMultiplexCount(); i++) checkAllConditions(i);
 }
 
 bool ConditionManager::areAllConditionsValid(int multiplexIndex, bool emptyIsValid)
 {
-	if (items.size() == 0) return emptyIsValid;
-
-	int conditionsChecked = 0;
-	for (auto& c : items)
-	{
-		if (!c->enabled->boolValue()) continue;
-		if (!c->getIsValid(multiplexIndex)) return false;
-		conditionsChecked++;
-	}
-
-	if (conditionsChecked == 0) return emptyIsValid;
-	return true;
+	GenericScopedLock lock(validCountsLock);
+	if (validCountsDirty) recountValidConditions();
+	if (numEnabledConditions == 0) return emptyIsValid;
+	return numValidConditions[multiplexIndex] == numEnabledConditions;
 }
 
 bool ConditionManager::isAtLeastOneConditionValid(int multiplexIndex, bool emptyIsValid)
 {
-	if (items.size() == 0) return emptyIsValid;
-
-	int conditionsChecked = 0;
-	for (auto& c : items)
-	{
-		if (!c->enabled->boolValue()) continue;
-		if (c->getIsValid(multiplexIndex)) return true;
-		conditionsChecked++;
-	}
-
-	if (conditionsChecked == 0) return emptyIsValid;
-	return false;
+	GenericScopedLock lock(validCountsLock);
+	if (validCountsDirty) recountValidConditions();
+	if (numEnabledConditions == 0) return emptyIsValid;
+	return numValidConditions[multiplexIndex] > 0;
 }
 
 int ConditionManager::getNumEnabledConditions()
@@ -393,13 +462,66 @@ int ConditionManager::getNumEnabledConditions()
 
 int ConditionManager::getNumValidConditions(int multiplexIndex)
 {
-	int result = 0;
+	GenericScopedLock lock(validCountsLock);
+	if (validCountsDirty) recountValidConditions();
+	return numValidConditions[multiplexIndex];
+}
+
+void ConditionManager::updateEnabledCount(Condition* c)
+{
+	GenericScopedLock lock(validCountsLock);
+	bool isEnabled = c->enabled->boolValue();
+	if (c->countedEnabled == isEnabled) return;
+
+	c->countedEnabled = isEnabled;
+	numEnabledConditions += isEnabled ? 1 : -1;
+}
+
+void ConditionManager::updateConditionValidCount(Condition* c, int multiplexIndex)
+{
+	GenericScopedLock lock(validCountsLock);
+	if (validCountsDirty || multiplexIndex < 0 || multiplexIndex >= numValidConditions.size()) return;
+	if (c->countedValids.size() != numValidConditions.size())
+	{
+		validCountsDirty = true;
+		return;
+	}
+
+	bool counted = c->enabled->boolValue() && c->getIsValid(multiplexIndex);
+	if (c->countedValids[multiplexIndex] == counted) return;
+
+	c->countedValids.set(multiplexIndex, counted);
+	numValidConditions.set(multiplexIndex, numValidConditions[multiplexIndex] + (counted ? 1 : -1));
+}
+
+void ConditionManager::updateConditionValidCounts(Condition* c)
+{
+	for (int i = 0; i < numValidConditions.size(); i++) updateConditionValidCount(c, i);
+}
+
+void ConditionManager::recountValidConditions()
+{
+	GenericScopedLock lock(validCountsLock);
+	int count = getMultiplexCount();
+	numValidConditions.resize(count);
+	numValidConditions.fill(0);
+
+	numEnabledConditions = 0;
 	for (auto& c : items)
 	{
-		if (!c->enabled->boolValue()) continue;
-		if (c->getIsValid(multiplexIndex)) result++;
+		c->countedEnabled = c->enabled->boolValue();
+		if (c->countedEnabled) numEnabledConditions++;
+
+		c->countedValids.resize(count);
+		for (int i = 0; i < count; i++)
+		{
+			bool counted = c->enabled->boolValue() && c->getIsValid(i);
+			c->countedValids.set(i, counted);
+			if (counted) numValidConditions.set(i, numValidConditions[i] + 1);
+		}
 	}
-	return result;
+
+	validCountsDirty = false;
 }
 
 bool ConditionManager::getIsValid(int multiplexIndex, bool emptyIsValid)
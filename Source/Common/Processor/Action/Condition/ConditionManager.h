@@ -14,7 +14,7 @@ class ConditionManager :
 	public MultiplexTarget,
 	public BaseManager<Condition>,
 	public Condition::ConditionListener,
-	public MultiTimer
+	public Timer
 {
 public:
 	ConditionManager(Multiplex* multiplex);
@@ -37,6 +37,17 @@ public:
 	Array<bool> validationTargets;
 	Array<double> prevTimerTimes;
 
+	//Valid counters, updated by each condition transition so AND / OR don't need to walk all conditions.
+	//Conditions change from any thread, the lock covers each transition and the checks reading the counters
+	CriticalSection validCountsLock;
+	Array<int> numValidConditions;
+	int numEnabledConditions;
+	bool validCountsDirty;
+
+	//Multiplex indices waiting for their validation / invalidation time, all advanced by the same timer
+	CriticalSection validationLock;
+	SortedSet<int> pendingValidations;
+
 	bool forceDisabled;
 	bool useValidationProgress;
 
@@ -69,6 +80,15 @@ public:
 	int getNumEnabledConditions();
 	int getNumValidConditions(int multiplexIndex = 0);
 
+	void updateEnabledCount(Condition* c);
+	void updateConditionValidCount(Condition* c, int multiplexIndex);
+	void updateConditionValidCounts(Condition* c);
+	void recountValidConditions();
+
+	void startValidation(int multiplexIndex);
+	void stopValidation(int multiplexIndex);
+	void advanceValidation(int multiplexIndex, double curTime);
+
 	bool getIsValid(int multiplexIndex = 0, bool emptyIsValid = false);
 
 	void dispatchConditionValidationChanged(int multiplexIndex, bool dispatchOnChangeOnly);
@@ -76,8 +96,9 @@ public:
 	void conditionValidationChanged(Condition*, int multiplexIndex, bool dispatchOnChangeOnly) override;
 
 	void onContainerParameterChanged(Parameter*) override;
+	void onControllableFeedbackUpdateInternal(ControllableContainer* cc, Controllable* c) override;
 
-	virtual void timerCallback(int id) override;
+	virtual void timerCallback() override;
 
 	void afterLoadJSONDataInternal() override;
 
@@ -25,4 +25,10 @@ void Consequence::triggerCommand(int multiplexIndex)
 {
 	if (!enabled->boolValue() || forceDisabled) return;
 	BaseCommandHandler::triggerCommand(multiplexIndex);
+}
+
+void Consequence::triggerCommandMultiplexRange(int startIndex, int endIndex)
+{
+	if (!enabled->boolValue() || forceDisabled) return;
+	BaseCommandHandler::triggerCommandMultiplexRange(startIndex, endIndex);
 }
\ No newline at end of file
@@ -22,6 +22,7 @@ public:
 	bool forceDisabled;
 	
 	virtual void triggerCommand(int multiplexIndex = 0) override;
+	virtual void triggerCommandMultiplexRange(int startIndex, int endIndex) override;
 	virtual void triggerCommandInternal(int multiplexIndex = 0) {};
 
 	String getTypeString() const override { return "Consequence"; }
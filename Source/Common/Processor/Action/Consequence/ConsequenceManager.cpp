@@ -72,6 +72,31 @@ void ConsequenceManager::triggerAll(int multiplexIndex)
 	}
 }
 
+void ConsequenceManager::triggerAllMultiplexRange(int startIndex, int endIndex)
+{
+	if (items.size() == 0 || startIndex >= endIndex) return;
+
+	//delays and stagger are handled per index by the launcher.
+	//Batching runs each consequence over the whole range instead of all consequences for each index,
+	//so it is only used when there is a single consequence and that order can't be observed.
+	if (delay->floatValue() != 0 || stagger->floatValue() != 0 || items.size() > 1)
+	{
+		for (int i = startIndex; i < endIndex; i++) triggerAll(i);
+		return;
+	}
+
+	if (killDelaysOnTrigger->boolValue())
+	{
+		for (int i = startIndex; i < endIndex; i++) cancelDelayedConsequences(i);
+	}
+
+	for (auto& bi : items)
+	{
+		if (Consequence* c = dynamic_cast<Consequence*>(bi)) c->triggerCommandMultiplexRange(startIndex, endIndex);
+		else if (ConsequenceGroup* g = dynamic_cast<ConsequenceGroup*>(bi))  if (g->enabled->boolValue()) g->csm.triggerAllMultiplexRange(startIndex, endIndex);
+	}
+}
+
 void ConsequenceManager::cancelDelayedConsequences(int multiplexIndex)
 {
 	if (ConsequenceStaggerLauncher::getInstanceWithoutCreating() != nullptr) ConsequenceStaggerLauncher::getInstance()->removeLaunchesFor(this, multiplexIndex);
@@ -69,6 +69,7 @@ public:
 
 
 	void triggerAll(int multiplexIndex = 0);
+	void triggerAllMultiplexRange(int startIndex, int endIndex);
 	void cancelDelayedConsequences(int multiplexIndex = 0);
 
 	void setForceDisabled(bool value, bool force = false);
@@ -230,6 +230,12 @@ void Conductor::triggerConsequences(bool triggerTrue, int multiplexIndex)
 	else Action::triggerConsequences(triggerTrue, multiplexIndex);
 }
 
+void Conductor::triggerConsequencesMultiplexRange(bool triggerTrue, int startIndex, int endIndex)
+{
+	//cue progression is per trigger, keep the per-index path
+	for (int i = startIndex; i < endIndex; i++) triggerConsequences(triggerTrue, i);
+}
+
 int Conductor::getValidIndexAfter(int index)
 {
 	for (int i = index + 1; i <= processorManager.items.size(); i++)
@@ -63,6 +63,7 @@ public:
 
     void onContainerTriggerTriggered(Trigger* t) override;
     void triggerConsequences(bool triggerTrue, int multiplexIndex = 0) override;
+    void triggerConsequencesMultiplexRange(bool triggerTrue, int startIndex, int endIndex) override;
 
     int getValidIndexAfter(int index = 0);
     int getValidIndexBefore(int index = 0);
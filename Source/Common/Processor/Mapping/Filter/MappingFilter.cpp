@@ -269,6 +269,12 @@ void MappingFilter::listItemUpdated(ParamLinkContainer* c, ParameterLink* pLink,
 	mappingFilterListeners.call(&FilterListener::filterNeedsProcess, this);
 }
 
+void MappingFilter::listItemsUpdated(ParamLinkContainer* c, ParameterLink* pLink, const Array<int>& multiplexIndices)
+{
+	//the whole mapping is processed anyway, so one process for all updated items
+	listItemUpdated(c, pLink, multiplexIndices.isEmpty() ? -1 : multiplexIndices[0]);
+}
+
 void MappingFilter::setExcludedChannels(Array<int> channels)
 {
 	excludedChannels = channels;
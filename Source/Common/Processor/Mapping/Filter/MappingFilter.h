@@ -56,6 +56,7 @@ public:
 
 	void linkUpdated(ParamLinkContainer* c, ParameterLink* pLink) override;
 	void listItemUpdated(ParamLinkContainer* c, ParameterLink* link, int multiplexIndex) override;
+	void listItemsUpdated(ParamLinkContainer* c, ParameterLink* link, const Array<int>& multiplexIndices) override;
 	void setExcludedChannels(Array<int> channels);
 	bool isChannelEligible(int index);
 
@@ -179,6 +179,14 @@ void StandardMappingInput::listItemUpdated(int multiplexIndex)
 	mappingInputAsyncNotifier.addMessage(new MappingInputEvent(MappingInputEvent::PARAMETER_VALUE_CHANGED, this, multiplexIndex));
 }
 
+void StandardMappingInput::listItemsUpdated(const Array<int>& multiplexIndices)
+{
+	mappinginputListeners.call(&StandardMappingInput::Listener::inputParameterValuesChanged, this, multiplexIndices);
+
+	int previewIndex = getPreviewIndex();
+	if (multiplexIndices.contains(previewIndex)) mappingInputAsyncNotifier.addMessage(new MappingInputEvent(MappingInputEvent::PARAMETER_VALUE_CHANGED, this, previewIndex));
+}
+
 
 
 void StandardMappingInput::multiplexPreviewIndexChanged()
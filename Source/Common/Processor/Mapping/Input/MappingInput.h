@@ -36,6 +36,7 @@ public:
 		virtual ~Listener() {}
 		virtual void inputReferenceChanged(MappingInput*, int multiplexIndex) {};
 		virtual void inputParameterValueChanged(MappingInput*, int multiplexIndex) {};
+		virtual void inputParameterValuesChanged(MappingInput* mi, const Array<int>& multiplexIndices) { for (auto& i : multiplexIndices) inputParameterValueChanged(mi, i); };
 		virtual void inputParameterRangeChanged(MappingInput*) {};
 	};
 
@@ -87,6 +88,7 @@ public:
 
 	void listReferenceUpdated(int multiplexIndex) override;
 	void listItemUpdated(int multiplexIndex) override;
+	void listItemsUpdated(const Array<int>& multiplexIndices) override;
 
 	void multiplexPreviewIndexChanged() override;
 
@@ -250,37 +250,32 @@ void Mapping::process(bool sendOutput, int multiplexIndex, bool forceSend)
 		ScopedLock filterLock(fm.filterLock);
 
 		isProcessing = true;
+		processIndexInternal(multiplexIndex, sendOutput, forceSend);
+		isProcessing = false;
+	}
 
-		Array<Parameter*> inputs = im.getInputReferences(multiplexIndex);
-		MappingFilter::ProcessResult filterResult = fm.processFilters(inputs, multiplexIndex);
+	if (shouldRebuildAfterProcess)
+	{
+		shouldRebuildAfterProcess = false;
+		updateMappingChain();
+	}
 
-		if (filterResult == MappingFilter::CHANGED || (filterResult == MappingFilter::UNCHANGED && !sendOnOutputChangeOnly->boolValue()))
-		{
-			Array<Parameter*> filteredParameters = fm.getLastFilteredParameters(multiplexIndex);
+	//DBG("[PROCESS] Exit lock");
 
-			ControllableContainer* outCC = isMultiplexed() ? outValuesCC.controllableContainers[multiplexIndex].get() : &outValuesCC;
-			if (outCC == nullptr)
-			{
-				NLOGWARNING(niceName, "Out CC is null in Mapping::process");
-			}
-			else
-			{
-				for (int i = 0; i < filteredParameters.size(); i++)
-				{
-					if (Parameter* fp = filteredParameters[i])
-					{
-						if (Parameter* p = (Parameter*)outCC->controllables[i])
-						{
-							if (p->type == Parameter::ENUM) ((EnumParameter*)p)->setValueWithKey(((EnumParameter*)fp)->getValueKey());
-							else p->setValue(fp->value);
-						}
-					}
-				}
-			}
+}
 
-			if (sendOutput) om.updateOutputValues(multiplexIndex, sendOnOutputChangeOnly->boolValue() && !forceSend);
-		}
+void Mapping::processIndices(const Array<int>& multiplexIndices, bool sendOutput, bool forceSend)
+{
+	if ((canBeDisabled && !enabled->boolValue()) || forceDisabled) return;
+	if (im.items.size() == 0 || multiplexIndices.isEmpty()) return;
+	if (isCurrentlyLoadingData || isRebuilding || isProcessing || isClearing) return;
 
+	{
+		GenericScopedLock lock(mappingLock);
+		ScopedLock filterLock(fm.filterLock);
+
+		isProcessing = true;
+		for (auto& i : multiplexIndices) processIndexInternal(i, sendOutput, forceSend);
 		isProcessing = false;
 	}
 
@@ -289,9 +284,39 @@ void Mapping::process(bool sendOutput, int multiplexIndex, bool forceSend)
 		shouldRebuildAfterProcess = false;
 		updateMappingChain();
 	}
+}
 
-	//DBG("[PROCESS] Exit lock");
+void Mapping::processIndexInternal(int multiplexIndex, bool sendOutput, bool forceSend)
+{
+	Array<Parameter*> inputs = im.getInputReferences(multiplexIndex);
+	MappingFilter::ProcessResult filterResult = fm.processFilters(inputs, multiplexIndex);
 
+	if (filterResult == MappingFilter::CHANGED || (filterResult == MappingFilter::UNCHANGED && !sendOnOutputChangeOnly->boolValue()))
+	{
+		Array<Parameter*> filteredParameters = fm.getLastFilteredParameters(multiplexIndex);
+
+		ControllableContainer* outCC = isMultiplexed() ? outValuesCC.controllableContainers[multiplexIndex].get() : &outValuesCC;
+		if (outCC == nullptr)
+		{
+			NLOGWARNING(niceName, "Out CC is null in Mapping::process");
+		}
+		else
+		{
+			for (int i = 0; i < filteredParameters.size(); i++)
+			{
+				if (Parameter* fp = filteredParameters[i])
+				{
+					if (Parameter* p = (Parameter*)outCC->controllables[i])
+					{
+						if (p->type == Parameter::ENUM) ((EnumParameter*)p)->setValueWithKey(((EnumParameter*)fp)->getValueKey());
+						else p->setValue(fp->value);
+					}
+				}
+			}
+		}
+
+		if (sendOutput) om.updateOutputValues(multiplexIndex, sendOnOutputChangeOnly->boolValue() && !forceSend);
+	}
 }
 
 void Mapping::updateContinuousProcess()
@@ -418,6 +443,14 @@ void Mapping::inputParameterValueChanged(MappingInput* mi, int multiplexIndex)
 	}
 }
 
+void Mapping::inputParameterValuesChanged(MappingInput* mi, const Array<int>& multiplexIndices)
+{
+	if (!mi->triggersProcess->boolValue()) return;
+	if (processMode != VALUE_CHANGE || isThreadRunning()) return;
+
+	processIndices(multiplexIndices);
+}
+
 void Mapping::inputParameterRangeChanged(MappingInput*)
 {
 	updateMappingChain(nullptr);
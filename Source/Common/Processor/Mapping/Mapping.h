@@ -55,6 +55,8 @@ public:
 	virtual void multiplexPreviewIndexChanged() override;
 
 	void process(bool sendOutput = true, int multiplexIndex = -1, bool forceSend = false);
+	void processIndices(const Array<int>& multiplexIndices, bool sendOutput = true, bool forceSend = false); //checks and locks once for a whole set of updated indices
+	void processIndexInternal(int multiplexIndex, bool sendOutput, bool forceSend); //needs mappingLock and filterLock
 
 	void updateContinuousProcess();
 
@@ -72,6 +74,7 @@ public:
 
 	void inputReferenceChanged(MappingInput*, int multiplexIndex) override;
 	void inputParameterValueChanged(MappingInput*, int multiplexIndex) override;
+	void inputParameterValuesChanged(MappingInput*, const Array<int>& multiplexIndices) override;
 	void inputParameterRangeChanged(MappingInput*) override;
 
 	void onContainerParameterChangedInternal(Parameter* p) override;
@@ -56,8 +56,10 @@ void MappingOutput::setCommand(CommandDefinition * cd)
 	}
 }
 
-void MappingOutput::setValue(var value, int multiplexIndex)
+void MappingOutput::setValue(var value, int multiplexIndex, const BigInteger* changedComponents)
 {
 	if (!enabled->boolValue() || forceDisabled) return;
-	if(command != nullptr) command->setValue(value, multiplexIndex);
+	if (command == nullptr) return;
+
+	command->setValue(value, multiplexIndex, changedComponents);
 }
\ No newline at end of file
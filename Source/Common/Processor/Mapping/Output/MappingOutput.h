@@ -30,7 +30,7 @@ public:
 
 	virtual void setCommand(CommandDefinition * cd) override;
 
-	void setValue(var value, int multiplexIndex);
+	void setValue(var value, int multiplexIndex, const BigInteger* changedComponents = nullptr);
 
 	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MappingOutput)
 };
\ No newline at end of file
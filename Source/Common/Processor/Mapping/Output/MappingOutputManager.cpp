@@ -50,8 +50,12 @@ void MappingOutputManager::setOutParams(Array<Parameter *> params, int multiplex
 	outParams.set(multiplexIndex, Array<WeakReference<Parameter>>(params.getRawDataPointer(), params.size()));
 	if(outParams.size() > 0) for (auto &o : items) o->setOutParams(outParams[multiplexIndex], multiplexIndex); //better than this ? should handle all ?
 
-	prevMergedValue.ensureStorageAllocated(multiplexIndex+1);
-	prevMergedValue.set(multiplexIndex, getMergedOutValue(multiplexIndex));
+	if (updateMergedValue(multiplexIndex))
+	{
+		MergedOutValue* mv = mergedValues[multiplexIndex];
+		mv->dirtyMask.setRange(0, mv->numbers.size(), false);
+		mv->buildValue();
+	}
 
 	omAsyncNotifier.addMessage(new OutputManagerEvent(OutputManagerEvent::OUTPUT_CHANGED));
 }
@@ -59,12 +63,16 @@ void MappingOutputManager::setOutParams(Array<Parameter *> params, int multiplex
 
 void MappingOutputManager::updateOutputValues(int multiplexIndex, bool sendOnOutputChangedOnly)
 {
-	var value = getMergedOutValue(multiplexIndex);
-	if (value.isVoid()) return; //possible if parameters have been deleted in another thread during process
-	if (sendOnOutputChangedOnly && value == prevMergedValue[multiplexIndex]) return;
+	if (!updateMergedValue(multiplexIndex)) return; //possible if parameters have been deleted in another thread during process
+
+	MergedOutValue* mv = mergedValues[multiplexIndex];
+	bool changed = !mv->dirtyMask.isZero();
+	if (sendOnOutputChangedOnly && !changed) return;
 
-	for (auto& i : items) i->setValue(value, multiplexIndex);
-	prevMergedValue.set(multiplexIndex, value);
+	if (changed || mv->value.isVoid()) mv->buildValue();
+	if (mv->value.isVoid()) return;
+
+	for (auto& i : items) i->setValue(mv->value, multiplexIndex, &mv->dirtyMask);
 }
 
 void MappingOutputManager::updateOutputValue(MappingOutput * o, int multiplexIndex)
@@ -81,7 +89,7 @@ var MappingOutputManager::getMergedOutValue(int multiplexIndex)
 	var value;
 	for (auto& o : outParams[multiplexIndex])
 	{
-		if (o.wasObjectDeleted()) return var();
+		if (o == nullptr || o.wasObjectDeleted()) return var();
 
 		var val = o->getValue();
 		if (!val.isArray()) value.append(val);
@@ -97,6 +105,75 @@ var MappingOutputManager::getMergedOutValue(int multiplexIndex)
 	return value;
 }
 
+bool MappingOutputManager::updateMergedValue(int multiplexIndex)
+{
+	if (multiplexIndex < 0 || multiplexIndex >= outParams.size()) return false;
+	while (mergedValues.size() <= multiplexIndex) mergedValues.add(new MergedOutValue());
+
+	MergedOutValue* mv = mergedValues[multiplexIndex];
+	int prevNumComponents = mv->numbers.size();
+	mv->dirtyMask.setRange(0, prevNumComponents, false);
+
+	int numComponents = 0;
+	for (auto& o : outParams.getReference(multiplexIndex))
+	{
+		if (o == nullptr || o.wasObjectDeleted()) return false;
+
+		var val = o->getValue();
+		if (!val.isArray()) mv->updateComponent(numComponents++, val);
+		else
+		{
+			for (int i = 0; i < val.size(); ++i) mv->updateComponent(numComponents++, val[i]);
+		}
+	}
+
+	if (numComponents != prevNumComponents)
+	{
+		//layout changed, every component is new
+		mv->numbers.resize(numComponents);
+		mv->components.resize(numComponents);
+		mv->numeric.resize(numComponents);
+		mv->dirtyMask.setRange(0, numComponents, true);
+	}
+
+	return true;
+}
+
+void MappingOutputManager::MergedOutValue::updateComponent(int index, const var& v)
+{
+	if (index >= numbers.size())
+	{
+		numbers.add(0);
+		components.add(var());
+		numeric.add(false);
+		dirtyMask.setBit(index);
+	}
+
+	if (v.isDouble() || v.isInt() || v.isInt64() || v.isBool())
+	{
+		double d = v;
+		if (numeric.getUnchecked(index) && numbers.getUnchecked(index) == d) return;
+
+		numbers.set(index, d);
+		numeric.set(index, true);
+	}
+	else
+	{
+		if (!numeric.getUnchecked(index) && components.getReference(index) == v) return;
+		numeric.set(index, false);
+	}
+
+	components.getReference(index) = v;
+	dirtyMask.setBit(index);
+}
+
+void MappingOutputManager::MergedOutValue::buildValue()
+{
+	//a new array each time, outputs may keep a reference to the previous one
+	if (components.isEmpty()) value = var();
+	else value = components;
+}
+
 void MappingOutputManager::addItemInternal(MappingOutput * o, var)
 {
 	o->addCommandHandlerListener(this);
@@ -22,7 +22,21 @@ public:
 	bool forceDisabled;
 
 	Array<Array<WeakReference<Parameter>>> outParams;
-	Array<var> prevMergedValue;
+
+	//Flattened output values for one multiplex index, kept between updates to find what changed without building a new var
+	struct MergedOutValue
+	{
+		Array<double> numbers; //numeric and bool components, used to compare without var conversions
+		Array<var> components; //every component as received, so the value keeps its original types
+		Array<bool> numeric;
+		BigInteger dirtyMask; //components that changed during the last update
+		var value; //value sent to the outputs, only rebuilt when a component changed
+
+		void updateComponent(int index, const var& v);
+		void buildValue();
+	};
+
+	OwnedArray<MergedOutValue> mergedValues;
 
 	void clear() override;
 
@@ -36,6 +50,7 @@ public:
 	void updateOutputValue(MappingOutput* o, int multiplexIndex);
 
 	var getMergedOutValue(int multiplexIndex);
+	bool updateMergedValue(int multiplexIndex);
 
 	void addItemInternal(MappingOutput* o, var) override;
 	void removeItemInternal(MappingOutput* o) override;
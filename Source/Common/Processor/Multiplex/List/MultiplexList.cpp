@@ -14,7 +14,12 @@
 
 BaseMultiplexList::BaseMultiplexList(const String& name, var params) :
 	BaseItem(name, false),
-	listSize(0)
+	listSize(0),
+	numDirtyWords(0),
+	isDispatchingItems(false),
+	liveStart(1),
+	liveEnd(0),
+	liveExpressionRate(20)
 {
 	showInspectorOnSelect = false;
 	isSelectable = false;
@@ -22,11 +27,26 @@ BaseMultiplexList::BaseMultiplexList(const String& name, var params) :
 
 BaseMultiplexList::~BaseMultiplexList()
 {
+	stopTimer();
+	cancelPendingUpdate();
 }
 
 void BaseMultiplexList::setSize(int size)
 {
 	if (size == listSize) return;
+
+	int numWords = (size + 31) / 32;
+	if (numWords > numDirtyWords)
+	{
+		//only grows, shrinking the list keeps the current flags
+		std::unique_ptr<std::atomic<uint32>[]> newDirtyItems(new std::atomic<uint32>[numWords]);
+
+		SpinLock::ScopedLockType lock(dirtyItemsLock);
+		for (int w = 0; w < numWords; w++) newDirtyItems[w] = w < numDirtyWords ? dirtyItems[w].load() : 0;
+		dirtyItems.swap(newDirtyItems);
+		numDirtyWords = numWords;
+	}
+
 	listSize = size;
 	updateControllablesSetup();
 }
@@ -50,40 +70,101 @@ void BaseMultiplexList::updateControllablesSetup()
 	}
 }
 
-void BaseMultiplexList::fillFromExpression(const String& s, int start, int end)
+void BaseMultiplexList::fillFromExpression(const String& s, int start, int end, bool logValues)
 {
-	for (int i = jmax(start - 1, 0); i < end; i++)
+	MultiplexListExpression e;
+	if (!e.compile(s))
 	{
-		String exp = s.replace("{index}", String(i + 1)).replace("{index0}", String(i));
+		NLOGERROR(niceName, "Error in expression : " << e.error);
+		return;
+	}
 
-		LOG("Exp(#" << (i + 1) << ") : " << exp);
+	applyExpression(e, start, end, logValues);
+}
 
-		ScriptExpression e;
-		e.setExpression(exp);
-		if (e.state == ScriptExpression::EXPRESSION_LOADED)
-		{
-			e.evaluate();
-			LOG(" > " << e.currentValue.toString());
+void BaseMultiplexList::applyExpression(MultiplexListExpression& e, int start, int end, bool logValues)
+{
+	int first = jmax(start - 1, 0);
+	int last = jmin(end, list.size());
+	if (first >= last) return;
 
-			if (list[i]->type == Controllable::TARGET)
-			{
-				if (!e.currentValue.isString() || e.currentValue.toString().isEmpty())
-				{
-					((TargetParameter*)list[i])->resetValue();
-				}
-				else if (e.currentValue.toString() != "{value}")
-				{
-					((TargetParameter*)list[i])->setValue(e.currentValue.toString());
-				}
-			}
-			else
-			{
-				if (!e.currentValue.isVoid())
-				{
-					if (list[i]->type != Controllable::TRIGGER) ((Parameter*)list[i])->setValue(e.currentValue);
-				}
-			}
+	Array<var> values;
+	values.ensureStorageAllocated(last - first);
+
+	for (int i = first; i < last; i++)
+	{
+		var val = e.evaluate(i);
+		if (e.error.isNotEmpty())
+		{
+			NLOGERROR(niceName, "Error evaluating expression for #" << (i + 1) << " : " << e.error);
+			return;
 		}
+
+		if (logValues) NLOG(niceName, "#" << (i + 1) << " > " << val.toString());
+		values.add(val);
+	}
+
+	//apply all values in one batch so listeners see the whole list updated
+	ScopedBatch batch(this);
+	for (int i = first; i < last; i++) setItemValueFromExpression(i, values[i - first]);
+}
+
+void BaseMultiplexList::setItemValueFromExpression(int index, const var& value)
+{
+	Controllable* c = list[index];
+	if (c == nullptr || c->type == Controllable::TRIGGER) return;
+
+	Parameter* p = (Parameter*)c;
+
+	if (c->type == Controllable::TARGET)
+	{
+		if (!value.isString() || value.toString().isEmpty()) p->resetValue();
+		else if (value.toString() != "{value}") p->setValue(value.toString());
+	}
+	else
+	{
+		if (!value.isVoid()) p->setValue(value);
+	}
+}
+
+void BaseMultiplexList::setLiveExpression(const String& s, int start, int end)
+{
+	std::unique_ptr<MultiplexListExpression> e(new MultiplexListExpression());
+	if (!e->compile(s))
+	{
+		NLOGERROR(niceName, "Error in live expression : " << e->error);
+		clearLiveExpression();
+		return;
+	}
+
+	liveExpression = s;
+	liveStart = start;
+	liveEnd = end;
+	liveCompiledExpression = std::move(e);
+	startTimerHz(liveExpressionRate);
+}
+
+void BaseMultiplexList::clearLiveExpression()
+{
+	stopTimer();
+	liveExpression = "";
+	liveCompiledExpression.reset();
+}
+
+void BaseMultiplexList::timerCallback()
+{
+	if (liveCompiledExpression == nullptr)
+	{
+		stopTimer();
+		return;
+	}
+
+	applyExpression(*liveCompiledExpression, liveStart, liveEnd);
+
+	if (liveCompiledExpression->error.isNotEmpty())
+	{
+		NLOGWARNING(niceName, "Live expression stopped");
+		clearLiveExpression();
 	}
 }
 
@@ -103,6 +184,16 @@ var BaseMultiplexList::getJSONData(bool includeNonOverriden)
 {
 	var data = BaseItem::getJSONData(includeNonOverriden);
 	data.getDynamicObject()->setProperty("listSize", listSize);
+
+	if (liveExpression.isNotEmpty())
+	{
+		var liveData(new DynamicObject());
+		liveData.getDynamicObject()->setProperty("expression", liveExpression);
+		liveData.getDynamicObject()->setProperty("start", liveStart);
+		liveData.getDynamicObject()->setProperty("end", liveEnd);
+		data.getDynamicObject()->setProperty("liveExpression", liveData);
+	}
+
 	return data;
 }
 
@@ -111,17 +202,179 @@ void BaseMultiplexList::loadJSONData(var data, bool createIfNotThere)
 	setSize(data.getProperty("listSize", 0));
 	loadJSONDataMultiplexInternal(data);
 	BaseItem::loadJSONData(data, createIfNotThere);
+
+	var liveData = data.getProperty("liveExpression", var());
+	if (liveData.isObject()) setLiveExpression(liveData.getProperty("expression", ""), liveData.getProperty("start", 1), liveData.getProperty("end", listSize));
 }
 
 void BaseMultiplexList::notifyItemUpdated(int multiplexIndex)
 {
-	GenericScopedTryLock lock(notifyLock);
-	if (!lock.isLocked()) return;
-
 	jassert(multiplexIndex >= 0);
-	listListeners.call(&MultiplexListListener::listItemUpdated, multiplexIndex);
+
+	{
+		SpinLock::ScopedLockType lock(dirtyItemsLock);
+		if (multiplexIndex < 0 || multiplexIndex >= numDirtyWords * 32) return;
+		dirtyItems[multiplexIndex >> 5].fetch_or(1u << (multiplexIndex & 31));
+	}
+
+	dispatchDirtyItems();
+}
+
+void BaseMultiplexList::dispatchDirtyItems()
+{
+	for (int pass = 0; pass < maxDispatchPasses; pass++)
+	{
+		if (batchDepth.get() > 0) return; //the last batch of this thread will dispatch when it ends
+
+		//only one dispatcher at a time, items flagged meanwhile will be picked up by the next pass of the current dispatcher
+		bool expected = false;
+		if (!isDispatchingItems.compare_exchange_strong(expected, true)) return;
+
+		Array<int> indices;
+		{
+			SpinLock::ScopedLockType lock(dirtyItemsLock);
+			for (int w = 0; w < numDirtyWords; w++)
+			{
+				uint32 bits = dirtyItems[w].exchange(0);
+				for (int b = 0; bits != 0; b++, bits >>= 1)
+				{
+					if ((bits & 1) != 0 && w * 32 + b < listSize) indices.add(w * 32 + b);
+				}
+			}
+		}
+
+		if (!indices.isEmpty()) listListeners.call(&MultiplexListListener::listItemsUpdated, indices);
+
+		isDispatchingItems = false;
+
+		if (!hasDirtyItems()) return;
+	}
+
+	//listeners kept updating the list, the remaining items are sent later instead of being lost
+	triggerAsyncUpdate();
+}
+
+bool BaseMultiplexList::hasDirtyItems()
+{
+	SpinLock::ScopedLockType lock(dirtyItemsLock);
+	for (int w = 0; w < numDirtyWords; w++) if (dirtyItems[w].load() != 0) return true;
+	return false;
+}
+
+void BaseMultiplexList::handleAsyncUpdate()
+{
+	dispatchDirtyItems();
 }
 
+BaseMultiplexList::ScopedBatch::ScopedBatch(BaseMultiplexList* list) :
+	list(list)
+{
+	list->batchDepth.get()++;
+}
+
+BaseMultiplexList::ScopedBatch::~ScopedBatch()
+{
+	if (--list->batchDepth.get() == 0) list->dispatchDirtyItems();
+}
+
+bool MultiplexListExpression::compile(const String& exp)
+{
+	expression = exp;
+	error = "";
+
+	engine.reset(new JavascriptEngine());
+	engine->maximumExecutionTime = RelativeTime::seconds(1);
+	if (Engine::mainEngine != nullptr) engine->registerNativeObject("root", Engine::mainEngine->getScriptObject().getDynamicObject());
+
+	String body = getFunctionBody(exp, substitutePerItem);
+	if (substitutePerItem) body = getSubstitutedExpression(exp, 0); //only checked for syntax here, evaluated for each item
+
+	Result r = engine->execute("function " + functionId.toString() + "(index, index0) { return (" + body + "); }");
+	if (r.failed())
+	{
+		error = r.getErrorMessage();
+		engine.reset();
+		return false;
+	}
+
+	return true;
+}
+
+var MultiplexListExpression::evaluate(int index0)
+{
+	if (engine == nullptr) return var();
+
+	Result r = Result::ok();
+	var result;
+
+	if (substitutePerItem) result = engine->evaluate(getSubstitutedExpression(expression, index0), &r);
+	else
+	{
+		var args[] = { index0 + 1, index0 };
+		result = engine->callFunction(functionId, var::NativeFunctionArgs(var(), args, 2), &r);
+	}
+
+	if (r.failed())
+	{
+		error = r.getErrorMessage();
+		return var();
+	}
+
+	return result;
+}
+
+String MultiplexListExpression::getFunctionBody(const String& exp, bool& needsSubstitution)
+{
+	//{index} and {index0} become the function arguments, inside string literals the string is split around them
+	String result;
+	juce_wchar quote = 0;
+	needsSubstitution = false;
+
+	auto isPartOfName = [](juce_wchar c) { return CharacterFunctions::isLetterOrDigit(c) || c == '_' || c == '$' || c == '.'; };
+
+	for (int i = 0; i < exp.length(); i++)
+	{
+		juce_wchar c = exp[i];
+
+		if (quote != 0 && c == '\\' && i + 1 < exp.length())
+		{
+			result += exp.substring(i, i + 2);
+			i++;
+			continue;
+		}
+
+		bool isIndex0 = exp.substring(i, i + 8) == "{index0}";
+		if (isIndex0 || exp.substring(i, i + 7) == "{index}")
+		{
+			int wildcardLength = isIndex0 ? 8 : 7;
+			String v = isIndex0 ? "index0" : "index";
+			if (quote != 0) result += String::charToString(quote) + " + " + v + " + " + String::charToString(quote);
+			else
+			{
+				if ((i > 0 && isPartOfName(exp[i - 1])) || (i + wildcardLength < exp.length() && isPartOfName(exp[i + wildcardLength]))) needsSubstitution = true;
+				result += "(" + v + ")";
+			}
+			i += wildcardLength - 1;
+			continue;
+		}
+
+		if (c == '"' || c == '\'')
+		{
+			if (quote == 0) quote = c;
+			else if (quote == c) quote = 0;
+		}
+
+		result += String::charToString(c);
+	}
+
+	return result.trim().trimCharactersAtEnd(";");
+}
+
+String MultiplexListExpression::getSubstitutedExpression(const String& exp, int index0)
+{
+	//same as the text replacement that was done before expressions were compiled
+	return exp.replace("{index}", String(index0 + 1)).replace("{index0}", String(index0)).trim().trimCharactersAtEnd(";");
+}
 
 InputValueMultiplexList::InputValueMultiplexList(var params) :
 	BaseMultiplexList(getTypeString(), params)
@@ -229,6 +482,7 @@ void InputValueMultiplexList::onExternalParameterRangeChanged(Parameter* p)
 void InputValueMultiplexList::onExternalParameterValueChanged(Parameter* p)
 {
 	jassert(controllableIndexMap.contains(p));
+	ScopedBatch batch(this);
 	for (auto& i : controllableIndexMap[p]) notifyItemUpdated(i);
 	//notifyItemUpdated(inputControllables.indexOf(p));
 }
@@ -236,6 +490,7 @@ void InputValueMultiplexList::onExternalParameterValueChanged(Parameter* p)
 void InputValueMultiplexList::onExternalTriggerTriggered(Trigger* t)
 {
 	jassert(controllableIndexMap.contains(t));
+	ScopedBatch batch(this);
 	for (auto& i : controllableIndexMap[t]) notifyItemUpdated(i);
 }
 
@@ -17,8 +17,32 @@ struct IterativeContext
 	int indexInList;
 };
 
+//Expression compiled once as a function of index and index0, so it can be evaluated for many items without being parsed again.
+//When a wildcard is part of an identifier or a path (e.g. group{index}.value), it can't be a variable, so the number is substituted for each item as before
+class MultiplexListExpression
+{
+public:
+	MultiplexListExpression() : substitutePerItem(false) {}
+	~MultiplexListExpression() {}
+
+	const Identifier functionId = "__listExpression";
+
+	String expression;
+	String error;
+	bool substitutePerItem;
+	std::unique_ptr<JavascriptEngine> engine;
+
+	bool compile(const String& expression);
+	var evaluate(int index0);
+
+	static String getFunctionBody(const String& expression, bool& needsSubstitution);
+	static String getSubstitutedExpression(const String& expression, int index0);
+};
+
 class BaseMultiplexList :
-	public BaseItem
+	public BaseItem,
+	public Timer,
+	public AsyncUpdater
 {
 public:
 	BaseMultiplexList(const String& name = "List", var params = var());
@@ -27,13 +51,33 @@ public:
 	int listSize;
 	Array<Controllable*> list;
 
-	CriticalSection notifyLock;
+	//Updated items are flagged here and dispatched to the listeners in batches. The lock only guards the flags storage
+	//when the list grows, listeners are never called with it
+	SpinLock dirtyItemsLock;
+	std::unique_ptr<std::atomic<uint32>[]> dirtyItems;
+	int numDirtyWords;
+	std::atomic<bool> isDispatchingItems;
+	ThreadLocalValue<int> batchDepth; //per thread, a batch only holds back the dispatch of the thread that opened it
+	const int maxDispatchPasses = 32; //avoid looping forever if listeners keep updating the list, remaining items are dispatched asynchronously
 
 	void setSize(int size);
 
 	virtual void updateControllablesSetup();
 
-	void fillFromExpression(const String& s, int start, int end);
+	//Live expression, evaluated continuously
+	String liveExpression;
+	int liveStart;
+	int liveEnd;
+	int liveExpressionRate;
+	std::unique_ptr<MultiplexListExpression> liveCompiledExpression;
+
+	void fillFromExpression(const String& s, int start, int end, bool logValues = false);
+	void applyExpression(MultiplexListExpression& e, int start, int end, bool logValues = false);
+	void setItemValueFromExpression(int index, const var& value);
+
+	void setLiveExpression(const String& s, int start, int end);
+	void clearLiveExpression();
+	void timerCallback() override;
 
 	virtual Controllable* createListControllable();
 
@@ -44,6 +88,19 @@ public:
 	virtual Controllable* getTargetControllableAt(int multiplexIndex) { return list[multiplexIndex]; }
 
 	void notifyItemUpdated(int multiplexIndex);
+	void dispatchDirtyItems();
+	bool hasDirtyItems();
+	void handleAsyncUpdate() override;
+
+	//Items updated while a batch is alive are dispatched all at once when the last batch of that thread ends.
+	//Other threads keep dispatching and may pick up some of those items earlier.
+	class ScopedBatch
+	{
+	public:
+		ScopedBatch(BaseMultiplexList* list);
+		~ScopedBatch();
+		BaseMultiplexList* list;
+	};
 
 	InspectableEditor* getNumberListEditor(bool isFloat, bool isRoot, Array<Inspectable*> inspectables = Array<Inspectable*>());
 
@@ -177,7 +234,7 @@ template<class T>
 void MultiplexList<T>::onContainerParameterChangedInternal(Parameter* p)
 {
 	int index = list.indexOf(p);
-	if (index != -1) listListeners.call(&MultiplexListListener::listItemUpdated, index);
+	if (index != -1) notifyItemUpdated(index);
 	BaseMultiplexList::onContainerParameterChangedInternal(p);
 }
 
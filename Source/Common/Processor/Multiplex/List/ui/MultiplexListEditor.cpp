@@ -342,18 +342,30 @@ void InputValueListEditor::showRangeMenuAndFillFromControllables(Array<WeakRefer
 BaseMultiplexListEditor::ExpressionComponentWindow::ExpressionComponentWindow(BaseMultiplexList* list) :
 	list(list),
 	assignBT("Assign"),
+	logBT("Log values"),
+	liveBT("Live"),
 	startIndex("Start", "Index at which to start the expression evaluation", 1, 1, list->listSize),
 	endIndex("End", "Index at which to stop the expression evaluation (inclusive)", list->listSize, 1, list->listSize),
 	startUI(&startIndex),
 	endUI(&endIndex)
 {
-	instructions.setText("This expression will be used to fill each item in this list. You can use wildcards {index} and {index0} to replace with index of the item that is processed. You can also modify the start and end index for narrowing down the evaluation.", dontSendNotification);
+	instructions.setText("This expression will be used to fill each item in this list. You can use wildcards {index} and {index0} to replace with index of the item that is processed. You can also modify the start and end index for narrowing down the evaluation. When Live is checked, the expression is kept and evaluated continuously.", dontSendNotification);
+
+	if (list->liveExpression.isNotEmpty())
+	{
+		editor.setText(list->liveExpression, false);
+		startIndex.setValue(list->liveStart);
+		endIndex.setValue(list->liveEnd);
+		liveBT.setToggleState(true, dontSendNotification);
+	}
 
 	addAndMakeVisible(&instructions);
 	addAndMakeVisible(&editor);
 	addAndMakeVisible(&assignBT);
 	addAndMakeVisible(&startUI);
 	addAndMakeVisible(&endUI);
+	addAndMakeVisible(&logBT);
+	addAndMakeVisible(&liveBT);
 
 	assignBT.addListener(this);
 	//addAndMakeVisible(&closeBT);
@@ -375,6 +387,9 @@ void BaseMultiplexListEditor::ExpressionComponentWindow::resized()
 	startUI.setBounds(ir.removeFromLeft(150));
 	ir.removeFromLeft(20);
 	endUI.setBounds(ir.removeFromLeft(150));
+	ir.removeFromLeft(20);
+	logBT.setBounds(ir.removeFromLeft(100));
+	liveBT.setBounds(ir.removeFromLeft(80));
 
 	editor.setBounds(r.removeFromTop(100));
 	assignBT.setBounds(r.removeFromTop(40).reduced(2));
@@ -384,7 +399,15 @@ void BaseMultiplexListEditor::ExpressionComponentWindow::buttonClicked(Button* b
 {
 	if (b == &assignBT)
 	{
-		list->fillFromExpression(editor.getText(), startIndex.intValue(), endIndex.intValue());
+		if (liveBT.getToggleState())
+		{
+			list->setLiveExpression(editor.getText(), startIndex.intValue(), endIndex.intValue());
+		}
+		else
+		{
+			list->clearLiveExpression();
+			list->fillFromExpression(editor.getText(), startIndex.intValue(), endIndex.intValue(), logBT.getToggleState());
+		}
 	}
 }
 
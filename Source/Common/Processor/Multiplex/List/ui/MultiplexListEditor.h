@@ -41,6 +41,8 @@ public:
 		TextEditor editor;
 		TextButton assignBT;
 		TextButton closeBT;
+		ToggleButton logBT;
+		ToggleButton liveBT;
 
 		IntParameter startIndex;
 		IntParameter endIndex;
@@ -41,4 +41,5 @@ public:
     virtual ~MultiplexListListener() {}
     virtual void listReferenceUpdated(int /* multiplexIndex */ ) {}
     virtual void listItemUpdated(int /* multiplexIndex */) {}
+    virtual void listItemsUpdated(const Array<int>& multiplexIndices) { for (auto& i : multiplexIndices) listItemUpdated(i); }
 };
@@ -0,0 +1,303 @@
+/*
+  ==============================================================================
+
+	SessionArchive.cpp
+	Created: 19 Oct 2026 2:20:13pm
+	Author:  bkupe
+
+  ==============================================================================
+*/
+
+SessionArchive::SessionArchive()
+{
+}
+
+void SessionArchive::addSection(const String& name, var data)
+{
+	Section* s = new Section();
+	s->name = name;
+	s->data = data;
+	s->isValid = true;
+	sections.add(s);
+}
+
+SessionArchive::Section* SessionArchive::getSection(const String& name) const
+{
+	for (auto& s : sections) if (s->name == name) return s;
+	return nullptr;
+}
+
+var SessionArchive::getSectionData(const String& name) const
+{
+	Section* s = getSection(name);
+	return s != nullptr && s->isValid ? s->data : var();
+}
+
+void SessionArchive::encodeAll()
+{
+	runParallel([](Section* s) { s->payload = encodeValue(s->data); });
+}
+
+void SessionArchive::decodeAll()
+{
+	runParallel([](Section* s)
+		{
+			double t = Time::getMillisecondCounterHiRes();
+			s->data = decodeValue(s->payload);
+			s->isValid = !s->data.isVoid();
+			s->payload.reset();
+			s->decodeTime = Time::getMillisecondCounterHiRes() - t;
+		});
+}
+
+void SessionArchive::runParallel(std::function<void(Section*)> func)
+{
+	//sections don't share anything, each job only touches its own section
+	runParallel(sections.size(), [this, func](int i) { func(sections[i]); });
+}
+
+void SessionArchive::runParallel(int numJobs, std::function<void(int)> func)
+{
+	if (numJobs <= 1)
+	{
+		for (int i = 0; i < numJobs; i++) func(i);
+		return;
+	}
+
+	std::atomic<int> numRemaining{ numJobs };
+	WaitableEvent allDone;
+
+	ThreadPool pool(jmin(numJobs, SystemStats::getNumCpus()));
+	for (int i = 0; i < numJobs; i++)
+	{
+		pool.addJob([func, i, &numRemaining, &allDone]()
+			{
+				func(i);
+				if (--numRemaining == 0) allDone.signal();
+			});
+	}
+
+	allDone.wait();
+}
+
+bool SessionArchive::writeTo(OutputStream& os)
+{
+	encodeAll();
+
+	os.writeInt(archiveMagic);
+	os.writeInt(archiveVersion);
+	os.writeInt(sections.size());
+
+	int64 offset = 0;
+	for (auto& s : sections)
+	{
+		os.writeString(s->name);
+		os.writeInt64(offset);
+		os.writeInt64((int64)s->payload.getSize());
+		offset += s->payload.getSize();
+	}
+
+	for (auto& s : sections)
+	{
+		if (!os.write(s->payload.getData(), s->payload.getSize())) return false;
+		s->payload.reset();
+	}
+
+	return true;
+}
+
+bool SessionArchive::readFrom(const void* data, size_t size)
+{
+	sections.clear();
+
+	MemoryInputStream is(data, size, false);
+	if (is.readInt() != archiveMagic) return false;
+
+	int version = is.readInt();
+	if (version > archiveVersion)
+	{
+		LOGERROR("Session archive version " << version << " is not supported by this version of Chataigne");
+		return false;
+	}
+
+	int numSections = is.readInt();
+	if (numSections < 0 || numSections > 1024) return false;
+
+	Array<int64> offsets;
+	for (int i = 0; i < numSections; i++)
+	{
+		Section* s = new Section();
+		s->name = is.readString();
+		offsets.add(is.readInt64());
+		int64 sectionSize = is.readInt64();
+		if (sectionSize < 0) return false;
+		s->payload.setSize((size_t)sectionSize);
+		sections.add(s);
+	}
+
+	int64 payloadStart = is.getPosition();
+	for (int i = 0; i < numSections; i++)
+	{
+		MemoryBlock& b = sections[i]->payload;
+		if (offsets[i] < 0 || payloadStart + offsets[i] + (int64)b.getSize() > (int64)size) return false;
+		b.copyFrom((const char*)data + payloadStart + offsets[i], 0, b.getSize());
+	}
+
+	return true;
+}
+
+String SessionArchive::toBase64()
+{
+	MemoryOutputStream os;
+	if (!writeTo(os)) return "";
+	return os.getMemoryBlock().toBase64Encoding();
+}
+
+bool SessionArchive::loadFromBase64(const String& s)
+{
+	MemoryBlock b;
+	if (!b.fromBase64Encoding(s)) return false;
+	return readFrom(b.getData(), b.getSize());
+}
+
+MemoryBlock SessionArchive::encodeValue(const var& v)
+{
+	MemoryBlock result;
+	{
+		MemoryOutputStream raw;
+		HashMap<String, int> keys;
+		writeValue(raw, v, keys);
+
+		MemoryOutputStream mos(result, false);
+		GZIPCompressorOutputStream zos(mos, 4);
+		zos.write(raw.getData(), raw.getDataSize());
+	}
+	return result;
+}
+
+var SessionArchive::decodeValue(const MemoryBlock& block)
+{
+	if (block.isEmpty()) return var();
+
+	MemoryInputStream mis(block, false);
+	GZIPDecompressorInputStream zis(mis);
+	MemoryBlock decompressed;
+	zis.readIntoMemoryBlock(decompressed);
+
+	MemoryInputStream is(decompressed, false);
+	Array<Identifier> keys;
+	return readValue(is, keys);
+}
+
+//var::writeToStream can't write objects, so the session uses its own tagged format.
+//Property names are written once and then referenced by index, as the same names are repeated in every item.
+void SessionArchive::writeValue(OutputStream& os, const var& v, HashMap<String, int>& keys)
+{
+	if (v.isVoid()) os.writeByte(VOID_VALUE);
+	else if (v.isUndefined()) os.writeByte(UNDEFINED_VALUE);
+	else if (v.isBool()) os.writeByte((bool)v ? TRUE_VALUE : FALSE_VALUE);
+	else if (v.isInt()) { os.writeByte(INT_VALUE); os.writeCompressedInt((int)v); }
+	else if (v.isInt64()) { os.writeByte(INT64_VALUE); os.writeInt64((int64)v); }
+	else if (v.isDouble()) { os.writeByte(DOUBLE_VALUE); os.writeDouble((double)v); }
+	else if (v.isString()) { os.writeByte(STRING_VALUE); os.writeString(v.toString()); }
+	else if (v.isBinaryData())
+	{
+		os.writeByte(BINARY_VALUE);
+		os.writeCompressedInt((int)v.getBinaryData()->getSize());
+		os.write(v.getBinaryData()->getData(), v.getBinaryData()->getSize());
+	}
+	else if (v.isArray())
+	{
+		os.writeByte(ARRAY_VALUE);
+		os.writeCompressedInt(v.size());
+		for (auto& i : *v.getArray()) writeValue(os, i, keys);
+	}
+	else if (DynamicObject* o = v.getDynamicObject())
+	{
+		os.writeByte(OBJECT_VALUE);
+		NamedValueSet& props = o->getProperties();
+		os.writeCompressedInt(props.size());
+		for (auto& p : props)
+		{
+			String key = p.name.toString();
+			if (keys.contains(key)) os.writeCompressedInt(keys[key] + 1);
+			else
+			{
+				os.writeCompressedInt(0);
+				os.writeString(key);
+				keys.set(key, keys.size());
+			}
+			writeValue(os, p.value, keys);
+		}
+	}
+	else os.writeByte(VOID_VALUE); //methods and other native objects are not saved
+}
+
+var SessionArchive::readValue(InputStream& is, Array<Identifier>& keys)
+{
+	switch (is.readByte())
+	{
+	case UNDEFINED_VALUE: return var::undefined();
+	case FALSE_VALUE: return false;
+	case TRUE_VALUE: return true;
+	case INT_VALUE: return is.readCompressedInt();
+	case INT64_VALUE: return is.readInt64();
+	case DOUBLE_VALUE: return is.readDouble();
+	case STRING_VALUE: return is.readString();
+
+	case BINARY_VALUE:
+	{
+		int size = is.readCompressedInt();
+		if (size < 0 || size > is.getNumBytesRemaining()) return var();
+		MemoryBlock b;
+		is.readIntoMemoryBlock(b, size);
+		return b;
+	}
+
+	case ARRAY_VALUE:
+	{
+		int size = is.readCompressedInt();
+		var result;
+		result.resize(0);
+		for (int i = 0; i < size && !is.isExhausted(); i++) result.append(readValue(is, keys));
+		return result;
+	}
+
+	case OBJECT_VALUE:
+	{
+		int size = is.readCompressedInt();
+		var result(new DynamicObject());
+		for (int i = 0; i < size && !is.isExhausted(); i++)
+		{
+			int keyIndex = is.readCompressedInt();
+			Identifier key;
+			if (keyIndex == 0)
+			{
+				key = is.readString();
+				keys.add(key);
+			}
+			else if (keyIndex <= keys.size()) key = keys[keyIndex - 1];
+			else return var();
+
+			result.getDynamicObject()->setProperty(key, readValue(is, keys));
+		}
+		return result;
+	}
+
+	default:
+		break;
+	}
+
+	return var();
+}
+
+void SessionArchive::packDeferredProperty(var managerData, const Identifier& property)
+{
+	var itemsData = managerData.getProperty("items", var());
+	for (int i = 0; i < itemsData.size(); i++)
+	{
+		var itemData = itemsData[i];
+		if (!itemData.isObject() || !itemData.hasProperty(property)) continue;
+		itemData.getDynamicObject()->setProperty(property, encodeValue(itemData.getProperty(property, var())));
+	}
+}
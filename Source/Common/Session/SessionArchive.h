@@ -0,0 +1,66 @@
+/*
+  ==============================================================================
+
+	SessionArchive.h
+	Created: 19 Oct 2026 2:20:13pm
+	Author:  bkupe
+
+  ==============================================================================
+*/
+
+#pragma once
+
+/*
+Compact binary container for session data.
+Each section (one per manager) is stored as a compressed binary var stream, indexed by a section table at the start of the archive,
+so sections can be decoded independently and in parallel.
+Heavy sub-trees can be packed with packDeferredProperty, they stay encoded as binary data until the owner decodes them with decodeValue.
+*/
+class SessionArchive
+{
+public:
+	SessionArchive();
+	~SessionArchive() {}
+
+	static const int archiveMagic = 0x41544843; // "CHTA"
+	static const int archiveVersion = 1;
+
+	struct Section
+	{
+		String name;
+		var data;
+		MemoryBlock payload;
+		double decodeTime = 0; //in ms
+		bool isValid = false;
+	};
+
+	OwnedArray<Section> sections;
+
+	void addSection(const String& name, var data);
+	Section* getSection(const String& name) const;
+	var getSectionData(const String& name) const;
+
+	void encodeAll();
+	void decodeAll();
+
+	bool writeTo(OutputStream& os);
+	bool readFrom(const void* data, size_t size);
+
+	String toBase64();
+	bool loadFromBase64(const String& s);
+
+	static MemoryBlock encodeValue(const var& v);
+	static var decodeValue(const MemoryBlock& block);
+	static void packDeferredProperty(var managerData, const Identifier& property);
+
+	static void runParallel(int numJobs, std::function<void(int)> func); //returns when all jobs are done
+
+private:
+	enum ValueType { VOID_VALUE, UNDEFINED_VALUE, FALSE_VALUE, TRUE_VALUE, INT_VALUE, INT64_VALUE, DOUBLE_VALUE, STRING_VALUE, BINARY_VALUE, ARRAY_VALUE, OBJECT_VALUE };
+	static void writeValue(OutputStream& os, const var& v, HashMap<String, int>& keys);
+	static var readValue(InputStream& is, Array<Identifier>& keys);
+
+	void runParallel(std::function<void(Section*)> func);
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SessionArchive)
+};
@@ -0,0 +1,160 @@
+/*
+  ==============================================================================
+
+	TimecodeChaser.cpp
+	Created: 19 Oct 2026 10:12:41am
+	Author:  bkupe
+
+  ==============================================================================
+*/
+
+TimecodeChaser::TimecodeChaser(double frameRate) :
+	frameRate(frameRate),
+	seekThreshold(.5),
+	maxRateCorrection(.05),
+	correctionTime(1),
+	timeout(.5),
+	bandwidth(1)
+{
+	reset();
+}
+
+void TimecodeChaser::reset()
+{
+	SpinLock::ScopedLockType sl(lock);
+	resetInternal();
+}
+
+void TimecodeChaser::setFrameRate(double fps)
+{
+	//the source thread reads frameRate while pushing samples
+	SpinLock::ScopedLockType sl(lock);
+	if (fps <= 0 || fps == frameRate) return;
+	frameRate = fps;
+	resetInternal();
+}
+
+void TimecodeChaser::resetInternal()
+{
+	hasSamples = false;
+	filteredTime = 0;
+	rate = 1;
+	lastHostTime = 0;
+	period = 1.0 / jmax(frameRate, 1.0);
+	errorVariance = 0;
+	numLockedSamples = 0;
+	stats = Stats();
+}
+
+void TimecodeChaser::pushSourceTime(double sourceTime, double hostTime)
+{
+	SpinLock::ScopedLockType sl(lock);
+
+	double dt = hostTime - lastHostTime;
+	if (!hasSamples || dt <= 0 || dt > timeout)
+	{
+		relock(sourceTime, hostTime);
+		return;
+	}
+
+	double predicted = filteredTime + rate * dt;
+	double error = sourceTime - predicted;
+
+	if (std::abs(error) > seekThreshold)
+	{
+		//jump in the source, no need to filter
+		relock(sourceTime, hostTime);
+		return;
+	}
+
+	period += (dt - period) * .1;
+
+	//2nd order loop, coefficients from the loop bandwidth and the update period
+	double omega = MathConstants<double>::twoPi * bandwidth * period;
+	double b = jmin(MathConstants<double>::sqrt2 * omega, .9);
+	double c = omega * omega;
+
+	filteredTime = predicted + b * error;
+	rate = jlimit(.5, 2.0, rate + c * error / dt);
+	lastHostTime = hostTime;
+
+	errorVariance += (error * error - errorVariance) * .05;
+
+	double frameTime = 1.0 / jmax(frameRate, 1.0);
+	if (std::abs(error) < frameTime) numLockedSamples++;
+	else if (std::abs(error) > frameTime * 2) numLockedSamples = 0;
+
+	stats.isLocked = numLockedSamples >= 8;
+	stats.jitter = std::sqrt(errorVariance);
+	stats.rate = rate;
+	stats.numSamples++;
+}
+
+void TimecodeChaser::relock(double sourceTime, double hostTime)
+{
+	if (hasSamples) stats.numRelocks++;
+
+	hasSamples = true;
+	filteredTime = sourceTime;
+	rate = 1;
+	lastHostTime = hostTime;
+	period = 1.0 / jmax(frameRate, 1.0);
+	errorVariance = 0;
+	numLockedSamples = 0;
+
+	stats.isLocked = false;
+	stats.jitter = 0;
+	stats.rate = rate;
+	stats.numSamples++;
+}
+
+bool TimecodeChaser::isRunning(double hostTime) const
+{
+	SpinLock::ScopedLockType sl(lock);
+	return hasSamples && hostTime - lastHostTime <= timeout;
+}
+
+double TimecodeChaser::getSourceTimeAt(double hostTime) const
+{
+	SpinLock::ScopedLockType sl(lock);
+	if (!hasSamples) return 0;
+
+	//extrapolate between samples, but don't run away if the source stopped sending
+	double dt = jlimit(0.0, timeout, hostTime - lastHostTime);
+	return filteredTime + rate * dt;
+}
+
+double TimecodeChaser::getCorrectedRate(double followerTime, double hostTime) const
+{
+	double error = getSourceTimeAt(hostTime) - followerTime;
+
+	SpinLock::ScopedLockType sl(lock);
+	double correction = jlimit(-maxRateCorrection, maxRateCorrection, error / jmax(correctionTime, .01));
+	return rate * (1 + correction);
+}
+
+bool TimecodeChaser::shouldSeek(double followerTime, double hostTime) const
+{
+	return std::abs(getSourceTimeAt(hostTime) - followerTime) > seekThreshold;
+}
+
+TimecodeChaser::Stats TimecodeChaser::getStats() const
+{
+	SpinLock::ScopedLockType sl(lock);
+	return stats;
+}
+
+double TimecodeChaser::getTimeForTimecode(int hours, int minutes, int seconds, int frames, double fps, bool dropFrame, int days)
+{
+	if (fps <= 0) return 0;
+
+	if (dropFrame)
+	{
+		//29.97 drop frame : frames 0 and 1 are skipped every minute, except every 10th minute
+		int64 totalMinutes = (int64)days * 1440 + hours * 60 + minutes;
+		int64 frameNumber = ((int64)days * 86400 + hours * 3600 + minutes * 60 + seconds) * 30 + frames - 2 * (totalMinutes - totalMinutes / 10);
+		return frameNumber * 1001.0 / 30000.0;
+	}
+
+	return (double)days * 86400.0 + hours * 3600.0 + minutes * 60.0 + seconds + frames / fps;
+}
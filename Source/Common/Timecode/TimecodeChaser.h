@@ -0,0 +1,77 @@
+/*
+  ==============================================================================
+
+	TimecodeChaser.h
+	Created: 19 Oct 2026 10:12:41am
+	Author:  bkupe
+
+  ==============================================================================
+*/
+
+#pragma once
+
+/*
+Shared chase engine for external timecode sources (MTC, LTC...).
+Sources push their decoded time with the host time at which it was valid. The chaser filters these samples
+with a second-order loop (delay-locked loop), so it can give a smooth source time at any host time in between frames,
+along with the estimated source rate. Followers use getCorrectedRate() to slightly adjust their own rate
+instead of seeking, and only seek when the error gets bigger than seekThreshold.
+
+This class does not depend on any module or device, so it can be fed with synthetic timecode streams.
+*/
+class TimecodeChaser
+{
+public:
+	TimecodeChaser(double frameRate = 30);
+	~TimecodeChaser() {}
+
+	//Settings
+	double frameRate;
+	double seekThreshold; //in seconds, errors above this will make followers seek instead of correcting their rate
+	double maxRateCorrection; //maximum relative speed correction, 0.05 means +/- 5%
+	double correctionTime; //time in seconds in which the follower should absorb its error
+	double timeout; //time in seconds without new samples after which the source is considered stopped
+	double bandwidth; //loop bandwidth in Hz, lower is smoother but slower to follow
+
+	struct Stats
+	{
+		bool isLocked = false;
+		double jitter = 0; //RMS of the difference between incoming samples and the filtered time, in seconds
+		double rate = 1; //estimated source speed
+		int numSamples = 0;
+		int numRelocks = 0;
+	};
+
+	void reset();
+	void setFrameRate(double fps);
+
+	void pushSourceTime(double sourceTime, double hostTime);
+
+	bool isRunning(double hostTime) const;
+	double getSourceTimeAt(double hostTime) const;
+	double getCorrectedRate(double followerTime, double hostTime) const;
+	bool shouldSeek(double followerTime, double hostTime) const;
+
+	Stats getStats() const;
+
+	static double getHostTime() { return Time::getMillisecondCounterHiRes() / 1000.0; }
+	static double getTimeForTimecode(int hours, int minutes, int seconds, int frames, double fps, bool dropFrame = false, int days = 0);
+
+private:
+	mutable SpinLock lock;
+
+	bool hasSamples;
+	double filteredTime; //filtered source time at lastHostTime
+	double rate;
+	double lastHostTime;
+	double period; //smoothed interval between samples
+
+	double errorVariance;
+	int numLockedSamples;
+	Stats stats;
+
+	void resetInternal();
+	void relock(double sourceTime, double hostTime);
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TimecodeChaser)
+};
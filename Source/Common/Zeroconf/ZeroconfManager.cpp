@@ -19,48 +19,117 @@
 juce_ImplementSingleton(ZeroconfManager)
 
 ZeroconfManager::ZeroconfManager() :
-	zeroconfAsyncNotifier(5)
+	Thread("Zeroconf"),
+	browseInterval(50),
+	serviceTTL(10000),
+	hostCacheTTL(60000),
+	resolvePool(1),
+	zeroconfAsyncNotifier(50)
 {
+	startThread();
 }
 
 ZeroconfManager::~ZeroconfManager()
 {
+	stopThread(4000);
+	resolvePool.removeAllJobs(true, 4000);
+	searchers.clear();
 }
 
 ZeroconfManager::ZeroconfSearcher* ZeroconfManager::addSearcher(StringRef name, StringRef serviceName)
 {
-	ZeroconfSearcher* s = getSearcher(name);
-
-	if (s == nullptr)
-	{
-		s = new ZeroconfSearcher(name, serviceName);
-		searchers.getLock().enter();
-		searchers.add(s);
-		searchers.getLock().exit();
-	}
+	GenericScopedLock lock(searchers.getLock());
 
-	//search();
+	ZeroconfSearcher* s = getSearcher(name);
+	if (s == nullptr) s = searchers.add(new ZeroconfSearcher(this, name, serviceName));
 
+	notify();
 	return s;
 }
 
 void ZeroconfManager::removeSearcher(StringRef name)
 {
+	GenericScopedLock lock(searchers.getLock());
 	ZeroconfSearcher* s = getSearcher(name);
-	if (s == nullptr)
-	{
-		searchers.getLock().enter();
-		searchers.removeObject(s);
-		searchers.getLock().exit();
-	}
+	if (s != nullptr) searchers.removeObject(s);
 }
 
 ZeroconfManager::ZeroconfSearcher* ZeroconfManager::getSearcher(StringRef name)
 {
+	GenericScopedLock lock(searchers.getLock());
 	for (auto& s : searchers) if (s->name == name) return s;
 	return nullptr;
 }
 
+bool ZeroconfManager::getCachedIPForHost(const String& host, String& ip)
+{
+	GenericScopedLock lock(hostLock);
+	if (!hostIPs.contains(host) || Time::getMillisecondCounter() - hostResolveTimes[host] > (uint32)hostCacheTTL) return false;
+	ip = hostIPs[host];
+	return true;
+}
+
+void ZeroconfManager::resolveHostAsync(const String& host)
+{
+	{
+		GenericScopedLock lock(hostLock);
+		if (resolvingHosts.contains(host)) return;
+		resolvingHosts.add(host);
+	}
+
+	resolvePool.addJob([this, host]()
+		{
+			String ip = getIPForHost(host);
+
+			{
+				GenericScopedLock lock(hostLock);
+				resolvingHosts.removeString(host);
+				if (ip.isNotEmpty())
+				{
+					hostIPs.set(host, ip);
+					hostResolveTimes.set(host, Time::getMillisecondCounter());
+				}
+			}
+
+			GenericScopedLock lock(searchers.getLock());
+			for (auto& s : searchers) s->hostResolved(host, ip);
+		});
+}
+
+String ZeroconfManager::getIPForHost(String host)
+{
+	struct hostent* he;
+	if ((he = gethostbyname(host.toStdString().c_str())) == NULL)
+	{
+		DBG("Could not resolve Host : " << host);
+		return "";
+	}
+
+	struct in_addr** addr_list = (struct in_addr**)he->h_addr_list;
+
+	if(addr_list[0] != nullptr) return String(inet_ntoa(*addr_list[0]));
+	DBG("Could not resolve Host : " << host);
+	return "";
+}
+
+void ZeroconfManager::run()
+{
+	//all the browsers are polled without blocking from this single thread, servus doesn't give access to its sockets
+	while (!threadShouldExit())
+	{
+		{
+			GenericScopedLock lock(searchers.getLock());
+			for (auto& s : searchers)
+			{
+				if (threadShouldExit()) return;
+				s->poll();
+			}
+		}
+
+		wait(browseInterval);
+	}
+}
+
 void ZeroconfManager::showMenuAndGetService(StringRef searcherName, std::function<void(ZeroconfManager::ServiceInfo *)> returnFunc, bool showLocal, bool showRemote, bool separateLocalAndRemote, bool excludeInternal, const String& nameFilter)
 {
 	ZeroconfSearcher* s = getSearcher(searcherName);
@@ -71,77 +140,98 @@ void ZeroconfManager::showMenuAndGetService(StringRef searcherName, std::functio
 		return;
 	}
 
+	//only copy the names, the services may change while the menu is open
 	PopupMenu p;
-	if (s->services.isEmpty())
-	{
-		p.addItem(-1, "No service found", false);
-	}
-	else
+	StringArray serviceNames;
+
 	{
-		for (int i = 0; i < s->services.size(); i++)
+		GenericScopedLock lock(s->servicesLock);
+		for (auto& info : s->services)
 		{
-			ServiceInfo* info = s->services[i];
 			if (nameFilter.isNotEmpty() && !info->name.contains(nameFilter)) continue;
-			p.addItem(1 + i, info->name + " on " + info->host + " (" + info->getIP() + ":" + String(info->port) + ")");
+			serviceNames.add(info->name);
+			p.addItem(serviceNames.size(), info->name + " on " + info->host + " (" + info->getIP() + ":" + String(info->port) + ")");
 		}
 	}
 
-	
-	p.showMenuAsync(PopupMenu::Options(), [s, returnFunc](int result)
+	if (serviceNames.isEmpty()) p.addItem(-1, "No service found", false);
+
+	String sName = searcherName;
+	p.showMenuAsync(PopupMenu::Options(), [this, sName, serviceNames, returnFunc](int result)
 		{
 			if (result <= 0) return;
 
-			returnFunc(s->services[result - 1]);
+			ZeroconfSearcher* searcher = getSearcher(sName);
+			if (searcher == nullptr) return;
+
+			ServiceInfo* info = searcher->getService(serviceNames[result - 1]);
+			if (info != nullptr) returnFunc(info);
 		}
 	);
 }
 
-ZeroconfManager::ZeroconfSearcher::ZeroconfSearcher(StringRef name, StringRef serviceName) :
-	Thread("Zeroconf Searcher " + name),
+ZeroconfManager::ZeroconfSearcher::ZeroconfSearcher(ZeroconfManager* manager, StringRef name, StringRef serviceName) :
+	manager(manager),
 	name(name),
-	serviceName(serviceName)
+	serviceName(serviceName),
+	nextCacheCheckTime(0)
 {
-	startThread();
 }
 
 ZeroconfManager::ZeroconfSearcher::~ZeroconfSearcher()
 {
-	{
-		if (servus != nullptr && servus->isBrowsing()) servus->endBrowsing();
-		
-		ScopedLock lock(browseLock);
-		servus.reset();
-		stopThread(4000);
-	}
-	
+	if (servus != nullptr && servus->isBrowsing()) servus->endBrowsing();
+	servus.reset();
+
+	GenericScopedLock lock(servicesLock);
+	pendingServices.clear();
 	services.clear();
 }
 
-ZeroconfManager::ServiceInfo* ZeroconfManager::ZeroconfSearcher::getService(StringRef sName, StringRef host, int port)
+ZeroconfManager::ServiceInfo* ZeroconfManager::ZeroconfSearcher::getService(StringRef sName)
 {
-	for (auto& i : services)
-	{
-		if (Thread::getCurrentThread()->threadShouldExit()) return nullptr;
-		if (i->name == sName && i->host == host && i->port == port) return i;
-	}
+	GenericScopedLock lock(servicesLock);
+	for (auto& i : services) if (i->name == sName) return i;
 	return nullptr;
 }
 
-void ZeroconfManager::ZeroconfSearcher::addService(StringRef sName, StringRef host, StringRef ip, int port, const HashMap<String, String>& keys)
+void ZeroconfManager::ZeroconfSearcher::addOrUpdateService(StringRef sName, StringRef host, StringRef ip, int port, const HashMap<String, String>& keys)
 {
-	if (Thread::getCurrentThread()->threadShouldExit()) return;
+	ServiceInfo* s = nullptr;
+	bool isNew = false;
 
-	String keysStr = ", keys : ";
-	HashMap<String, String>::Iterator it(keys);
-	while (it.next()) keysStr += "\n > " + it.getKey() + " = " + it.getValue();
+	{
+		GenericScopedLock lock(servicesLock);
+		s = getService(sName);
 
+		if (s == nullptr)
+		{
+			s = services.add(new ServiceInfo(sName, host, ip, port, keys));
+			isNew = true;
+		}
+		else
+		{
+			if (s->host == host && s->ip == ip && s->port == port) return;
+			s->host = host;
+			s->setIP(ip);
+			s->port = port;
+			s->setKeys(keys);
+		}
 
-	jassert(getService(sName, host, port) == nullptr);
-	ServiceInfo* s = new ServiceInfo(sName, host, ip, port, keys);
+		s->expireTime = Time::getMillisecondCounter() + manager->serviceTTL;
+	}
+
+	if (isNew)
+	{
+		NLOG("Zeroconf", "New " << name << " service discovered : " << s->name << " on " << s->host << ", " << s->ip << ":" << s->port << (s->isLocal ? " (local)" : ""));
+		listeners.call(&SearcherListener::serviceAdded, s);
+	}
+	else
+	{
+		listeners.call(&SearcherListener::serviceUpdated, s);
+	}
 
-	services.add(s);
-	NLOG("Zeroconf", "New " << name << " service discovered : " << s->name << " on " << s->host << ", " << s->ip << ":" << s->port << (s->isLocal ? " (local)" : ""));// << service->keys);
-	listeners.call(&SearcherListener::serviceAdded, s);
+	manager->zeroconfAsyncNotifier.addMessage(new ZeroconfEvent(isNew ? ZeroconfEvent::SERVICE_ADDED : ZeroconfEvent::SERVICE_UPDATED, name, s->name));
 }
 
 void ZeroconfManager::ZeroconfSearcher::removeService(ServiceInfo* s)
@@ -149,34 +239,66 @@ void ZeroconfManager::ZeroconfSearcher::removeService(ServiceInfo* s)
 	jassert(s != nullptr);
 	NLOG("Zeroconf", name << " service removed : " << s->name);
 	listeners.call(&SearcherListener::serviceRemoved, s);
+	manager->zeroconfAsyncNotifier.addMessage(new ZeroconfEvent(ZeroconfEvent::SERVICE_REMOVED, name, s->name));
+
+	GenericScopedLock lock(servicesLock);
 	services.removeObject(s);
 }
 
-void ZeroconfManager::ZeroconfSearcher::updateService(ServiceInfo* service, StringRef host, StringRef ip, int port, const HashMap<String, String>& keys)
+void ZeroconfManager::ZeroconfSearcher::poll()
+{
+	if (servus == nullptr)
+	{
+		servus.reset(new servus::Servus(String(serviceName).toStdString()));
+		servus->addListener(this);
+		servus->beginBrowsing(servus::Servus::Interface::IF_ALL);
+	}
+
+	servus->browse(0); //doesn't wait, calls instanceAdded and instanceRemoved for what arrived since last poll
+
+	uint32 now = Time::getMillisecondCounter();
+	if ((int)(nextCacheCheckTime - now) > 0) return;
+	nextCacheCheckTime = now + 1000;
+
+	//refresh what the browser still lists, expire the rest
+	servus::Strings instances = servus->getInstances();
+	Array<ServiceInfo*> expiredServices;
+
+	{
+		GenericScopedLock lock(servicesLock);
+		for (auto& s : services)
+		{
+			if (std::find(instances.begin(), instances.end(), s->name.toStdString()) != instances.end()) s->expireTime = now + manager->serviceTTL;
+			else if ((int)(now - s->expireTime) > 0) expiredServices.add(s);
+		}
+	}
+
+	for (auto& s : expiredServices) removeService(s);
+}
+
+void ZeroconfManager::ZeroconfSearcher::hostResolved(const String& host, const String& ip)
 {
-	jassert(service != nullptr);
-	service->host = host;
-	service->ip = ip;
-	service->port = port;
-	service->setKeys(keys);
-
-	//NLOG("Zeroconf", "New " << name << " service updated : " << service->name << " on " << service->host << ", " << service->ip << ":" << service->port << (service->isLocal ? " (local)" : ""));
-	listeners.call(&SearcherListener::serviceUpdated, service);
+	OwnedArray<ServiceInfo> resolved;
+
+	{
+		GenericScopedLock lock(servicesLock);
+		for (int i = pendingServices.size() - 1; i >= 0; i--)
+		{
+			if (pendingServices[i]->host == host) resolved.add(pendingServices.removeAndReturn(i));
+		}
+	}
+
+	for (auto& s : resolved) addOrUpdateService(s->name, s->host, ip, s->port, s->keys);
 }
 
 void ZeroconfManager::ZeroconfSearcher::instanceAdded(const std::string& instance)
 {
-	servus::Servus::Data d;
-	servus->getData(d);
-
 	String host = servus->get(instance, "servus_host");
 	if (host.endsWithChar('.')) host = host.substring(0, host.length() - 1);
 
 	int port = String(servus->get(instance, "servus_port")).getIntValue();
 	String ip = String(servus->get(instance, "servus_ip"));
 
-	if (ip.isEmpty()) ip = getIPForHost(host);
-
 	servus::Strings skeys = servus->getKeys(instance);
 	HashMap<String, String> keys;
 	for (auto& k : skeys)
@@ -186,74 +308,48 @@ void ZeroconfManager::ZeroconfSearcher::instanceAdded(const std::string& instanc
 		keys.set(k, kv);
 	}
 
-	ServiceInfo* info = getService(instance, host, port);
-
-	if (info == nullptr)
-	{
-		addService(instance, host, ip, port, keys);
-	}
-	else if (info->host != host || info->port != port || info->ip != ip)
+	if (ip.isEmpty() && !manager->getCachedIPForHost(host, ip))
 	{
-		updateService(info, host, ip, port, keys);
-	}
-}
-
-void ZeroconfManager::ZeroconfSearcher::instanceRemoved(const std::string& instance)
-{
-	String s = instance;
-	//String host = servus->get(instance, "servus_host");
-	//if (host.endsWithChar('.')) host = host.substring(0, host.length() - 1);
-	//int port = String(servus->get(instance, "servus_port")).getIntValue();
-
-	for (auto& ss : services)
-	{
-		if (ss->name == s)
+		//resolving may take a while, the service is added when it's done
 		{
-			removeService(ss);
-			return;
+			GenericScopedLock lock(servicesLock);
+			for (auto& p : pendingServices)
+			{
+				if (p->name != String(instance)) continue;
+				pendingServices.removeObject(p);
+				break;
+			}
+			pendingServices.add(new ServiceInfo(String(instance), host, "", port, keys));
 		}
-	}
-}
 
-String ZeroconfManager::ZeroconfSearcher::getIPForHost(String host)
-{
-	struct hostent* he;
-	if ((he = gethostbyname(host.toStdString().c_str())) == NULL)
-	{
-		DBG("Could not resolve Host : " << host);
-		return "";
+		manager->resolveHostAsync(host);
+		return;
 	}
 
-	struct in_addr** addr_list = (struct in_addr**)he->h_addr_list;
-
-	if(addr_list[0] != nullptr) return String(inet_ntoa(*addr_list[0]));
-	DBG("Could not resolve Host : " << host);
-	return "";
+	addOrUpdateService(String(instance), host, ip, port, keys);
 }
 
-void ZeroconfManager::ZeroconfSearcher::run()
+void ZeroconfManager::ZeroconfSearcher::instanceRemoved(const std::string& instance)
 {
-	servus.reset(new servus::Servus(String(serviceName).toStdString()));
-	servus->addListener(this);
-
-	servus->beginBrowsing(servus::Servus::Interface::IF_ALL);
+	String s = instance;
 
-	while (!threadShouldExit())
 	{
+		GenericScopedLock lock(servicesLock);
+		for (auto& p : pendingServices)
 		{
-			ScopedLock lock(browseLock);
-			if (threadShouldExit() || servus == nullptr) return;
-			servus->browse(1000);
+			if (p->name != s) continue;
+			pendingServices.removeObject(p);
+			break;
 		}
-		wait(500);
 	}
 
+	if (ServiceInfo* info = getService(s)) removeService(info);
 }
 
 ZeroconfManager::ServiceInfo::ServiceInfo(StringRef name, StringRef host, StringRef ip, int port, const HashMap<String, String>& _keys) :
-	name(name), host(host), ip(ip), port(port)
+	name(name), host(host), ip(ip), port(port), expireTime(0)
 {
 	setKeys(_keys);
 	isLocal = NetworkHelpers::isIPLocal(ip);
 	//DBG("New service info, keys : " << keys.size() << ", items");
-}
\ No newline at end of file
+}
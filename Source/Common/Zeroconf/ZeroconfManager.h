@@ -13,7 +13,12 @@
 #include "servus/servus.h"
 #include "servus/listener.h"
 
-class ZeroconfManager
+/*
+All service types are browsed from a single discovery thread, and hosts are resolved on a separate resolver thread,
+so looking up services (menus, modules) never waits for the network.
+*/
+class ZeroconfManager :
+	public Thread
 {
 public:
 	juce_DeclareSingleton(ZeroconfManager, true);
@@ -31,6 +36,13 @@ public:
 		int port;
 		HashMap<String, String> keys;
 		bool isLocal;
+		uint32 expireTime; //removed from the cache if not seen by the browser until this time
+
+		void setIP(StringRef _ip)
+		{
+			ip = _ip;
+			isLocal = NetworkHelpers::isIPLocal(ip);
+		}
 
 		void setKeys(const HashMap<String, String>& _keys)
 		{
@@ -49,31 +61,32 @@ public:
 	};
 
 	class ZeroconfSearcher :
-		public servus::Listener,
-		public Thread
+		public servus::Listener
 	{
 	public:
-		ZeroconfSearcher(StringRef name, StringRef serviceName);
+		ZeroconfSearcher(ZeroconfManager* manager, StringRef name, StringRef serviceName);
 		~ZeroconfSearcher();
 
+		ZeroconfManager* manager;
 		String name;
 		String serviceName;
 		std::unique_ptr<servus::Servus> servus;
+
+		CriticalSection servicesLock;
 		OwnedArray<ServiceInfo> services;
-		CriticalSection browseLock;
+		OwnedArray<ServiceInfo> pendingServices; //waiting for their host to be resolved
+		uint32 nextCacheCheckTime;
 
-		ServiceInfo * getService(StringRef name, StringRef host, int port);
-		void addService(StringRef name, StringRef host, StringRef ip, int port, const HashMap<String, String> & keys = HashMap<String, String>());
+		ServiceInfo * getService(StringRef name);
+		void addOrUpdateService(StringRef name, StringRef host, StringRef ip, int port, const HashMap<String, String> & keys = HashMap<String, String>());
 		void removeService(ServiceInfo * service);
-		void updateService(ServiceInfo * service, StringRef host, StringRef ip, int port, const HashMap<String, String>  &keys = HashMap<String, String>());
+
+		void poll();
+		void hostResolved(const String& host, const String& ip);
 
 		void instanceAdded(const std::string& instance) override;
 		void instanceRemoved(const std::string& instance) override;
 
-		String getIPForHost(String host);
-
-		void run() override;
-
 		class SearcherListener
 		{
 		public:
@@ -90,18 +103,37 @@ public:
 
 	OwnedArray<ZeroconfSearcher, CriticalSection> searchers;
 
+	int browseInterval; //ms between two polls of all the browsers
+	int serviceTTL; //ms after which a service that the browser doesn't list anymore is removed
+	int hostCacheTTL; //ms during which a resolved host is reused
+
 	ZeroconfSearcher * addSearcher(StringRef name, StringRef serviceName);
 	void removeSearcher(StringRef name);
 
 	ZeroconfSearcher * getSearcher(StringRef name);
 
+	//Host resolution
+	ThreadPool resolvePool;
+	CriticalSection hostLock;
+	HashMap<String, String> hostIPs;
+	HashMap<String, uint32> hostResolveTimes;
+	StringArray resolvingHosts;
+
+	bool getCachedIPForHost(const String& host, String& ip);
+	void resolveHostAsync(const String& host);
+	static String getIPForHost(String host);
+
+	void run() override;
+
 	void showMenuAndGetService(StringRef service, std::function<void(ServiceInfo *)> returnFunc, bool showLocal = true, bool showRemote = true, bool separateLocalAndRemote = true, bool excludeInternal = true, const String &nameFilter = "");
 	
 	class ZeroconfEvent {
 	public:
-		enum Type { SERVICES_CHANGED };
-		ZeroconfEvent(Type type) : type(type) {}
+		enum Type { SERVICES_CHANGED, SERVICE_ADDED, SERVICE_UPDATED, SERVICE_REMOVED };
+		ZeroconfEvent(Type type, const String& searcherName = "", const String& serviceName = "") : type(type), searcherName(searcherName), serviceName(serviceName) {}
 		Type type;
+		String searcherName;
+		String serviceName;
 	};
 
 	QueuedNotifier<ZeroconfEvent> zeroconfAsyncNotifier;
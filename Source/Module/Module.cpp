@@ -21,7 +21,9 @@ Module::Module(const String& name) :
 	alwaysShowValues(false),
 	includeValuesInSave(false),
 	customType(""),
-	canHandleRouteValues(false)
+	canHandleRouteValues(false),
+	dependencyUpdater(this),
+	scriptCallbacksUpdater(this)
 {
 	itemDataType = "Module";
 	showWarningInUI = true;
@@ -140,22 +142,96 @@ CommandDefinition* Module::getCommandDefinitionForItemID(int itemID)
 	else return defManager->definitions[itemID];
 }
 
+void Module::handleRoutedModuleValues(const Array<Controllable*>& values, const Array<RouteParams*>& params)
+{
+	for (int i = 0; i < values.size(); i++) handleRoutedModuleValue(values[i], params[i]);
+}
+
 void Module::onControllableFeedbackUpdateInternal(ControllableContainer* cc, Controllable* c)
 {
 	if (cc == &valuesCC)
 	{
-		Array<var> args;
-		args.add(c->getScriptObject());
-		scriptManager->callFunctionOnAllItems("moduleValueChanged", args);
+		if (hasScriptCallback(moduleValueChangedId))
+		{
+			Array<var> args;
+			args.add(c->getScriptObject());
+			scriptManager->callFunctionOnAllItems(moduleValueChangedId, args);
+		}
 	}
 	else if (cc == &moduleParams)
 	{
-		Array<var> args;
-		args.add(c->getScriptObject());
-		scriptManager->callFunctionOnAllItems("moduleParameterChanged", args);
+		if (hasScriptCallback(moduleParameterChangedId))
+		{
+			Array<var> args;
+			args.add(c->getScriptObject());
+			scriptManager->callFunctionOnAllItems(moduleParameterChangedId, args);
+		}
 	}
 
 	if (c->type != Controllable::TRIGGER) processDependencies((Parameter*)c);
+
+	if (cc == scriptManager.get()) scriptCallbacksUpdater.triggerAsyncUpdate(); //file, reload or enable change on one of the scripts
+}
+
+void Module::childStructureChanged(ControllableContainer* cc)
+{
+	BaseItem::childStructureChanged(cc);
+	scriptCallbacksUpdater.triggerAsyncUpdate();
+}
+
+bool Module::hasScriptCallback(const Identifier& callbackId)
+{
+	if (scriptManager->items.size() == 0) return false;
+
+	//the message thread can safely look at the engines, other threads rely on the last published list
+	if (MessageManager::existsAndIsCurrentThread()) updateDefinedScriptCallbacks();
+
+	SpinLock::ScopedLockType lock(scriptCallbacksLock);
+	return definedScriptCallbacks.contains(callbackId);
+}
+
+void Module::updateDefinedScriptCallbacks()
+{
+	jassert(MessageManager::existsAndIsCurrentThread());
+
+	//cheap check against the engines the list was built from, no allocation when nothing changed
+	bool upToDate = scriptCallbacksEngines.size() == scriptManager->items.size();
+	for (int i = 0; upToDate && i < scriptManager->items.size(); i++)
+	{
+		Script* s = scriptManager->items[i];
+		bool isLoaded = s->state == Script::ScriptState::SCRIPT_LOADED && s->scriptEngine != nullptr;
+		upToDate = scriptCallbacksEngines[i] == (isLoaded ? (void*)s->scriptEngine.get() : nullptr)
+			&& scriptCallbacksNumProperties[i] == (isLoaded ? s->scriptEngine->getRootObjectProperties().size() : 0);
+	}
+
+	if (upToDate) return;
+
+	Array<Identifier> callbacks;
+	scriptCallbacksEngines.clear();
+	scriptCallbacksNumProperties.clear();
+
+	for (auto& s : scriptManager->items)
+	{
+		bool isLoaded = s->state == Script::ScriptState::SCRIPT_LOADED && s->scriptEngine != nullptr;
+		scriptCallbacksEngines.add(isLoaded ? (void*)s->scriptEngine.get() : nullptr);
+		scriptCallbacksNumProperties.add(isLoaded ? s->scriptEngine->getRootObjectProperties().size() : 0);
+
+		if (!isLoaded) continue;
+
+		for (auto& sp : s->scriptEngine->getRootObjectProperties())
+		{
+			if (sp.value.isMethod()) callbacks.addIfNotAlreadyThere(sp.name);
+		}
+	}
+
+	//only the swap happens under the lock
+	SpinLock::ScopedLockType lock(scriptCallbacksLock);
+	definedScriptCallbacks.swapWith(callbacks);
+}
+
+void Module::ScriptCallbacksUpdater::handleAsyncUpdate()
+{
+	module->updateDefinedScriptCallbacks();
 }
 
 var Module::getJSONData(bool includeNonOverriden)
@@ -334,7 +410,7 @@ void Module::createControllablesForContainer(var data, ControllableContainer* cc
 						if (sourceP != nullptr)
 						{
 							Dependency* d = new Dependency(sourceP, param, depVar.getProperty("value", 0), depVar.getProperty("check", "").toString(), depVar.getProperty("action", "").toString());
-							dependencies.add(d);
+							addDependency(d);
 						}
 						else
 						{
@@ -358,20 +434,31 @@ void Module::onContainerNiceNameChanged()
 }
 
 
-void Module::processDependencies(Parameter* p)
+void Module::addDependency(Dependency* d)
 {
-	//Dependencies
-	bool changed = false;
-	for (auto& d : dependencies)
-	{
+	dependencies.add(d);
 
-		if (d->source == p) if (d->process()) changed = true;
-	}
+	if (!dependencyMap.contains(d->source)) dependencyMap.set(d->source, Array<Dependency*>(d));
+	else dependencyMap.getReference(d->source).add(d);
+}
 
-	if (changed)
+void Module::processDependencies(Parameter* p)
+{
+	if (!dependencyMap.contains(p)) return;
+
+	//enable changes are notified by the targets themselves, only visibility changes need the editor to be rebuilt
+	bool visibilityChanged = false;
+	for (auto& d : dependencyMap.getReference(p))
 	{
-		queuedNotifier.addMessage(new ContainerAsyncEvent(ContainerAsyncEvent::ControllableContainerNeedsRebuild, this));
+		if (d->process() && d->action == Dependency::SHOW) visibilityChanged = true;
 	}
+
+	if (visibilityChanged) dependencyUpdater.triggerAsyncUpdate();
+}
+
+void Module::DependencyUpdater::handleAsyncUpdate()
+{
+	module->queuedNotifier.addMessage(new ContainerAsyncEvent(ContainerAsyncEvent::ControllableContainerNeedsRebuild, module));
 }
 
 InspectableEditor* Module::getEditorInternal(bool isRoot, Array<Inspectable*> inspectables)
@@ -68,6 +68,33 @@ public:
 	//ROUTING
 	bool canHandleRouteValues;
 
+	//Script callbacks
+	const Identifier moduleValueChangedId = "moduleValueChanged";
+	const Identifier moduleParameterChangedId = "moduleParameterChanged";
+
+	//Callbacks defined in the loaded scripts, so events are only converted to script values when a script handles them.
+	//Script engines are only inspected on the message thread, where scripts are loaded and cleared.
+	//Other threads only read the published list.
+	SpinLock scriptCallbacksLock;
+	Array<Identifier> definedScriptCallbacks;
+	Array<void*> scriptCallbacksEngines; //message thread only
+	Array<int> scriptCallbacksNumProperties; //message thread only
+
+	bool hasScriptCallback(const Identifier& callbackId);
+	void updateDefinedScriptCallbacks();
+
+	//Checks the scripts on the message thread after any script change (reload, error, added or removed script)
+	class ScriptCallbacksUpdater :
+		public AsyncUpdater
+	{
+	public:
+		ScriptCallbacksUpdater(Module * module) : module(module) {}
+		Module * module;
+		void handleAsyncUpdate() override;
+	};
+
+	ScriptCallbacksUpdater scriptCallbacksUpdater;
+
 	//help
     virtual String getHelpID() override;
 
@@ -102,10 +129,23 @@ public:
 	};
 
 	OwnedArray<Dependency> dependencies;
-	HashMap<Parameter *, Dependency *> dependencyMap;
+	HashMap<Parameter *, Array<Dependency *>> dependencyMap; //indexed by source, so a change only evaluates its own rules
 
+	void addDependency(Dependency * d);
 	void processDependencies(Parameter * p);
 
+	//Coalesces visibility changes into one editor rebuild per message loop
+	class DependencyUpdater :
+		public AsyncUpdater
+	{
+	public:
+		DependencyUpdater(Module * module) : module(module) {}
+		Module * module;
+		void handleAsyncUpdate() override;
+	};
+
+	DependencyUpdater dependencyUpdater;
+
 	class RouteParams :
 		public ControllableContainer
 	{
@@ -116,10 +156,12 @@ public:
 
 	virtual RouteParams * createRouteParamsForSourceValue(Module * /*sourceModule*/, Controllable * /*c*/, int /*index*/) { jassert(false); return nullptr; }
 	virtual void handleRoutedModuleValue(Controllable * /*c*/, RouteParams * /*params*/) {} //used for routing, child classes that support routing must override
+	virtual void handleRoutedModuleValues(const Array<Controllable*>& values, const Array<RouteParams*>& params); //batched routing, override to send all values at once (bundle, frame...)
 
 	virtual ModuleRouterController* createModuleRouterController(ModuleRouter* router) { return nullptr; }
 
 	virtual void onControllableFeedbackUpdateInternal(ControllableContainer * cc, Controllable * c) override;
+	virtual void childStructureChanged(ControllableContainer * cc) override;
 	
 	var getJSONData(bool includeNonOverriden = false) override;
 	void loadJSONDataItemInternal(var data) override;
@@ -15,18 +15,23 @@ ModuleRouter::ModuleRouter() :
 	sourceModule(nullptr),
 	destModule(nullptr),
 	sourceValues("Source Values"),
-	routerController(nullptr)
+	routerController(nullptr),
+	lastPendingSequence(0)
 {
 	sourceValues.userCanAddItemsManually = false;
 	selectAllValues = addTrigger("Select All", "Select all values for routing");
 	deselectAllValues = addTrigger("Deselect All", "Deselect all values");
 	routeAllValues = addTrigger("Route All", "Immediately trigger all enabled routes");
 
+	batchRouting = addBoolParameter("Batch Routing", "If checked, value changes are gathered and sent together at the batch rate, letting the output module send them at once (OSC bundle for instance). Only the last value of each source is sent. Triggers are always sent immediately.", false);
+	batchRate = addIntParameter("Batch Rate", "Number of batches per second when Batch Routing is enabled", 50, 1, 200, false);
+
 	addChildControllableContainer(&sourceValues);
 }
 
 ModuleRouter::~ModuleRouter()
 {
+	stopTimer();
 	setSourceModule(nullptr);
 	setDestModule(nullptr);
 }
@@ -44,7 +49,7 @@ void ModuleRouter::setSourceModule(Module * m)
 		sourceModule->removeInspectableListener(this);
 		sourceModule->removeControllableContainerListener(this);
 		sourceModuleRef = nullptr;
-		sourceValues.clear();
+		clearRouterValues();
 	}
 	
 	sourceModule = m;
@@ -59,13 +64,7 @@ void ModuleRouter::setSourceModule(Module * m)
 
 		Array<WeakReference<Controllable>> values = sourceModule->valuesCC.getAllControllables(true);
 		int index = 0;
-		for (auto &c : values)
-		{
-			ModuleRouterValue * mrv = new ModuleRouterValue(c, index++);
-			sourceValues.addItem(mrv, var(), false);
-			mrv->forceDisabled = !enabled->boolValue();
-			mrv->setSourceAndOutModule(sourceModule, destModule);
-		}
+		for (auto &c : values) addRouterValue(c, index++);
 	}
 
 	routerListeners.call(&RouterListener::sourceModuleChanged, this);
@@ -107,7 +106,7 @@ void ModuleRouter::setDestModule(Module * m)
 void ModuleRouter::reloadSourceValues(bool keepData)
 {
 	var prevData = sourceValues.getJSONData();
-	sourceValues.clear();
+	clearRouterValues();
 
 	if (sourceModuleRef.wasObjectDeleted() || destModuleRef.wasObjectDeleted()) return;
 
@@ -116,15 +115,130 @@ void ModuleRouter::reloadSourceValues(bool keepData)
 	for (auto& c : values)
 	{
 		if (c == nullptr || c.wasObjectDeleted()) continue;
-		ModuleRouterValue* mrv = new ModuleRouterValue(c, index++);
-		sourceValues.addItem(mrv, var(), false);
-		mrv->forceDisabled = !enabled->boolValue();
-		mrv->setSourceAndOutModule(sourceModule, destModule);
+		addRouterValue(c, index++);
 	}
 
 	if (keepData) sourceValues.loadItemsData(prevData);
 }
 
+void ModuleRouter::syncSourceValues()
+{
+	if (sourceModule == nullptr || sourceModuleRef.wasObjectDeleted()) return;
+
+	//only add and remove what changed, existing router values keep their settings and route params
+	Array<WeakReference<Controllable>> values = sourceModule->valuesCC.getAllControllables(true);
+
+	HashMap<Controllable*, bool> currentValues;
+	for (auto& c : values) if (c != nullptr && !c.wasObjectDeleted()) currentValues.set(c.get(), true);
+
+	Array<ModuleRouterValue*> valuesToRemove;
+	for (auto& mrv : sourceValues.items)
+	{
+		if (mrv->sourceValue == nullptr || mrv->sourceValue.wasObjectDeleted() || !currentValues.contains(mrv->sourceValue.get())) valuesToRemove.add(mrv);
+	}
+	removeRouterValues(valuesToRemove);
+
+	int index = 0;
+	for (auto& c : values)
+	{
+		if (c == nullptr || c.wasObjectDeleted()) continue;
+
+		if (ModuleRouterValue* mrv = valueMap[c.get()]) mrv->valueIndex = index;
+		else addRouterValue(c, index);
+
+		index++;
+	}
+}
+
+ModuleRouterValue* ModuleRouter::addRouterValue(Controllable* c, int index)
+{
+	ModuleRouterValue* mrv = new ModuleRouterValue(c, index);
+	mrv->router = this;
+	valueMap.set(c, mrv);
+
+	{
+		SpinLock::ScopedLockType lock(pendingLock);
+		routableValues.set(mrv, 0);
+	}
+
+	sourceValues.addItem(mrv, var(), false);
+	mrv->forceDisabled = !enabled->boolValue();
+	mrv->setSourceAndOutModule(sourceModule, destModule);
+	return mrv;
+}
+
+void ModuleRouter::removeRouterValues(Array<ModuleRouterValue*> values)
+{
+	if (values.isEmpty()) return;
+
+	{
+		//their pending entries are skipped by the next batch
+		SpinLock::ScopedLockType lock(pendingLock);
+		for (auto& mrv : values) routableValues.remove(mrv);
+	}
+
+	for (auto& mrv : values)
+	{
+		valueMap.removeValue(mrv);
+		sourceValues.removeItem(mrv, false);
+	}
+}
+
+void ModuleRouter::clearRouterValues()
+{
+	{
+		SpinLock::ScopedLockType lock(pendingLock);
+		routableValues.clear();
+		pendingValues.clear();
+	}
+
+	valueMap.clear();
+	sourceValues.clear();
+}
+
+void ModuleRouter::queueRoutedValue(ModuleRouterValue* mrv)
+{
+	SpinLock::ScopedLockType lock(pendingLock);
+	if (!routableValues.contains(mrv)) return; //being removed
+
+	uint32 sequence = ++lastPendingSequence;
+	if (sequence == 0) sequence = ++lastPendingSequence; //0 means not pending
+	routableValues.set(mrv, sequence);
+	pendingValues.add({ mrv, sequence });
+}
+
+void ModuleRouter::timerCallback()
+{
+	Array<PendingValue> pending;
+	{
+		SpinLock::ScopedLockType lock(pendingLock);
+		pending.swapWith(pendingValues);
+
+		//only the last entry of each value is still current, removed values are not registered anymore
+		for (auto& p : pending)
+		{
+			if (routableValues.contains(p.mrv) && routableValues[p.mrv] == p.sequence) routableValues.set(p.mrv, 0);
+			else p.mrv = nullptr;
+		}
+	}
+
+	Array<ModuleRouterValue*> values;
+	for (auto& p : pending) if (p.mrv != nullptr) values.add(p.mrv);
+
+	if (values.isEmpty() || destModule == nullptr || destModuleRef.wasObjectDeleted()) return;
+
+	Array<Controllable*> controllables;
+	Array<Module::RouteParams*> params;
+	for (auto& mrv : values)
+	{
+		if (mrv->sourceValue == nullptr || mrv->sourceValue.wasObjectDeleted() || mrv->outModule != destModule) continue;
+		controllables.add(mrv->sourceValue.get());
+		params.add(mrv->routeParams.get());
+	}
+
+	destModule->handleRoutedModuleValues(controllables, params);
+}
+
 
 var ModuleRouter::getJSONData(bool includeNonOverriden)
 {
@@ -158,18 +272,15 @@ void ModuleRouter::newMessage(const ContainerAsyncEvent & e)
 	{
 		if (!Engine::mainEngine->isLoadingFile && !isCurrentlyLoadingData && !Engine::mainEngine->isClearing)
 		{
-			reloadSourceValues();
+			syncSourceValues();
 		}
 	}
 }
 
 ModuleRouterValue * ModuleRouter::getRouterValueForControllable(Controllable * c)
 {
-	for (auto &v : sourceValues.items)
-	{
-		if (v->sourceValue == c) return v;
-	}
-
+	ModuleRouterValue* mrv = valueMap[c];
+	if (mrv != nullptr && mrv->sourceValue == c) return mrv;
 	return nullptr;
 }
 
@@ -179,6 +290,16 @@ void ModuleRouter::onContainerParameterChangedInternal(Parameter * p)
 	{
 		for (auto &mrv : sourceValues.items) mrv->forceDisabled = !enabled->boolValue();
 	}
+	else if (p == batchRouting || p == batchRate)
+	{
+		batchRate->setEnabled(batchRouting->boolValue());
+		if (batchRouting->boolValue()) startTimerHz(batchRate->intValue());
+		else
+		{
+			stopTimer();
+			timerCallback(); //flush what's left
+		}
+	}
 }
 
 void ModuleRouter::onContainerTriggerTriggered(Trigger * t)
@@ -15,7 +15,8 @@ class ModuleRouterController;
 class ModuleRouter :
 	public BaseItem,
 	public Inspectable::InspectableListener,
-	public ContainerAsyncListener
+	public ContainerAsyncListener,
+	public Timer
 {
 public:
 	ModuleRouter();
@@ -34,10 +35,37 @@ public:
 	Trigger * deselectAllValues;
 	Trigger * routeAllValues;
 
+	BoolParameter * batchRouting;
+	IntParameter * batchRate;
+
+	HashMap<Controllable *, ModuleRouterValue *> valueMap; //source value -> router value
+
+	//Batched routing. Values are queued from any thread, so they're only accepted while registered here,
+	//removal unregisters them under the lock before deleting them. A value queued again moves to the end of the batch,
+	//its older entry is skipped, so the batch is applied in the order of the last changes
+	struct PendingValue
+	{
+		ModuleRouterValue * mrv;
+		uint32 sequence;
+	};
+
+	SpinLock pendingLock;
+	HashMap<ModuleRouterValue *, uint32> routableValues; //registered values > sequence of their pending entry, 0 if not pending
+	Array<PendingValue> pendingValues;
+	uint32 lastPendingSequence;
+
 	void setSourceModule(Module * m);
 	void setDestModule(Module * m);
 
 	void reloadSourceValues(bool keepData = true);
+	void syncSourceValues();
+
+	ModuleRouterValue * addRouterValue(Controllable * c, int index);
+	void removeRouterValues(Array<ModuleRouterValue *> values);
+	void clearRouterValues();
+
+	void queueRoutedValue(ModuleRouterValue * mrv);
+	void timerCallback() override;
 
 	var getJSONData(bool includeNonOverriden = false) override;
 	void loadJSONDataInternal(var data) override;
@@ -13,7 +13,8 @@ ModuleRouterValue::ModuleRouterValue(Controllable * _sourceValue, int _index) :
 	valueIndex(_index),
 	sourceValue(_sourceValue),
 	outModule(nullptr),
-	forceDisabled(false)
+	forceDisabled(false),
+	router(nullptr)
 {
 	jassert(sourceValue != nullptr);
 
@@ -116,18 +117,24 @@ void ModuleRouterValue::onContainerParameterChangedInternal(Parameter * p)
 	}
 }
 
+void ModuleRouterValue::route()
+{
+	if (router != nullptr && router->batchRouting->boolValue() && sourceValue->type != Controllable::TRIGGER) router->queueRoutedValue(this);
+	else outModule->handleRoutedModuleValue(sourceValue, routeParams.get());
+}
+
 void ModuleRouterValue::onExternalParameterValueChanged(Parameter * p)
 {
 	if (outModule == nullptr) return;
 	if (!enabled->boolValue() || forceDisabled) return;
-	if(p == sourceValue) outModule->handleRoutedModuleValue(sourceValue, routeParams.get());
+	if(p == sourceValue) route();
 }
 
 void ModuleRouterValue::onExternalTriggerTriggered(Trigger * t)
 {
 	if (outModule == nullptr) return;
 	if (!enabled->boolValue() || forceDisabled) return;
-	if(t == sourceValue) outModule->handleRoutedModuleValue(sourceValue, routeParams.get());
+	if(t == sourceValue) route();
 }
 
 void ModuleRouterValue::childStructureChanged(ControllableContainer* cc)
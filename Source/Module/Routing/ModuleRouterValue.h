@@ -10,6 +10,8 @@
 
 #pragma once
 
+class ModuleRouter;
+
 class ModuleRouterValue :
 	public BaseItem
 {
@@ -26,6 +28,10 @@ public:
 
 	bool forceDisabled; //for router enable
 
+	ModuleRouter * router;
+
+	void route();
+
 	std::unique_ptr<Module::RouteParams> routeParams;
 
 	void setSourceAndOutModule(Module * sourceModule, Module * outModule);
@@ -18,6 +18,8 @@ AbletonLinkModule::AbletonLinkModule() :
 	play = moduleParams.addTrigger("Play", "Plays the playback");
 	stop = moduleParams.addTrigger("Stop", "Stops the playback");
 	beatStartsAt1 = moduleParams.addBoolParameter("Beats Start at 1", "If checked, this will make the first beat of a bar 1 instead or 0", true);
+	triggerLookahead = moduleParams.addFloatParameter("Trigger Lookahead", "Time in milliseconds to fire the beat and bar triggers before the actual beat, to compensate for the latency of what is triggered", 0, 0, 500);
+	updateRate = moduleParams.addIntParameter("Update Rate", "Number of times per second the beat values are updated. Beat and bar triggers are scheduled on the beat and don't depend on this rate", 50, 1, 500);
 
 	numPeers = valuesCC.addIntParameter("Peers", "Number of connected peers", 0, 0);
 	playState = valuesCC.addEnumParameter("Play State", "Is Live playing right now");
@@ -84,16 +86,7 @@ void AbletonLinkModule::onControllableFeedbackUpdateInternal(ControllableContain
 	Module::onControllableFeedbackUpdateInternal(cc, c);
 
 #if USE_ABLETONLINK
-	if (c == curBeat)
-	{
-		newBeat->trigger();
-		if (curBeat->intValue() == (beatStartsAt1->boolValue() ? 1 : 0))
-		{
-			newBar->trigger();
-			if ((int)playState->getValueData() == 1) playState->setValueWithData(2);
-		}
-	}
-	else if (c == bpm)
+	if (c == bpm)
 	{
 		if (link != nullptr)
 		{
@@ -121,22 +114,87 @@ void AbletonLinkModule::run()
 
 	jassert(link->isEnabled());
 
+	bool hasLastBeat = false;
+	int64 lastBeatIndex = 0;
+	std::chrono::microseconds nextUpdateTime = link->clock().micros();
+
 	while (!threadShouldExit())
 	{
-		wait(20); //50fps
+		const double q = jmax(1, quantum->intValue());
+		const std::chrono::microseconds lookahead((int64)(triggerLookahead->floatValue() * 1000));
+		const std::chrono::microseconds updateInterval(1000000 / jmax(1, updateRate->intValue()));
 
-		const auto time = link->clock().micros();
+		//everything is evaluated lookahead in advance, so triggers are fired this much before the actual beat
+		const auto now = link->clock().micros();
+		const auto time = now + lookahead;
 		const auto session = link->captureAppSessionState();
-		const auto beat = session.beatAtTime(time, quantum->intValue());
-		const auto phase = session.phaseAtTime(time, quantum->intValue());
+		const int64 beatIndex = (int64)std::floor(session.beatAtTime(time, q));
+
+		//fired once even if the thread woke up late, no beat is left behind.
+		//A timeline jumping backwards (tempo change, peer reset) only moves the reference, it's not a new beat
+		if (!hasLastBeat) hasLastBeat = true;
+		else if (beatIndex > lastBeatIndex) fireBeat(session, time);
 
-		curBeat->setValue(phase + (beatStartsAt1->boolValue() ? 1 : 0));
-		curBar->setValue(floor(beat / quantum->intValue()));
-		totalBeats->setValue(beat);
-		beatProgression->setValue(phase / quantum->intValue());
+		lastBeatIndex = beatIndex;
 
+		if (now >= nextUpdateTime)
+		{
+			updateBeatValues(session, time);
+			nextUpdateTime = now + updateInterval;
+		}
+
+		//sleep until the next beat or the next value update, whichever comes first. Only beats need the precise wait
+		const auto nextBeatTime = session.timeAtBeat((double)(beatIndex + 1), q) - lookahead;
+		if (nextBeatTime <= nextUpdateTime) waitUntil(nextBeatTime, true);
+		else waitUntil(nextUpdateTime, false);
 	}
 
 	link->enable(false);
 #endif
 }
+
+#if USE_ABLETONLINK
+void AbletonLinkModule::updateBeatValues(const ableton::Link::SessionState& session, std::chrono::microseconds time)
+{
+	const double q = jmax(1, quantum->intValue());
+	const double beat = session.beatAtTime(time, q);
+	const double phase = session.phaseAtTime(time, q);
+
+	curBeat->setValue((int)std::floor(phase) + (beatStartsAt1->boolValue() ? 1 : 0));
+	curBar->setValue(std::floor(beat / q));
+	totalBeats->setValue(beat);
+	beatProgression->setValue(phase / q);
+}
+
+void AbletonLinkModule::fireBeat(const ableton::Link::SessionState& session, std::chrono::microseconds time)
+{
+	updateBeatValues(session, time);
+
+	newBeat->trigger();
+
+	if ((int)std::floor(session.phaseAtTime(time, jmax(1, quantum->intValue()))) == 0)
+	{
+		newBar->trigger();
+		if ((int)playState->getValueData() == 1) playState->setValueWithData(2);
+	}
+}
+
+void AbletonLinkModule::waitUntil(std::chrono::microseconds deadline, bool precise)
+{
+	//wait() is not precise enough for beats, so beats only wait coarsely and yield for the last milliseconds
+	while (!threadShouldExit())
+	{
+		const int64 remaining = (deadline - link->clock().micros()).count();
+		if (remaining <= 0) return;
+
+		if (!precise)
+		{
+			wait(jmax(1, (int)(remaining / 1000)));
+			return;
+		}
+
+		if (remaining > 2000) wait((int)(remaining / 1000) - 1);
+		else Thread::yield();
+	}
+}
+#endif
\ No newline at end of file
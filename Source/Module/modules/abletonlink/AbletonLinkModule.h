@@ -32,6 +32,8 @@ public:
 	Trigger* play;
 	Trigger* stop;
 	BoolParameter* beatStartsAt1;
+	FloatParameter* triggerLookahead;
+	IntParameter* updateRate;
 
 	IntParameter* numPeers;
 	FloatParameter* bpm;
@@ -48,6 +50,10 @@ public:
 
 #if USE_ABLETONLINK
 	std::unique_ptr<ableton::Link> link;
+
+	void updateBeatValues(const ableton::Link::SessionState& session, std::chrono::microseconds time);
+	void fireBeat(const ableton::Link::SessionState& session, std::chrono::microseconds time);
+	void waitUntil(std::chrono::microseconds deadline, bool precise); //precise yields for the last milliseconds, only needed for beats
 #endif
 
 	void onContainerParameterChangedInternal(Parameter* p) override;
@@ -25,6 +25,7 @@ AudioModule::AudioModule(const String& name) :
 	ltcParamsCC("LTC"),
 	ltcCC("LTC"),
 	ltcFrameDropCount(0),
+	ltcSamplesWritten(0),
 	pitchDetector(nullptr)
 {
 	setupIOConfiguration(true, true);
@@ -297,6 +298,7 @@ void AudioModule::onControllableFeedbackUpdateInternal(ControllableContainer* cc
 	else if (c == ltcFPS)
 	{
 		curLTCFPS = (int)ltcFPS->getValueData();
+		ltcChaser.setFrameRate(curLTCFPS);
 	}
 	else if (c == ltcParamsCC.enabled)
 	{
@@ -435,7 +437,11 @@ void AudioModule::audioDeviceIOCallbackWithContext(const float* const* inputChan
 			int channel = ltcChannel->intValue() - 1;
 			if (channel >= 0 && channel < numInputChannels)
 			{
-				ltc_decoder_write_float(ltcDecoder.get(), (float*)inputChannelData[channel], numSamples, 0);
+				double hostTime = TimecodeChaser::getHostTime();
+
+				//give the absolute sample position so decoded frames can be timestamped precisely
+				ltc_decoder_write_float(ltcDecoder.get(), (float*)inputChannelData[channel], numSamples, ltcSamplesWritten);
+				ltcSamplesWritten += numSamples;
 
 				bool hasLTC = false;
 				LTCFrameExt frame;
@@ -444,7 +450,12 @@ void AudioModule::audioDeviceIOCallbackWithContext(const float* const* inputChan
 					SMPTETimecode stime;
 					ltc_frame_to_time(&stime, &frame.ltc, (ltcUseDate->boolValue() ? 1 : 0));
 
-					float time = stime.days * 3600 * 24 + stime.hours * 3600 + stime.mins * 60 + stime.secs + stime.frame * 1.0f / curLTCFPS;
+					double time = TimecodeChaser::getTimeForTimecode(stime.hours, stime.mins, stime.secs, stime.frame, curLTCFPS, frame.ltc.dfbit != 0, stime.days);
+
+					//a frame is fully decoded at its end, so the time at that moment is the frame time + 1 frame
+					double frameAge = currentSampleRate > 0 ? (ltcSamplesWritten - frame.off_end) / currentSampleRate : 0;
+					ltcChaser.pushSourceTime(time + 1.0 / curLTCFPS, hostTime - frameAge);
+
 					ltcTime->setValue(time);
 					hasLTC = true;
 				}
@@ -454,7 +465,11 @@ void AudioModule::audioDeviceIOCallbackWithContext(const float* const* inputChan
 					if (ltcPlaying->boolValue())
 					{
 						ltcFrameDropCount++;
-						if (ltcFrameDropCount >= 10) ltcPlaying->setValue(hasLTC);
+						if (ltcFrameDropCount >= 10)
+						{
+							ltcPlaying->setValue(hasLTC);
+							ltcChaser.reset();
+						}
 					}
 				}
 				else
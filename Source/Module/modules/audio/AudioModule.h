@@ -127,6 +127,8 @@ public:
 	BoolParameter* ltcPlaying;
 	FloatParameter* ltcTime;
 	int ltcFrameDropCount;
+	int64 ltcSamplesWritten;
+	TimecodeChaser ltcChaser; //filtered LTC time, used by sequences to chase
 
 	FFTAnalyzerManager analyzerManager;
 
@@ -12,7 +12,8 @@
 
 CustomOSCCommand::CustomOSCCommand(IOSCSenderModule* module, CommandContext context, var params, Multiplex* multiplex) :
 	OSCCommand(module, context, params, multiplex),
-	addressHasWildcards(false)
+	addressHasWildcards(false),
+	compiledAddress(compileAddress(address->stringValue()))
 {
 	//autoLoadPreviousCommandData = true;
 
@@ -34,85 +35,196 @@ void CustomOSCCommand::triggerInternal(int multiplexIndex)
 	if (oscModule == nullptr) return;
 
 	BaseCommand::triggerInternal(multiplexIndex);
-	String addrString = getLinkedValue(address, multiplexIndex);
 
-	if (addressHasWildcards)
+	CompiledAddress::Ptr compiled = getCompiledAddress();
+	String addrString = getAddressAt(multiplexIndex, isAddressConstant(), *compiled, getWildcardArguments(*compiled));
+
+	try
+	{
+		OSCMessage m(addrString);
+		addArgumentsToMessage(m, multiplexIndex, getArgumentBindings());
+		oscModule->sendOSC(m);
+	}
+	catch (const OSCFormatError&)
+	{
+		NLOGERROR("OSC", "Address is invalid :\n" << addrString << " addresses should always start with a forward slash");
+		return;
+	}
+}
+
+void CustomOSCCommand::triggerMultiplexRangeInternal(int startIndex, int endIndex)
+{
+	if (oscModule == nullptr) return;
+	if (endIndex - startIndex <= 1)
+	{
+		BaseCommand::triggerMultiplexRangeInternal(startIndex, endIndex);
+		return;
+	}
+
+	//everything that doesn't depend on the multiplex index is resolved once for the whole range
+	CompiledAddress::Ptr compiled = getCompiledAddress();
+	bool addressIsConstant = isAddressConstant();
+	Array<CustomValuesCommandArgument*> wildcardArgs = getWildcardArguments(*compiled);
+	Array<ArgumentBinding> bindings = getArgumentBindings();
+
+	Array<OSCMessage> messages;
+	messages.ensureStorageAllocated(endIndex - startIndex);
+
+	for (int i = startIndex; i < endIndex; i++)
 	{
-		for (auto& w : wildcardsMap)
+		String addrString = getAddressAt(i, addressIsConstant, *compiled, wildcardArgs);
+
+		try
 		{
-			if (CustomValuesCommandArgument* a = wildcardsContainer->getItemWithName(w, true, true))
-			{
-				addrString = addrString.replace("{" + w + "}", a->getLinkedValue(multiplexIndex).toString());
-			}
+			OSCMessage m(addrString);
+			addArgumentsToMessage(m, i, bindings);
+			messages.add(m);
+		}
+		catch (const OSCFormatError&)
+		{
+			NLOGERROR("OSC", "Address is invalid :\n" << addrString << " addresses should always start with a forward slash");
+			continue; //only this index is dropped, the rest of the range is still sent
 		}
 	}
 
-	try
+	if (messages.size() > 0) oscModule->sendOSCBatch(messages);
+}
+
+bool CustomOSCCommand::isAddressConstant()
+{
+	//the address only needs to be resolved per index if it is linked or uses link replacement tokens
+	if (ParameterLink* pLink = getLinkedParam(address))
 	{
-		OSCMessage m(addrString);
+		if (pLink->linkType != ParameterLink::NONE) return false;
+	}
 
-		for (auto& a : customValuesManager->items)
-		{
-			Parameter* p = a->param;
-			var pVal = a->getLinkedValue(multiplexIndex);
+	String addr = address->stringValue();
+	return !addr.contains("{index") && !addr.contains("{list:") && !addr.contains("{input:");
+}
 
-			if (p == nullptr) continue;
-			switch (p->type)
-			{
-			case Controllable::BOOL: OSCHelpers::addBoolArgumentToMessage(m, pVal, oscModule->getBoolMode()); break;
-			case Controllable::INT: m.addInt32((int)pVal); break;
-			case Controllable::FLOAT: m.addFloat32((float)pVal); break;
-			case Controllable::STRING: m.addString(pVal.toString()); break;
-			case Controllable::COLOR: OSCHelpers::addColorArgumentToMessage(m, Colour::fromFloatRGBA(pVal[0], pVal[1], pVal[2], pVal[3]), oscModule->getColorMode()); break;
-
-			case Controllable::POINT2D:
-				m.addFloat32(pVal[0]);
-				m.addFloat32(pVal[1]);
-				break;
-			case Controllable::POINT3D:
-				m.addFloat32(pVal[0]);
-				m.addFloat32(pVal[1]);
-				m.addFloat32(pVal[2]);
-				break;
-
-			default:
-				//not handle
-				break;
+Array<CustomValuesCommandArgument*> CustomOSCCommand::getWildcardArguments(const CompiledAddress& compiled)
+{
+	Array<CustomValuesCommandArgument*> result;
+	if (compiled.wildcards.isEmpty() || wildcardsContainer == nullptr) return result;
 
-			}
+	for (auto& w : compiled.wildcards) result.add(wildcardsContainer->getItemWithName(w, true, true));
+	return result;
+}
+
+Array<CustomOSCCommand::ArgumentBinding> CustomOSCCommand::getArgumentBindings()
+{
+	Array<ArgumentBinding> result;
+	for (auto& a : customValuesManager->items)
+	{
+		if (a->param == nullptr) continue;
+
+		bool isConstant = a->paramLink == nullptr || (a->paramLink->linkType == ParameterLink::NONE && a->param->type != Controllable::STRING);
+		result.add({ a, a->param, isConstant, isConstant ? a->param->getValue() : var() });
+	}
+
+	return result;
+}
+
+String CustomOSCCommand::getAddressAt(int multiplexIndex, bool addressIsConstant, const CompiledAddress& compiled, const Array<CustomValuesCommandArgument*>& wildcardArgs)
+{
+	if (addressIsConstant)
+	{
+		String result;
+		for (auto& t : compiled.tokens)
+		{
+			if (t.wildcardIndex < 0) result += t.text;
+			else if (CustomValuesCommandArgument* a = wildcardArgs[t.wildcardIndex]) result += a->getLinkedValue(multiplexIndex).toString();
+			else result += "{" + t.text + "}";
 		}
-		oscModule->sendOSC(m);
+
+		return result;
 	}
-	catch (const OSCFormatError&)
+
+	String result = getLinkedValue(address, multiplexIndex);
+	for (int i = 0; i < wildcardArgs.size(); i++)
 	{
-		NLOGERROR("OSC", "Address is invalid :\n" << addrString << " addresses should always start with a forward slash");
-		return;
+		if (CustomValuesCommandArgument* a = wildcardArgs[i]) result = result.replace("{" + compiled.wildcards[i] + "}", a->getLinkedValue(multiplexIndex).toString());
 	}
+
+	return result;
 }
 
-void CustomOSCCommand::updateWildcardsMap(const String& address)
+void CustomOSCCommand::addArgumentsToMessage(OSCMessage& m, int multiplexIndex, const Array<ArgumentBinding>& bindings)
 {
-	wildcardsMap.clear();
+	for (auto& b : bindings)
+	{
+		var pVal = b.isConstant ? b.constantValue : b.arg->getLinkedValue(multiplexIndex);
 
-	std::string s = address.toStdString();
-	std::regex source_regex("\\{(\\w+)\\}");
+		switch (b.param->type)
+		{
+		case Controllable::BOOL: OSCHelpers::addBoolArgumentToMessage(m, pVal, oscModule->getBoolMode()); break;
+		case Controllable::INT: m.addInt32((int)pVal); break;
+		case Controllable::FLOAT: m.addFloat32((float)pVal); break;
+		case Controllable::STRING: m.addString(pVal.toString()); break;
+		case Controllable::COLOR: OSCHelpers::addColorArgumentToMessage(m, Colour::fromFloatRGBA(pVal[0], pVal[1], pVal[2], pVal[3]), oscModule->getColorMode()); break;
+
+		case Controllable::POINT2D:
+			m.addFloat32(pVal[0]);
+			m.addFloat32(pVal[1]);
+			break;
+		case Controllable::POINT3D:
+			m.addFloat32(pVal[0]);
+			m.addFloat32(pVal[1]);
+			m.addFloat32(pVal[2]);
+			break;
 
-	auto source_begin = std::sregex_iterator(s.begin(), s.end(), source_regex);
-	auto source_end = std::sregex_iterator();
+		default:
+			//not handle
+			break;
 
-	if (std::distance(source_begin, source_end) == 0)
-	{
-		addressHasWildcards = false;
-		return;
+		}
 	}
+}
+
+CustomOSCCommand::CompiledAddress* CustomOSCCommand::compileAddress(const String& address)
+{
+	CompiledAddress* result = new CompiledAddress();
+	result->address = address;
 
-	for (std::sregex_iterator i = source_begin; i != source_end; ++i)
+	//look for {name} patterns, name being only letters, digits and underscores
+	int lastPos = 0;
+	int startPos = address.indexOfChar('{');
+	while (startPos >= 0)
 	{
-		std::smatch m = *i;
-		wildcardsMap.add(m[1].str());
+		int endPos = address.indexOfChar(startPos + 1, '}');
+		if (endPos < 0) break;
+
+		String w = address.substring(startPos + 1, endPos);
+		if (w.isNotEmpty() && w.containsOnly("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_"))
+		{
+			if (startPos > lastPos) result->tokens.add({ address.substring(lastPos, startPos), -1 });
+
+			int wIndex = result->wildcards.indexOf(w);
+			if (wIndex == -1)
+			{
+				wIndex = result->wildcards.size();
+				result->wildcards.add(w);
+			}
+
+			result->tokens.add({ w, wIndex });
+			lastPos = endPos + 1;
+			startPos = address.indexOfChar(lastPos, '{');
+		}
+		else
+		{
+			startPos = address.indexOfChar(startPos + 1, '{');
+		}
 	}
 
-	addressHasWildcards = wildcardsMap.size() > 0;
+	if (lastPos < address.length()) result->tokens.add({ address.substring(lastPos), -1 });
+
+	return result;
+}
+
+CustomOSCCommand::CompiledAddress::Ptr CustomOSCCommand::getCompiledAddress()
+{
+	SpinLock::ScopedLockType lock(compiledAddressLock);
+	return compiledAddress;
 }
 
 void CustomOSCCommand::onContainerParameterChanged(Parameter* p)
@@ -120,7 +232,13 @@ void CustomOSCCommand::onContainerParameterChanged(Parameter* p)
 	OSCCommand::onContainerParameterChanged(p);
 	if (p == address)
 	{
-		updateWildcardsMap(address->stringValue());
+		CompiledAddress::Ptr compiled = compileAddress(address->stringValue());
+		addressHasWildcards = compiled->wildcards.size() > 0;
+
+		{
+			SpinLock::ScopedLockType lock(compiledAddressLock);
+			std::swap(compiledAddress, compiled); //the previous one is released outside the lock
+		}
 
 		if (addressHasWildcards)
 		{
@@ -167,12 +285,12 @@ void CustomOSCCommand::itemsAdded(Array<CustomValuesCommandArgument*> items)
 	}
 }
 
-void CustomOSCCommand::updateMappingInputValue(var value, int multiplexIndex)
+void CustomOSCCommand::updateMappingInputValue(var value, int multiplexIndex, const BigInteger* changedComponents)
 {
-	OSCCommand::updateMappingInputValue(value, multiplexIndex);
+	OSCCommand::updateMappingInputValue(value, multiplexIndex, changedComponents);
 	if (wildcardsContainer != nullptr)
 	{
-		for (auto& a : wildcardsContainer->items) a->paramLink->updateMappingInputValue(value, multiplexIndex);
+		for (auto& a : wildcardsContainer->items) a->paramLink->updateMappingInputValue(value, multiplexIndex, changedComponents);
 	}
 }
 
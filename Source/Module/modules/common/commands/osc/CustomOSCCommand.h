@@ -22,18 +22,56 @@ public:
 	std::unique_ptr<CustomValuesCommandArgumentManager> wildcardsContainer;
 
 	bool addressHasWildcards;
-	Array<String> wildcardsMap;
+
+	//Address split in literal parts and wildcards, compiled only when the address parameter changes.
+	//Never modified once published, trigger threads keep a reference to the one they started with.
+	struct AddressToken
+	{
+		String text;
+		int wildcardIndex; //-1 for literal text, index in wildcards otherwise
+	};
+
+	class CompiledAddress :
+		public ReferenceCountedObject
+	{
+	public:
+		String address;
+		Array<String> wildcards;
+		Array<AddressToken> tokens;
+
+		typedef ReferenceCountedObjectPtr<CompiledAddress> Ptr;
+	};
+
+	SpinLock compiledAddressLock;
+	CompiledAddress::Ptr compiledAddress;
+
+	//Argument resolved once for a whole trigger, constant values are not re-evaluated for each multiplex index
+	struct ArgumentBinding
+	{
+		CustomValuesCommandArgument* arg;
+		Parameter* param;
+		bool isConstant;
+		var constantValue;
+	};
 
 	void triggerInternal(int multiplexIndex) override;
+	void triggerMultiplexRangeInternal(int startIndex, int endIndex) override;
+
+	static CompiledAddress* compileAddress(const String& address);
+	CompiledAddress::Ptr getCompiledAddress();
 
-	void updateWildcardsMap(const String& address);
+	bool isAddressConstant();
+	Array<CustomValuesCommandArgument*> getWildcardArguments(const CompiledAddress& compiled);
+	Array<ArgumentBinding> getArgumentBindings();
+	String getAddressAt(int multiplexIndex, bool addressIsConstant, const CompiledAddress& compiled, const Array<CustomValuesCommandArgument*>& wildcardArgs);
+	void addArgumentsToMessage(OSCMessage& m, int multiplexIndex, const Array<ArgumentBinding>& bindings);
 
 	virtual void onContainerParameterChanged(Parameter* p) override;
 
 	void itemAdded(CustomValuesCommandArgument* i) override;
 	void itemsAdded(Array<CustomValuesCommandArgument*> items) override;
 
-	void updateMappingInputValue(var value, int multiplexIndex) override;
+	void updateMappingInputValue(var value, int multiplexIndex, const BigInteger* changedComponents = nullptr) override;
 	void setInputNamesFromParams(Array<WeakReference<Parameter>> outParams) override;
 
 	var getJSONData(bool includeNonOverriden = false) override;
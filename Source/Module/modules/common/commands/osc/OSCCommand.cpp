@@ -135,10 +135,10 @@ void OSCCommand::onContainerParameterChanged(Parameter* p)
 	}
 }
 
-void OSCCommand::updateMappingInputValue(var value, int multiplexIndex)
+void OSCCommand::updateMappingInputValue(var value, int multiplexIndex, const BigInteger* changedComponents)
 {
-	BaseCommand::updateMappingInputValue(value, multiplexIndex);
-	for (auto& a : argumentsContainer.paramLinks) a->updateMappingInputValue(value, multiplexIndex);
+	BaseCommand::updateMappingInputValue(value, multiplexIndex, changedComponents);
+	for (auto& a : argumentsContainer.paramLinks) a->updateMappingInputValue(value, multiplexIndex, changedComponents);
 }
 
 void OSCCommand::setInputNamesFromParams(Array<WeakReference<Parameter>> outParams)
@@ -39,7 +39,7 @@ public:
 
 	void onContainerParameterChanged(Parameter * p) override;
 
-	virtual void updateMappingInputValue(var value, int multiplexIndex) override;
+	virtual void updateMappingInputValue(var value, int multiplexIndex, const BigInteger* changedComponents = nullptr) override;
 	virtual void setInputNamesFromParams(Array<WeakReference<Parameter>> outParams) override;
 
 	void triggerInternal(int multiplexIndex) override;
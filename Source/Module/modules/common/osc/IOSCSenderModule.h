@@ -17,6 +17,7 @@ public:
 
 
 	virtual void sendOSC(const OSCMessage& m) = 0;
+	virtual void sendOSCBatch(const Array<OSCMessage>& messages) { for (auto& m : messages) sendOSC(m); } //override to send multiple messages at once
 	virtual OSCHelpers::ColorMode getColorMode() { return OSCHelpers::ColorMode::ColorRGBA; }
 	virtual OSCHelpers::BoolMode getBoolMode() { return OSCHelpers::BoolMode::Int; }
 };
\ No newline at end of file
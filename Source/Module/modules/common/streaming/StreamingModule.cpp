@@ -299,13 +299,13 @@ void StreamingModule::processDataLine(const String& msg)
 	}
 }
 
-void StreamingModule::processDataBytes(Array<uint8_t> data)
+void StreamingModule::processDataBytes(const uint8* data, int numBytes)
 {
 	if (!enabled->boolValue()) return;
 	if (logIncomingData->boolValue())
 	{
-		String msg = String(data.size()) + "bytes received :";
-		for (auto& d : data) msg += "\n" + String(d);
+		String msg = String(numBytes) + "bytes received :";
+		for (int i = 0; i < numBytes; i++) msg += "\n" + String(data[i]);
 		NLOG(niceName, msg);
 	}
 
@@ -320,18 +320,18 @@ void StreamingModule::processDataBytes(Array<uint8_t> data)
 				if (!mt->enabled) continue;
 				if (StreamingModule* m = (StreamingModule*)(mt->targetContainer.get()))
 				{
-					m->sendBytes(data);
+					m->sendBytes(Array<uint8>(data, numBytes));
 				}
 			}
 		}
 	}
 
-	processDataBytesInternal(data);
+	processDataBytesInternal(data, numBytes);
 
 	if (scriptManager->items.size() > 0)
 	{
 		var args;
-		for (auto& d : data) args.append(d);
+		for (int i = 0; i < numBytes; i++) args.append(data[i]);
 		scriptManager->callFunctionOnAllItems(dataEventId, args);
 	}
 
@@ -342,7 +342,7 @@ void StreamingModule::processDataBytes(Array<uint8_t> data)
 	{
 	case RAW_1BYTE:
 	{
-		int numArgs = data.size();
+		int numArgs = numBytes;
 		if (autoAdd->boolValue())
 		{
 			int numValues = valuesCC.controllables.size();
@@ -371,7 +371,7 @@ void StreamingModule::processDataBytes(Array<uint8_t> data)
 
 	case RAW_FLOATS:
 	{
-		int numArgs = data.size() / 4;
+		int numArgs = numBytes / 4;
 
 		if (autoAdd->boolValue())
 		{
@@ -403,7 +403,7 @@ void StreamingModule::processDataBytes(Array<uint8_t> data)
 
 	case RAW_COLORS:
 	{
-		int numArgs = data.size() / 4;
+		int numArgs = numBytes / 4;
 
 		if (autoAdd->boolValue())
 		{
@@ -45,8 +45,9 @@ public:
 
 	virtual void processDataLine(const String& message);
 	virtual void processDataLineInternal(const String& message) {}
-	virtual void processDataBytes(Array<uint8> data);
-	virtual void processDataBytesInternal(Array<uint8> data) {}
+	void processDataBytes(Array<uint8> data) { processDataBytes(data.getRawDataPointer(), data.size()); }
+	virtual void processDataBytes(const uint8* data, int numBytes);
+	virtual void processDataBytesInternal(const uint8* data, int numBytes) {}
 	virtual void processDataJSON(const var& data);
 	virtual void processDataJSONInternal(const var& message) {}
 
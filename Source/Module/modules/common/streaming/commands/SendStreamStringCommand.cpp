@@ -74,7 +74,7 @@ SendStreamStringCommand::~SendStreamStringCommand()
 {
 }
 
-void SendStreamStringCommand::setValue(var value, int multiplexIndex)
+void SendStreamStringCommand::setValue(var value, int multiplexIndex, const BigInteger* changedComponents)
 {
 	switch (dataMode)
 	{
@@ -94,7 +94,7 @@ void SendStreamStringCommand::setValue(var value, int multiplexIndex)
 		break;
 	}
 
-	StreamingCommand::setValue(value, multiplexIndex);
+	StreamingCommand::setValue(value, multiplexIndex, changedComponents);
 }
 
 void SendStreamStringCommand::triggerInternal(int multiplexIndex)
@@ -28,7 +28,7 @@ public:
 	
 	Array<uint8> mappedValues;
 
-	void setValue(var value, int multiplexIndex) override;
+	void setValue(var value, int multiplexIndex, const BigInteger* changedComponents = nullptr) override;
 	void triggerInternal(int multiplexIndex) override;
 
 	static SendStreamStringCommand * create(ControllableContainer * module, CommandContext context, var params, Multiplex * multiplex) { return new SendStreamStringCommand((StreamingModule *)module, context, params, multiplex); }
@@ -23,6 +23,10 @@ GamepadModule::GamepadModule(const String& name) :
 	gamepadParam = new GamepadParameter("Device", "The Gamepad to connect to");
 	moduleParams.addParameter(gamepadParam);
 
+	updateRate = moduleParams.addIntParameter("Update Rate", "Maximum rate at which changes from the device are sent, in Hz. If multiple gamepad modules are used, the highest rate is used for all", 100, 1, 1000);
+
+	hysteresis = calibCC.addFloatParameter("Hysteresis", "Minimum change of an axis to update its value, to filter out noisy input. The center and the ends are always reached", 0, 0, .1f);
+
 	for (int i = 0; i < SDL_CONTROLLER_AXIS_MAX; ++i)
 	{
 		FloatParameter* f = axesCC.addFloatParameter(Gamepad::getAxisName(i), "", 0, -1, 1);
@@ -44,12 +48,17 @@ GamepadModule::GamepadModule(const String& name) :
 	valuesCC.addChildControllableContainer(&buttonsCC);
 
 	InputSystemManager::getInstance()->addInputManagerListener(this);
+	InputSystemManager::getInstance()->requestUpdateRate(this, updateRate->intValue());
 }
 
 GamepadModule::~GamepadModule()
 {
 	gamepadParam->setGamepad(nullptr);
-	if (InputSystemManager::getInstanceWithoutCreating() != nullptr) InputSystemManager::getInstance()->removeInputManagerListener(this);
+	if (InputSystemManager::getInstanceWithoutCreating() != nullptr)
+	{
+		InputSystemManager::getInstance()->removeInputManagerListener(this);
+		InputSystemManager::getInstance()->requestUpdateRate(this, 0);
+	}
 }
 
 void GamepadModule::setGamepad(Gamepad* g)
@@ -60,7 +69,11 @@ void GamepadModule::setGamepad(Gamepad* g)
 	gamepad = g;
 	gamepadRef = g;
 
-	if (gamepad != nullptr) gamepad->addGamepadListener(this);
+	if (gamepad != nullptr)
+	{
+		gamepad->addGamepadListener(this);
+		gamepad->sendAllValues();
+	}
 }
 
 void GamepadModule::gamepadAdded(Gamepad* g)
@@ -75,28 +88,39 @@ void GamepadModule::gamepadRemoved(Gamepad* g)
 	if (g == gamepad) gamepadParam->setGamepad(nullptr);
 }
 
-void GamepadModule::gamepadValuesUpdated(Array<float> axes, Array<bool> buttons)
+void GamepadModule::gamepadAxisChanged(Gamepad* g, int index, float value)
 {
-	for (int i = 0; i < axes.size() && i < axesCC.controllables.size(); ++i)
-	{
-		float axisValue = jmap<float>(axes[i], INT16_MIN, INT16_MAX, -1, 1) + axisOffset[i]->floatValue();
-		if (fabs(axisValue) < axisDeadzone[i]->floatValue()) axisValue = 0;
-		else
-		{
-			if (axisValue > 0) axisValue = jmap<float>(axisValue, axisDeadzone[i]->floatValue(), 1 + axisOffset[i]->floatValue(), 0, 1);
-			else axisValue = jmap<float>(axisValue, -1 + axisOffset[i]->floatValue(), -axisDeadzone[i]->floatValue(), -1, 0);
-		}
-		((FloatParameter*)axesCC.controllables[i])->setValue(axisValue);
-	}
+	if (index >= axesCC.controllables.size()) return;
 
-	for (int i = 0; i < SDL_CONTROLLER_BUTTON_MAX; ++i)
+	float axisValue = value + axisOffset[index]->floatValue();
+	if (fabs(axisValue) < axisDeadzone[index]->floatValue()) axisValue = 0;
+	else
 	{
-		((BoolParameter*)buttonsCC.controllables[i])->setValue(buttons[i]);
+		if (axisValue > 0) axisValue = jmap<float>(axisValue, axisDeadzone[index]->floatValue(), 1 + axisOffset[index]->floatValue(), 0, 1);
+		else axisValue = jmap<float>(axisValue, -1 + axisOffset[index]->floatValue(), -axisDeadzone[index]->floatValue(), -1, 0);
 	}
+
+	axisValue = jlimit<float>(-1, 1, axisValue);
+
+	FloatParameter* p = (FloatParameter*)axesCC.controllables[index];
+	if (axisValue != 0 && fabs(axisValue) < 1 && fabs(axisValue - p->floatValue()) < hysteresis->floatValue()) return;
+
+	p->setValue(axisValue);
+}
+
+void GamepadModule::gamepadButtonChanged(Gamepad* g, int index, bool value)
+{
+	if (index >= buttonsCC.controllables.size()) return;
+	((BoolParameter*)buttonsCC.controllables[index])->setValue(value);
 }
 
 void GamepadModule::onControllableFeedbackUpdateInternal(ControllableContainer* cc, Controllable* c)
 {
 	Module::onControllableFeedbackUpdateInternal(cc, c);
 	if (c == gamepadParam) setGamepad(gamepadParam->gamepad);
+	else if (c == updateRate) InputSystemManager::getInstance()->requestUpdateRate(this, updateRate->intValue());
+	else if (c->parentContainer.get() == &calibCC)
+	{
+		if (gamepad != nullptr && !gamepadRef.wasObjectDeleted()) gamepad->sendAllValues(); //values are only sent on change, apply the new calibration now
+	}
 }
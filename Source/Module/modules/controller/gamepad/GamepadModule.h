@@ -26,7 +26,10 @@ public:
 	ControllableContainer axesCC;
 	ControllableContainer buttonsCC;
 
+	IntParameter* updateRate;
+
 	ControllableContainer calibCC;
+	FloatParameter* hysteresis;
 	Array<FloatParameter*> axisOffset;
 	Array<FloatParameter*> axisDeadzone;
 	
@@ -37,7 +40,8 @@ public:
 	void gamepadAdded(Gamepad *) override;
 	void gamepadRemoved(Gamepad *) override;
 
-	void gamepadValuesUpdated(Array<float> axes, Array<bool> buttons) override;
+	void gamepadAxisChanged(Gamepad* g, int index, float value) override;
+	void gamepadButtonChanged(Gamepad* g, int index, bool value) override;
 
 	void onControllableFeedbackUpdateInternal(ControllableContainer * cc, Controllable * c) override;
 
@@ -31,6 +31,11 @@ LoupedeckModule::LoupedeckModule() :
 	streamingType->setValueWithData(RAW);
 	streamingType->hideInEditor = true;
 
+	//websocket frames are parsed from the chunks as they come
+	receiveBatchSize->hideInEditor = true;
+	frameLength->hideInEditor = true;
+	receiveMaxLatency->hideInEditor = true;
+
 	autoAdd->hideInEditor = true;
 	autoAdd->setValue(false);
 
@@ -208,11 +213,11 @@ Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\n\n";
 	//});
 }
 
-void LoupedeckModule::processDataBytesInternal(Array<uint8> bytes)
+void LoupedeckModule::processDataBytesInternal(const uint8* bytes, int numBytes)
 {
 	if (wsMode == HANDSHAKE)
 	{
-		String msg = String::createStringFromData((const char*)bytes.getRawDataPointer(), bytes.size());
+		String msg = String::createStringFromData((const char*)bytes, numBytes);
 		if (msg.contains("\r\n\r\n"))
 		{
 			NLOG(niceName, "Handshake received, Loupedeck in da platz.");
@@ -229,16 +234,17 @@ void LoupedeckModule::processDataBytesInternal(Array<uint8> bytes)
 	}
 
 	if (!enabled->boolValue()) return;
-	if (bytes.size() < 2) return;
+	if (numBytes < 2) return;
 
 	if (bytes[0] == 130)
 	{
-		bytes.remove(0);
-		expectedLength = bytes.removeAndReturn(0);
+		expectedLength = bytes[1];
+		bytes += 2;
+		numBytes -= 2;
 		buffer.clear();
 	}
 
-	buffer.addArray(bytes.getRawDataPointer(), jmin<int>(bytes.size(), expectedLength - buffer.size()));
+	buffer.addArray(bytes, jmin<int>(numBytes, expectedLength - buffer.size()));
 
 	if (buffer.size() == 0 || buffer.size() < expectedLength) return;
 
@@ -94,7 +94,7 @@ public:
     void setupPortInternal() override;
     void portOpenedInternal() override;
 
-    void processDataBytesInternal(Array<uint8> data) override;
+    void processDataBytesInternal(const uint8* data, int numBytes) override;
 
     void processTouchData(Array<uint8_t> data);
 
@@ -22,23 +22,43 @@ StreamDeck::StreamDeck(hid_device* device, String serialNumber, Model model, int
 	iconSize(iconSize),
 	keyDataOffset(keyDataOffset),
 	imagePacketLength(0),
-	imageHeaderLength(0)
+	imageHeaderLength(0),
+	encoderThread(this),
+	frameIntervalMS(33)
 {
 
 	if (device != nullptr) hid_set_nonblocking(device, 1);
-	for (int i = 0; i < numKeys; ++i) buttonStates.add(false);
+	for (int i = 0; i < numKeys; ++i)
+	{
+		buttonStates.add(false);
+		pendingContents.add(KeyContent());
+		pendingKeys.add(false);
+		sentHashes.add(0);
+	}
 
 	startThread();
+	encoderThread.startThread();
 }
 
 StreamDeck::~StreamDeck()
 {
+	shutdown();
+}
+
+void StreamDeck::shutdown()
+{
+	//must be called by the model destructors, the threads use the model's virtual functions
+	encoderThread.stopThread(500);
 	stopThread(500);
 }
 
 void StreamDeck::reset()
 {
 	sendFeatureReport(resetData.getRawDataPointer(), resetData.size());
+
+	//the device is now blank, force all keys to be sent again
+	GenericScopedLock lock(pendingLock);
+	sentHashes.fill(0);
 }
 
 void StreamDeck::setBrightness(float brightness)
@@ -47,48 +67,135 @@ void StreamDeck::setBrightness(float brightness)
 	sendFeatureReport(brightnessData.getRawDataPointer(), brightnessData.size());
 }
 
+void StreamDeck::setUpdateRate(float framesPerSecond)
+{
+	frameIntervalMS = framesPerSecond > 0 ? jmax(1, (int)(1000 / framesPerSecond)) : 0;
+}
+
 void StreamDeck::setColor(int row, int column, Colour color, bool highlight, const String& overlayText, int textSize)
 {
-	if (highlight) color = color.brighter(1);
-	//const int numPixels = iconSize * iconSize;
-	Image iconImage(Image::RGB, iconSize, iconSize, true);
-	Graphics g(iconImage);
-	g.setColour(color);
-	g.fillAll();
+	KeyContent content;
+	content.color = color;
+	content.highlight = highlight;
+	content.text = overlayText;
+	content.textSize = textSize;
+	queueKeyContent(row, column, content);
+}
+
+void StreamDeck::setImage(int row, int column, Image image, bool highlight, const String& overlayText, int textSize)
+{
+	setImage(row, column, image, Colours::black, highlight, overlayText, textSize);
+}
+
+void StreamDeck::setImage(int row, int column, Image image, Colour tint, bool highlight, const String& overlayText, int textSize)
+{
+	KeyContent content;
+	content.isImage = true;
+	content.image = image;
+	content.color = tint;
+	content.highlight = highlight;
+	content.text = overlayText;
+	content.textSize = textSize;
+	queueKeyContent(row, column, content);
+}
 
-	if (overlayText.isNotEmpty())
+void StreamDeck::queueKeyContent(int row, int column, const KeyContent& content)
+{
+	int keyIndex = row * numColumns + column;
+	if (keyIndex < 0 || keyIndex >= numKeys) return;
+
+	//hashing an image reads all its pixels, so it's left to the encoder thread
 	{
-		g.setColour(color.getPerceivedBrightness() > .5f ? Colours::black : Colours::white);
-		g.setFont(textSize);
-		g.drawFittedText(overlayText, g.getClipBounds().reduced(2), Justification::centred, 5);
+		GenericScopedLock lock(pendingLock);
+		pendingContents.set(keyIndex, content);
+		pendingKeys.set(keyIndex, true);
 	}
 
-	sendButtonImageData(row, column, iconImage);
+	encoderThread.notify();
 }
 
-void StreamDeck::setImage(int row, int column, Image image, bool highlight, const String& overlayText, int textSize)
+void StreamDeck::processPendingKeys()
 {
-	setImage(row, column, image, Colours::black, highlight, overlayText, textSize);
+	Array<KeyContent> contents;
+	Array<int> keys;
+
+	{
+		GenericScopedLock lock(pendingLock);
+		for (int i = 0; i < numKeys; i++)
+		{
+			if (!pendingKeys[i]) continue;
+			keys.add(i);
+			contents.add(pendingContents[i]);
+			pendingKeys.set(i, false);
+			pendingContents.set(i, KeyContent()); //release the image
+		}
+	}
+
+	for (int i = 0; i < keys.size(); i++)
+	{
+		if (encoderThread.threadShouldExit() || Engine::mainEngine->isClearing) return;
+
+		KeyContent& c = contents.getReference(i);
+		c.computeHash();
+
+		{
+			//already displayed, no need to render or send again
+			GenericScopedLock lock(pendingLock);
+			if (sentHashes[keys[i]] == c.hash) continue;
+		}
+
+		if (!encodedCache.contains(c.hash))
+		{
+			if (encodedCache.size() >= maxCachedImages) encodedCache.clear();
+
+			Image img = renderKeyContent(c);
+			MemoryBlock encoded;
+			encodeButtonImage(img, encoded);
+			encodedCache.set(c.hash, encoded);
+		}
+
+		writeButtonData(keys[i], encodedCache.getReference(c.hash));
+
+		GenericScopedLock lock(pendingLock);
+		sentHashes.set(keys[i], c.hash);
+	}
 }
 
-void StreamDeck::setImage(int row, int column, Image image, Colour tint, bool highlight, const String& overlayText, int textSize)
+Image StreamDeck::renderKeyContent(const KeyContent& content)
 {
 	Image iconImage(Image::RGB, iconSize, iconSize, true);
 	Graphics g(iconImage);
-	g.setColour(Colours::black);
-	g.fillAll();
-	g.drawImage(image, g.getClipBounds().toFloat());
-	g.setColour(tint.withMultipliedAlpha(.5f).brighter((float)highlight));
-	g.fillAll();
 
-	if (overlayText.isNotEmpty())
+	if (content.isImage)
+	{
+		g.setColour(Colours::black);
+		g.fillAll();
+		g.drawImage(content.image, g.getClipBounds().toFloat());
+		g.setColour(content.color.withMultipliedAlpha(.5f).brighter((float)content.highlight));
+		g.fillAll();
+
+		if (content.text.isNotEmpty())
+		{
+			g.setColour(content.color.getPerceivedBrightness() > .5f ? Colours::black : Colours::white);
+			g.setFont(content.textSize);
+			g.drawFittedText(content.text, g.getClipBounds().reduced(5), Justification::centred, 5);
+		}
+	}
+	else
 	{
-		g.setColour(tint.getPerceivedBrightness() > .5f ? Colours::black : Colours::white);
-		g.setFont(textSize);
-		g.drawFittedText(overlayText, g.getClipBounds().reduced(5), Justification::centred, 5);
+		Colour color = content.highlight ? content.color.brighter(1) : content.color;
+		g.setColour(color);
+		g.fillAll();
+
+		if (content.text.isNotEmpty())
+		{
+			g.setColour(color.getPerceivedBrightness() > .5f ? Colours::black : Colours::white);
+			g.setFont(content.textSize);
+			g.drawFittedText(content.text, g.getClipBounds().reduced(2), Justification::centred, 5);
+		}
 	}
 
-	sendButtonImageData(row, column, iconImage);
+	return iconImage;
 }
 
 void StreamDeck::writeImageData(MemoryOutputStream& stream, Image& img)
@@ -97,19 +204,27 @@ void StreamDeck::writeImageData(MemoryOutputStream& stream, Image& img)
 	stream.write(bitmapData.data, getIconBytes());
 }
 
-
 void StreamDeck::sendButtonImageData(int row, int column, Image& img)
+{
+	MemoryBlock data;
+	encodeButtonImage(img, data);
+	writeButtonData(row * numColumns + column, data);
+}
+
+void StreamDeck::encodeButtonImage(Image& img, MemoryBlock& dest)
+{
+	MemoryOutputStream stream(dest, false);
+	writeImageData(stream, img);
+}
+
+void StreamDeck::writeButtonData(int keyIndex, const MemoryBlock& data)
 {
 	if (Engine::mainEngine->isClearing) return;
 
-	writeLock.enter();
-	MemoryOutputStream imageData;
-	writeImageData(imageData, img);
+	GenericScopedLock lock(writeLock);
 
 	const int payload = imagePacketLength - imageHeaderLength;
-	int remainingBytes = (int)imageData.getDataSize();
-
-	int buttonID = row * numColumns + column;
+	int remainingBytes = (int)data.getSize();
 	int byteOffset = 0;
 
 	for (int part = 0; remainingBytes > 0; part++)
@@ -118,18 +233,22 @@ void StreamDeck::sendButtonImageData(int row, int column, Image& img)
 
 		int numPartBytes = jmin(remainingBytes, payload);
 
-		writeImageDataHeader(partStream, buttonID, part, remainingBytes <= imagePacketLength, numPartBytes);
+		writeImageDataHeader(partStream, keyIndex, part, remainingBytes <= payload, numPartBytes);
 
-		partStream.write((uint8*)imageData.getData() + byteOffset, numPartBytes);
+		partStream.write((uint8*)data.getData() + byteOffset, numPartBytes);
 		partStream.writeRepeatedByte(0, imagePacketLength - partStream.getDataSize());
 
-		hid_write(device, (unsigned char*)partStream.getData(), imagePacketLength);
+		writeReport((unsigned char*)partStream.getData(), imagePacketLength);
 
 		byteOffset += numPartBytes;
 		remainingBytes -= numPartBytes;
 	}
+}
 
-	writeLock.exit();
+int StreamDeck::writeReport(const unsigned char* data, size_t length)
+{
+	if (device == nullptr) return -1;
+	return hid_write(device, data, length);
 }
 
 void StreamDeck::sendFeatureReport(const uint8_t* data, int length)
@@ -191,3 +310,51 @@ void StreamDeck::run()
 		wait(20);
 	}
 }
+
+void StreamDeck::KeyContent::computeHash()
+{
+	//hash the pixels themselves, the pixel data pointer can be reused by a different image once the previous one is freed
+	uint64 h = 14695981039346656037ull;
+	if (isImage && image.isValid())
+	{
+		Image::BitmapData data(image, Image::BitmapData::readOnly);
+		h = (h ^ (uint64)data.width) * 1099511628211ull;
+		h = (h ^ (uint64)data.height) * 1099511628211ull;
+		h = (h ^ (uint64)data.pixelFormat) * 1099511628211ull;
+
+		const int lineBytes = data.width * data.pixelStride;
+		for (int y = 0; y < data.height; y++)
+		{
+			const uint8* line = data.getLinePointer(y);
+			for (int x = 0; x < lineBytes; x++) h = (h ^ line[x]) * 1099511628211ull;
+		}
+	}
+
+	hash = (int64)h;
+	hash = hash * 31 + (int64)color.getARGB();
+	hash = hash * 31 + (highlight ? 1 : 0);
+	hash = hash * 31 + textSize;
+	hash = hash * 31 + text.hashCode64();
+	hash = hash * 31 + (isImage ? 1 : 2);
+}
+
+StreamDeck::EncoderThread::EncoderThread(StreamDeck* deck) :
+	Thread("StreamDeck Encoder"),
+	deck(deck)
+{
+}
+
+void StreamDeck::EncoderThread::run()
+{
+	while (!threadShouldExit())
+	{
+		wait(100); //woken up by new key requests
+
+		uint32 frameStart = Time::getMillisecondCounter();
+		deck->processPendingKeys();
+
+		//pace writes to the device frame budget, requests coming in the meantime are coalesced
+		int remaining = deck->frameIntervalMS - (int)(Time::getMillisecondCounter() - frameStart);
+		if (remaining > 0 && !threadShouldExit()) sleep(remaining);
+	}
+}
@@ -24,6 +24,8 @@ public:
 	StreamDeck(hid_device* device, String serialNumber, Model model, int numColumns, int numRows, bool invertX, int iconSize, int keyDataOffset);
 	virtual ~StreamDeck();
 
+	void shutdown(); //stops the reader and encoder threads, called from the model destructors before they're destroyed
+
 	Model model;
 	hid_device* device;
 	String serialNumber;
@@ -46,10 +48,48 @@ public:
 	Array<bool> buttonStates;
 	SpinLock writeLock;
 
+	//Key rendering, done asynchronously by the encoder thread
+	struct KeyContent
+	{
+		bool isImage = false;
+		Image image;
+		Colour color;
+		bool highlight = false;
+		String text;
+		int textSize = 10;
+		int64 hash = 0;
+
+		void computeHash();
+	};
+
+	class EncoderThread :
+		public Thread
+	{
+	public:
+		EncoderThread(StreamDeck* deck);
+		~EncoderThread() {}
+
+		StreamDeck* deck;
+		void run() override;
+	};
+
+	EncoderThread encoderThread;
+	int frameIntervalMS; //minimum time between two device frames, pending key updates are sent once per frame
+
+	CriticalSection pendingLock;
+	Array<KeyContent> pendingContents; //latest requested content for each key, older pending requests are overwritten
+	Array<bool> pendingKeys;
+	Array<int64> sentHashes; //hash of what is currently displayed on each key
+
+	HashMap<int64, MemoryBlock> encodedCache; //only accessed from the encoder thread
+	const int maxCachedImages = 512;
+
 	void reset();
 	void setBrightness(float brightness);
 	virtual void setBrightnessInternal(float brightness) {}
 
+	void setUpdateRate(float framesPerSecond);
+
 	virtual void setColor(int row, int column, Colour color, bool highlight, const String& overlayText = "", int textSize = 10);
 	virtual void setImage(int row, int column, Image image, bool highlight, const String& overlayText = "", int textSize = 10);
 	virtual void setImage(int row, int column, Image image, Colour tint, bool highlight, const String& overlayText = "", int textSize = 10);
@@ -57,10 +97,17 @@ public:
 
 	int getIconBytes() const { return iconSize * iconSize * 3; }
 
+	void queueKeyContent(int row, int column, const KeyContent& content);
+	void processPendingKeys();
+	Image renderKeyContent(const KeyContent& content);
+
 	virtual void sendButtonImageData(int row, int column, Image& img);
+	virtual void encodeButtonImage(Image& img, MemoryBlock& dest);
+	virtual void writeButtonData(int keyIndex, const MemoryBlock& data);
 	virtual void writeImageDataHeader(MemoryOutputStream& stream, int keyIndex, int partIndex, bool isLast, int bodyLength) {}
 	virtual void writeImageData(MemoryOutputStream& stream, Image& img);
 
+	virtual int writeReport(const unsigned char* data, size_t length); //override to use a stand-in writer instead of the HID device
 	virtual void sendFeatureReport(const uint8_t* data, int length);
 
 	void run() override;
@@ -46,6 +46,7 @@ StreamDeckModule::StreamDeckModule(const String& name) :
 
 	brightness = moduleParams.addFloatParameter("Brightness", "Sets the brigthness of the deck's backlight", .75f, 0, 1);
 	textSize = moduleParams.addIntParameter("Text size", "Sets the size of the text on the buttons", 10, 1, 50);
+	updateRate = moduleParams.addFloatParameter("Update Rate", "Maximum number of times per second the buttons are sent to the device. Changes happening in between are merged and only the latest one is sent.", 30, 1, 100);
 
 	reset = moduleParams.addTrigger("Reset", "Resets the stream deck");
 	colorizeImages = moduleParams.addBoolParameter("Colorize images", "If checked, this will use both colors and images to set buttons", false);
@@ -190,6 +191,7 @@ void StreamDeckModule::setDevice(StreamDeck* newDevice)
 	{
 		device->addStreamDeckListener(this);
 		device->setBrightness(brightness->floatValue());
+		device->setUpdateRate(updateRate->floatValue());
 
 		switch (device->model)
 		{
@@ -364,6 +366,10 @@ void StreamDeckModule::onControllableFeedbackUpdateInternal(ControllableContaine
 	{
 		device->setBrightness(brightness->floatValue());
 	}
+	else if (c == updateRate)
+	{
+		device->setUpdateRate(updateRate->floatValue());
+	}
 	else if (c->parentContainer->parentContainer == &colorsCC)
 	{
 		int row = colorsCC.controllableContainers.indexOf(c->parentContainer);
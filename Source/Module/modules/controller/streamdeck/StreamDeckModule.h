@@ -39,6 +39,7 @@ public:
 
 	FloatParameter* brightness;
 	IntParameter* textSize;
+	FloatParameter* updateRate;
 
 	ControllableContainer colorsCC;
 	OwnedArray<Array<ColorParameter*>> colors;
@@ -42,42 +42,36 @@ StreamDeckMini::StreamDeckMini(hid_device* device, String serialNumber) :
 
 StreamDeckMini::~StreamDeckMini()
 {
+	shutdown();
 }
 
-void StreamDeckMini::sendButtonImageData(int row, int column, Image& img)
+void StreamDeckMini::writeButtonData(int keyIndex, const MemoryBlock& data)
 {
-	writeLock.enter();
+	if (data.getSize() < PACKET1_PIXELS_BYTES + PACKET2_PIXELS_BYTES) return;
 
-	int buttonID = row * column + column;
+	GenericScopedLock lock(writeLock);
 
-	Image::BitmapData bitmapData(img, Image::BitmapData::ReadWriteMode::readOnly);
+	const uint8* pixels = (const uint8*)data.getData();
 
-	MemoryOutputStream block;
-
-	page1Header.set(5, buttonID + 1);
-	page2Header.set(5, buttonID + 1);
+	page1Header.set(5, keyIndex + 1);
+	page2Header.set(5, keyIndex + 1);
 
 	MemoryBlock packet1;
 	packet1.ensureSize(PACKET_SIZE, true);
 	packet1.copyFrom(page1Header.getRawDataPointer(), 0, PACKET1_HEADER_SIZE);
-	packet1.copyFrom(bitmapData.data, page1Header.size(), PACKET1_PIXELS_BYTES);
+	packet1.copyFrom(pixels, page1Header.size(), PACKET1_PIXELS_BYTES);
 
 	MemoryBlock packet2;
 	packet2.ensureSize(PACKET_SIZE, true);
 	packet2.copyFrom(page2Header.getRawDataPointer(), 0, PACKET2_HEADER_SIZE);
-	packet2.copyFrom(bitmapData.data + PACKET1_PIXELS_BYTES, PACKET2_HEADER_SIZE, PACKET2_PIXELS_BYTES);
+	packet2.copyFrom(pixels + PACKET1_PIXELS_BYTES, PACKET2_HEADER_SIZE, PACKET2_PIXELS_BYTES);
 
-	if (device != nullptr)
+	try {
+		writeReport((unsigned char*)packet1.getData(), PACKET_SIZE);
+		writeReport((unsigned char*)packet2.getData(), PACKET_SIZE);
+	}
+	catch (std::exception e)
 	{
-		try {
-			hid_write(device, (unsigned char*)packet1.getData(), PACKET_SIZE);
-			hid_write(device, (unsigned char*)packet2.getData(), PACKET_SIZE);
-		}
-		catch (std::exception e)
-		{
-			NLOGERROR("StreamDeck", "Error write image to device");
-		}
+		NLOGERROR("StreamDeck", "Error write image to device");
 	}
-
-	writeLock.exit();
 }
\ No newline at end of file
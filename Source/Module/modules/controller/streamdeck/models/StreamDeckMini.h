@@ -17,5 +17,5 @@ public:
 	StreamDeckMini(hid_device* device, String serialNumbe);
 	~StreamDeckMini();
 
-	virtual void sendButtonImageData(int row, int column, Image& img) override;
+	virtual void writeButtonData(int keyIndex, const MemoryBlock& data) override;
 };
\ No newline at end of file
@@ -18,6 +18,6 @@ public:
 	~StreamDeckV1();
 
 	// Inherited via StreamDeck
-	virtual void sendButtonImageData(int row, int column, Image& img) override;
+	virtual void writeButtonData(int keyIndex, const MemoryBlock& data) override;
 };
 
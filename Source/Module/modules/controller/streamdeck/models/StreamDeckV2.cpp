@@ -32,6 +32,7 @@ StreamDeckV2::StreamDeckV2(hid_device* device, String serialNumber) :
 
 StreamDeckV2::~StreamDeckV2()
 {
+	shutdown();
 }
 
 void StreamDeckV2::setBrightnessInternal(float brightness)
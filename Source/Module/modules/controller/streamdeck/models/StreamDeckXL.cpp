@@ -32,6 +32,7 @@ StreamDeckXL::StreamDeckXL(hid_device* device, String serialNumber) :
 
 StreamDeckXL::~StreamDeckXL()
 {
+	shutdown();
 }
 
 void StreamDeckXL::setBrightnessInternal(float brightness)
@@ -246,11 +246,11 @@ void DMXModule::send16BitDMXRange(DMXUniverse* u, int startChannel, Array<int> v
 	}
 }
 
-void DMXModule::sendFromPassTrough(int net, int subnet, int universe, /*int priority,*/ Array<uint8> values)
+void DMXModule::sendFromPassTrough(int net, int subnet, int universe, /*int priority,*/ const uint8* values, int numValues)
 {
 	if (!enabled->boolValue()) return;
 	if (dmxDevice == nullptr) return;
-	dmxDevice->sendDMXValues(net, subnet, universe,/* priority,*/ values.getRawDataPointer(), values.size());
+	dmxDevice->sendDMXValues(net, subnet, universe,/* priority,*/ (uint8*)values, numValues);
 	outActivityTrigger->trigger();
 	if (logOutgoingData->boolValue()) NLOG(niceName, "Send DMX from pass-through to Net " << net << ", Subnet " << subnet << ", Universe " << universe);
 }
@@ -420,6 +420,12 @@ void DMXModule::dmxDeviceSetupChanged(DMXDevice*)
 
 }
 void DMXModule::dmxDataInChanged(DMXDevice*, int net, int subnet, int universe, /*int priority,*/ Array<uint8> values, const String& sourceName)
+{
+	//the by-value array is imposed by the DMXDevice listener interface, everything after this works on its buffer
+	processDMXIn(net, subnet, universe, values.getRawDataPointer(), values.size(), sourceName);
+}
+
+void DMXModule::processDMXIn(int net, int subnet, int universe, const uint8* values, int numValues, const String& sourceName)
 {
 	if (isClearing || !enabled->boolValue()) return;
 	if (logIncomingData->boolValue())
@@ -441,7 +447,8 @@ void DMXModule::dmxDataInChanged(DMXDevice*, int net, int subnet, int universe,
 				if (!mt->enabled) continue;
 				if (DMXModule* m = (DMXModule*)(mt->targetContainer.get()))
 				{
-					m->sendFromPassTrough(net, subnet, universe,/* priority,*/ values);
+					//receivers expect full frames at the source rate, so pass-through forwards every frame as is
+					m->sendFromPassTrough(net, subnet, universe,/* priority,*/ values, numValues);
 				}
 			}
 		}
@@ -450,21 +457,98 @@ void DMXModule::dmxDataInChanged(DMXDevice*, int net, int subnet, int universe,
 	DMXUniverse* u = getUniverse(true, net, subnet, universe, autoAdd->boolValue());
 	if (u == nullptr) return;
 
-	u->updateValues(values);
+	InputShadow* shadow = getInputShadow(net, subnet, universe);
+	if (shadow->universe != u)
+	{
+		shadow->universe = u;
+		shadow->hasData = false;
+	}
+
+	if (!computeChangedChannels(shadow, values, numValues)) return;
+
+	numValues = jmin(numValues, DMX_NUM_CHANNELS);
+	for (int i = 0; i < numValues; i++)
+	{
+		if (shadow->changedMask[i]) u->updateValue(i, values[i]);
+	}
 
-	if (scriptManager->items.size() > 0)
+	if (hasScriptCallback(dmxEventId))
 	{
+		//the same array is kept between packets, and fully refreshed from the shadow since scripts may have modified it
+		//and changes received while there was no handler were not written. Assigning ints to it doesn't allocate
+		if (!shadow->scriptData.isArray() || shadow->scriptData.size() != numValues)
+		{
+			Array<var> data;
+			data.resize(numValues);
+			shadow->scriptData = data;
+		}
+
+		Array<var>* data = shadow->scriptData.getArray();
+		for (int i = 0; i < numValues; i++) data->getReference(i) = (int)shadow->values[i];
+
 		Array<var> args;
 		args.add(net);
 		args.add(subnet);
 		args.add(universe);
-		var data;
-		for (auto& v : values) data.append(v);
-		args.add(data);
+		args.add(shadow->scriptData);
 		scriptManager->callFunctionOnAllItems(dmxEventId, args);
 	}
 }
 
+DMXModule::InputShadow* DMXModule::getInputShadow(int net, int subnet, int universe)
+{
+	int64 key = ((int64)(net & 0xFFFF) << 32) | ((int64)(subnet & 0xFFFF) << 16) | (int64)(universe & 0xFFFF);
+	if (InputShadow* s = inputShadowMap[key]) return s;
+
+	InputShadow* s = inputShadows.add(new InputShadow());
+	inputShadowMap.set(key, s);
+	return s;
+}
+
+bool DMXModule::computeChangedChannels(InputShadow* shadow, const uint8* values, int numValues)
+{
+	numValues = jmin(numValues, DMX_NUM_CHANNELS);
+
+	if (!shadow->hasData)
+	{
+		memcpy(shadow->values, values, numValues);
+		memset(shadow->changedMask, 0, sizeof(shadow->changedMask));
+		for (int i = 0; i < numValues; i++) shadow->changedMask[i] = true;
+		shadow->hasData = true;
+		return true;
+	}
+
+	memset(shadow->changedMask, 0, sizeof(shadow->changedMask));
+	bool changed = false;
+
+	//compare 8 channels at a time, most packets only change a few channels
+	int i = 0;
+	for (; i + 8 <= numValues; i += 8)
+	{
+		uint64 a, b;
+		memcpy(&a, shadow->values + i, 8);
+		memcpy(&b, values + i, 8);
+		if (a == b) continue;
+
+		for (int j = i; j < i + 8; j++)
+		{
+			if (shadow->values[j] != values[j]) shadow->changedMask[j] = true;
+		}
+		memcpy(shadow->values + i, values + i, 8);
+		changed = true;
+	}
+
+	for (; i < numValues; i++)
+	{
+		if (shadow->values[i] == values[i]) continue;
+		shadow->changedMask[i] = true;
+		shadow->values[i] = values[i];
+		changed = true;
+	}
+
+	return changed;
+}
+
 DMXUniverse* DMXModule::getUniverse(bool isInput, int net, int subnet, int universe,/* int priority, */bool createIfNotThere)
 {
 	DMXUniverseManager* m = isInput ? &inputUniverseManager : &outputUniverseManager;
@@ -43,6 +43,22 @@ public:
 	DMXUniverseManager inputUniverseManager;
 	DMXUniverseManager outputUniverseManager;
 
+	//Last received values for each input universe, so only changed channels are dispatched
+	struct InputShadow
+	{
+		DMXUniverse* universe = nullptr; //universe the values were dispatched to, a new universe gets the full frame
+		bool hasData = false;
+		uint8 values[DMX_NUM_CHANNELS];
+		bool changedMask[DMX_NUM_CHANNELS];
+		var scriptData; //reused byte view for scripts, refreshed from values before each call
+	};
+
+	OwnedArray<InputShadow> inputShadows;
+	HashMap<int64, InputShadow*> inputShadowMap; //keyed on the full net, subnet and universe numbers, sACN universes go above 15
+
+	InputShadow* getInputShadow(int net, int subnet, int universe);
+	static bool computeChangedChannels(InputShadow* shadow, const uint8* values, int numValues);
+
 
 	void itemAdded(DMXUniverseItem* i) override;
 	void itemsAdded(Array<DMXUniverseItem*> items) override;
@@ -59,7 +75,7 @@ public:
 	void send16BitDMXValue(DMXUniverse* u, int channel, int value, DMXByteOrder byteOrder);
 	void send16BitDMXRange(DMXUniverse* u, int startChannel, Array<int> values, DMXByteOrder byteOrder);
 
-	void sendFromPassTrough(int net, int subnet, int universe, /*int priority,*/ Array<uint8> values);
+	void sendFromPassTrough(int net, int subnet, int universe, /*int priority,*/ const uint8* values, int numValues);
 
 	//Script
 	static var sendDMXFromScript(const var::NativeFunctionArgs& args);
@@ -78,6 +94,7 @@ public:
 	void dmxDeviceSetupChanged(DMXDevice*) override;
 
 	void dmxDataInChanged(DMXDevice*, int net, int subnet, int universe,/*int priority,*/ Array<uint8> values, const String& sourceName = "") override;
+	void processDMXIn(int net, int subnet, int universe, const uint8* values, int numValues, const String& sourceName); //works on the device's buffer, no copy per frame
 
 	DMXUniverse* getUniverse(bool isInput, int net, int subnet, int universe, /*int priority,*/ bool createIfNotThere = true);
 
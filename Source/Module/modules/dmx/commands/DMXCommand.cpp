@@ -101,7 +101,7 @@ DMXCommand::~DMXCommand()
 
 }
 
-void DMXCommand::setValue(var val, int multiplexIndex)
+void DMXCommand::setValue(var val, int multiplexIndex, const BigInteger* changedComponents)
 {
 	//DBG("Value val " << (int)val.isArray() << " / " << val.size()) ;
 
@@ -126,7 +126,7 @@ void DMXCommand::setValue(var val, int multiplexIndex)
 		//DBG("Val is array ");
 		//for(int i=0;i<newVal.size();++i) DBG("new val [" << i << "]/ " << (float)newVal[i]);
 	}
-	BaseCommand::setValue(newVal, multiplexIndex);
+	BaseCommand::setValue(newVal, multiplexIndex, changedComponents);
 }
 
 void DMXCommand::triggerInternal(int multiplexIndex)
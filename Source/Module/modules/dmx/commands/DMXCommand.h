@@ -36,7 +36,7 @@ public:
 	int remapTarget;
 	BoolParameter * remap01To255;
 
-	void setValue(var value, int multiplexIndex) override;
+	void setValue(var value, int multiplexIndex, const BigInteger* changedComponents = nullptr) override;
 	void triggerInternal(int multiplexIndex) override;
 
 
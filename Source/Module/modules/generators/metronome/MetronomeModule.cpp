@@ -9,18 +9,38 @@
 */
 #include "Module/ModuleIncludes.h"
 
+juce_ImplementSingleton(MetronomeScheduler)
+
 MetronomeModule::MetronomeModule() :
 	Module(getTypeString()),
-	Thread("Metronome"),
-	freqTimeBpm(nullptr)
+	freqTimeBpm(nullptr),
+	needsReschedule(true),
+	localOrigin(Time::getMillisecondCounterHiRes()),
+	gridOffset(0),
+	tickOrigin(0),
+	tickPeriod(1000),
+	scheduledBPM(0),
+	lastTickTime(0),
+	nextTickTime(0),
+	offTime(0),
+	tickIndex(0),
+	isOn(false)
 {
 	setupIOConfiguration(true, false);
 
 	mode = moduleParams.addEnumParameter("Mode", "The way to set the frequency");
 	mode->addOption("Frequency", FREQUENCY)->addOption("Time", TIME)->addOption("BPM", BPM);
 
+	subdivision = moduleParams.addIntParameter("Subdivision", "Number of ticks for each period. Subdivisions stay locked to the period", 1, 1, 64);
+	swing = moduleParams.addFloatParameter("Swing", "Delays every other tick, relative to half the time between two ticks", 0, 0, 1);
 	onTime = moduleParams.addFloatParameter("ON Time", "Relative amount of time the metronome stays valid (depending on the frequency) when triggered", .5f, 0, 1);
-	random = moduleParams.addFloatParameter("Randomness", "Amount of randomness in each call", 0, 0, 1);
+	random = moduleParams.addFloatParameter("Randomness", "Amount of randomness in each call, relative to half the time between two ticks. Ticks stay on the grid and don't drift", 0, 0, 1);
+	lockToGrid = moduleParams.addBoolParameter("Lock To Grid", "If checked, this metronome ticks on the grid shared by all locked metronomes, so metronomes with related tempos stay in phase. Reset Time only shifts this metronome's own phase on that grid. Otherwise the metronome starts its own grid when reset", true);
+
+	syncModule = moduleParams.addTargetParameter("Sync Module", "If set, the tempo follows this MIDI module's clock or Ableton Link module, Link also aligns the ticks on its beats", nullptr, false);
+	syncModule->targetType = TargetParameter::CONTAINER;
+	syncModule->customGetTargetContainerFunc = &MetronomeModule::showAndGetSyncModule;
+	syncModule->canBeDisabledByUser = true;
 
 	tapTempoIntervalsMax = moduleParams.addIntParameter("Tap tempo averaging", "How many intervals do you want to use in averaging ? 0 means all",4,1);
 	tapTempo = moduleParams.addTrigger("Tap Tempo", "press me at least twice to set tempo");
@@ -32,17 +52,18 @@ MetronomeModule::MetronomeModule() :
 
 	updateFreqParam();
 
-	startThread();
+	MetronomeScheduler::getInstance()->addMetronome(this);
 }
 
 MetronomeModule::~MetronomeModule()
 {
-	stopThread(1000);
+	if (MetronomeScheduler* s = MetronomeScheduler::getInstanceWithoutCreating()) s->removeMetronome(this);
 }
 
 void MetronomeModule::updateFreqParam()
 {
-	stopThread(1000);
+	//the scheduler may be reading the parameter
+	GenericScopedLock lock(MetronomeScheduler::getInstance()->metronomesLock);
 
 	if (freqTimeBpm != nullptr)
 	{
@@ -70,28 +91,24 @@ void MetronomeModule::updateFreqParam()
 	moduleParams.controllables.move(moduleParams.controllables.indexOf(freqTimeBpm), moduleParams.controllables.indexOf(mode)+1);
 	queuedNotifier.addMessage(new ContainerAsyncEvent(ContainerAsyncEvent::ControllableContainerNeedsRebuild, this));
 
-	startThread();
+	needsReschedule = true;
 }
 
 void MetronomeModule::onContainerParameterChangedInternal(Parameter* p)
 {
 	Module::onContainerParameterChangedInternal(p);
 
-	if (p == enabled)
-	{
-		if (enabled->boolValue()) startThread();
-		else stopThread(1000);
-	}
+	if (p == enabled) reschedule();
 }
 
 void MetronomeModule::onControllableFeedbackUpdateInternal(ControllableContainer * cc, Controllable * c)
 {
 	Module::onControllableFeedbackUpdateInternal(cc, c);
 
-	if (c == freqTimeBpm || c == random || c == mode)
+	if (c == freqTimeBpm || c == random || c == mode || c == subdivision || c == swing || c == lockToGrid || c == syncModule)
 	{
 		if (c == mode) updateFreqParam();
-		notify(); //forces the thread to update
+		reschedule();
 	} 
 	else if (c == tapTempo)
 	{
@@ -99,66 +116,186 @@ void MetronomeModule::onControllableFeedbackUpdateInternal(ControllableContainer
 	}
 	else if (c == resetTime)
 	{
-		stopThread(20);
-		startThread();
+		resetPhase();
 	}
 }
 
-void MetronomeModule::run()
+void MetronomeModule::reschedule()
 {
-	if (!enabled->boolValue()) return;
+	needsReschedule = true;
+	MetronomeScheduler::getInstance()->notify();
+}
 
-	Random r;
-	while (!threadShouldExit())
-	{	
+void MetronomeModule::resetPhase()
+{
+	MetronomeScheduler* s = MetronomeScheduler::getInstance();
+
+	{
+		GenericScopedLock lock(s->metronomesLock);
+		double now = Time::getMillisecondCounterHiRes();
+
+		//a locked metronome only shifts its own phase on the shared grid, the other metronomes keep theirs
+		if (lockToGrid->boolValue()) gridOffset = now - s->gridOrigin;
+		else localOrigin = now;
 
-		float freq = 1;
-		
+		lastTickTime = 0;
+	}
+
+	reschedule();
+}
+
+double MetronomeModule::getPeriod(double syncBPM) const
+{
+	double freq = 1;
+
+	if (syncBPM > 0) freq = syncBPM / 60.0;
+	else
+	{
 		MetroMode m = mode->getValueDataAsEnum<MetroMode>();
 		switch (m)
 		{
-		case FREQUENCY:
-			freq = freqTimeBpm->floatValue();
-			break;
+		case FREQUENCY: freq = freqTimeBpm->floatValue(); break;
+		case TIME: freq = 1.0 / freqTimeBpm->floatValue(); break;
+		case BPM: freq = freqTimeBpm->floatValue() / 60.0; break;
+		}
+	}
 
-		case TIME:
-			freq = 1.0f / freqTimeBpm->floatValue();
-			break;
+	freq *= subdivision->intValue();
+	return 1000.0 / jmax(freq, .0001);
+}
 
-		case BPM:
-			freq = freqTimeBpm->floatValue() / 60.f;
-			break;
-		}
+double MetronomeModule::getTickTime(int64 index, double origin, double period)
+{
+	double t = origin + index * period;
+	if (index % 2 != 0) t += swing->floatValue() * period * .5; //swing is phase-locked, it never accumulates
+	if (random->floatValue() > 0) t += (rnd.nextDouble() * 2 - 1) * random->floatValue() * period * .5;
+	return t;
+}
 
-		if(random->floatValue() > 0) freq += (r.nextFloat() * 2 - 1) * random->floatValue();
+bool MetronomeModule::getSyncInfo(double now, double& bpm, double& beatOrigin)
+{
+	bpm = 0;
+	beatOrigin = 0;
 
-		//on phase
-		int msBeforeON  = Time::getMillisecondCounter();
-		tick->setValue(true);
-		inActivityTrigger->trigger();
-		int msONDiff = Time::getMillisecondCounter() - msBeforeON;
+	if (!syncModule->enabled || syncModule->targetContainer == nullptr || syncModule->targetContainer.wasObjectDeleted()) return false;
 
-		int msToOff = (1000 / freq) * onTime->floatValue();
+	if (MIDIModule* m = dynamic_cast<MIDIModule*>(syncModule->targetContainer.get()))
+	{
+		bpm = m->bpm->floatValue(); //clock only gives the tempo
+		return false;
+	}
+
+	if (AbletonLinkModule* m = dynamic_cast<AbletonLinkModule*>(syncModule->targetContainer.get()))
+	{
+#if USE_ABLETONLINK
+		//read the session timeline directly, the published beat values are only updated at the module's update rate
+		auto session = m->link->captureAppSessionState();
+		bpm = session.tempo();
+		if (bpm <= 0) return false;
+
+		double phase = session.phaseAtTime(m->link->clock().micros(), 1);
+		beatOrigin = now - phase * 60000.0 / bpm;
+		return true;
+#else
+		bpm = m->bpm->floatValue();
+		return false;
+#endif
+	}
+
+	return false;
+}
+
+void MetronomeModule::schedule(double now)
+{
+	double syncBPM = 0;
+	double beatOrigin = 0;
+	bool hasSyncPhase = getSyncInfo(now, syncBPM, beatOrigin);
 
-		int realMSToOff = msToOff - msONDiff;
+	scheduledBPM = syncBPM;
+	tickPeriod = getPeriod(syncBPM);
+	tickOrigin = hasSyncPhase ? beatOrigin : lockToGrid->boolValue() ? MetronomeScheduler::getInstance()->gridOrigin + gridOffset : localOrigin;
+
+	//next tick on the grid, never less than half a period after the last one
+	tickIndex = (int64)std::ceil((now - tickOrigin) / tickPeriod);
+	nextTickTime = getTickTime(tickIndex, tickOrigin, tickPeriod);
+	while (nextTickTime < lastTickTime + tickPeriod * .5) nextTickTime = getTickTime(++tickIndex, tickOrigin, tickPeriod);
+
+	needsReschedule = false;
+}
+
+bool MetronomeModule::syncHasChanged(double now)
+{
+	double syncBPM = 0;
+	double beatOrigin = 0;
+	bool hasSyncPhase = getSyncInfo(now, syncBPM, beatOrigin);
+
+	if (syncBPM != scheduledBPM) return true;
+	if (!hasSyncPhase) return false;
+
+	//the beat origin is the last beat, compare it to the scheduled grid modulo one beat
+	double beatLength = 60000.0 / syncBPM;
+	double drift = beatOrigin - tickOrigin;
+	drift -= std::round(drift / beatLength) * beatLength;
+	return std::abs(drift) > 1;
+}
+
+double MetronomeModule::processTicks(double now, Array<MetronomeScheduler::TickEvent>& events)
+{
+	if (!enabled->boolValue())
+	{
+		if (isOn) events.add({ this, false });
+		isOn = false;
+		needsReschedule = true;
+		return now + 1000;
+	}
+
+	if (needsReschedule) schedule(now);
+
+	if (isOn && now >= offTime)
+	{
+		events.add({ this, false });
+		isOn = false;
+	}
 
-		if (realMSToOff > 0)
+	if (now >= nextTickTime)
+	{
+		events.add({ this, true });
+		isOn = true;
+
+		lastTickTime = nextTickTime;
+		offTime = nextTickTime + tickPeriod * onTime->floatValue();
+
+		//a synced tempo or phase is followed at every tick, but the grid is only rebuilt when it actually moved
+		if (needsReschedule || syncHasChanged(now)) schedule(now);
+		else nextTickTime = getTickTime(++tickIndex, tickOrigin, tickPeriod);
+
+		if (now >= offTime)
 		{
-			bool hasBeenSignalled = wait(realMSToOff);
-			if (hasBeenSignalled) continue;
+			events.add({ this, false });
+			isOn = false;
 		}
+	}
 
-		//off phase
-		int msBeforeOFF = Time::getMillisecondCounter();
-		tick->setValue(false);
-		int msOFFDiff = Time::getMillisecondCounter() - msBeforeOFF;
-
-		int msToOn = (1000 / freq) * (1 - onTime->floatValue());
-		int realMSToOn = msToOn - msOFFDiff;
+	return isOn ? jmin(offTime, nextTickTime) : nextTickTime;
+}
 
-		if (realMSToOn > 0) wait(realMSToOn);
+void MetronomeModule::showAndGetSyncModule(ControllableContainer* startFromCC, std::function<void(ControllableContainer*)> returnFunc)
+{
+	PopupMenu menu;
+	Array<Module*> validModules;
+	for (auto& m : ModuleManager::getInstance()->items)
+	{
+		if (dynamic_cast<MIDIModule*>(m) == nullptr && dynamic_cast<AbletonLinkModule*>(m) == nullptr) continue;
+		validModules.add(m);
+		menu.addItem(validModules.size(), m->niceName);
 	}
-	
+
+	menu.showMenuAsync(PopupMenu::Options(), [validModules, returnFunc](int result)
+		{
+			if (result == 0) return;
+			returnFunc(validModules[result - 1]);
+		}
+	);
 }
 
 void MetronomeModule::tapTempoPressed()
@@ -201,4 +338,87 @@ void MetronomeModule::tapTempoPressed()
 		tapTempoHistory.add(now);
 	}
 	TSTapTempoLastPressed = now;
+}
+
+//Scheduler
+
+MetronomeScheduler::MetronomeScheduler() :
+	Thread("Metronome"),
+	gridOrigin(Time::getMillisecondCounterHiRes())
+{
+	startThread();
+}
+
+MetronomeScheduler::~MetronomeScheduler()
+{
+	stopThread(1000);
+}
+
+void MetronomeScheduler::addMetronome(MetronomeModule* m)
+{
+	GenericScopedLock lock(metronomesLock);
+	metronomes.addIfNotAlreadyThere(m);
+	notify();
+}
+
+void MetronomeScheduler::removeMetronome(MetronomeModule* m)
+{
+	{
+		GenericScopedLock lock(metronomesLock);
+		metronomes.removeFirstMatchingValue(m);
+	}
+
+	//wait for ticks that may still be firing on this metronome
+	GenericScopedLock lock(fireLock);
+}
+
+void MetronomeScheduler::run()
+{
+	while (!threadShouldExit())
+	{
+		double now = Time::getMillisecondCounterHiRes();
+		const double idleDeadline = now + 100; //wake up regularly anyway to pick up changes
+		double nextDeadline = idleDeadline;
+
+		{
+			GenericScopedLock flock(fireLock);
+
+			{
+				GenericScopedLock lock(metronomesLock);
+				for (auto& m : metronomes) nextDeadline = jmin(nextDeadline, m->processTicks(now, tickEvents));
+			}
+
+			//listeners may take other locks or change the metronomes, so they're never called under metronomesLock
+			for (auto& e : tickEvents)
+			{
+				e.metronome->tick->setValue(e.isOn);
+				if (e.isOn) e.metronome->inActivityTrigger->trigger();
+			}
+			tickEvents.clearQuick();
+		}
+
+		waitUntil(nextDeadline, nextDeadline < idleDeadline);
+	}
+}
+
+void MetronomeScheduler::waitUntil(double deadline, bool precise)
+{
+	//wait() is only precise to a few ms, so ticks wait coarsely and yield for the last milliseconds
+	while (!threadShouldExit())
+	{
+		double remaining = deadline - Time::getMillisecondCounterHiRes();
+		if (remaining <= 0) return;
+
+		if (!precise)
+		{
+			wait(jmax(1, (int)remaining)); //returns early when notified
+			return;
+		}
+
+		if (remaining > 2)
+		{
+			if (wait((int)remaining - 1)) return; //notified, something changed
+		}
+		else Thread::yield();
+	}
 }
\ No newline at end of file
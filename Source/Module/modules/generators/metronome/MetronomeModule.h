@@ -10,10 +10,42 @@
 
 #pragma once
 
-class MetronomeModule :
-	public Module,
+class MetronomeModule;
+
+//Shared scheduler for all metronomes, ticks are absolute deadlines on a common high resolution time grid
+class MetronomeScheduler :
 	public Thread
 {
+public:
+	juce_DeclareSingleton(MetronomeScheduler, false)
+
+	MetronomeScheduler();
+	~MetronomeScheduler();
+
+	double gridOrigin; //ms, common origin of all metronomes locked to the grid
+
+	CriticalSection metronomesLock;
+	Array<MetronomeModule*> metronomes;
+
+	//ticks are computed under metronomesLock and fired after releasing it, removal waits for fireLock so a metronome is never fired after being deleted
+	struct TickEvent
+	{
+		MetronomeModule* metronome;
+		bool isOn;
+	};
+	CriticalSection fireLock;
+	Array<TickEvent> tickEvents;
+
+	void addMetronome(MetronomeModule* m);
+	void removeMetronome(MetronomeModule* m);
+
+	void run() override;
+	void waitUntil(double deadline, bool precise); //precise yields for the last milliseconds, only needed for ticks
+};
+
+class MetronomeModule :
+	public Module
+{
 public:
 	MetronomeModule();
 	~MetronomeModule();
@@ -24,8 +56,12 @@ public:
 	enum MetroMode { FREQUENCY, TIME, BPM };
 	EnumParameter* mode;
 	FloatParameter * freqTimeBpm;
+	IntParameter* subdivision;
+	FloatParameter* swing;
 	FloatParameter * onTime;
 	FloatParameter * random;
+	BoolParameter* lockToGrid;
+	TargetParameter* syncModule;
 	Trigger * tapTempo;
 	Trigger* resetTime;
 
@@ -34,15 +70,37 @@ public:
 	Array<double> tapTempoHistory;
 	IntParameter* tapTempoIntervalsMax;
 	void updateFreqParam();
+
+	//Scheduling, only used from the scheduler thread
+	std::atomic<bool> needsReschedule;
+	double localOrigin;
+	double gridOffset; //ms, phase of this metronome on the shared grid, set by Reset Time
+	double tickOrigin;
+	double tickPeriod;
+	double scheduledBPM;
+	double lastTickTime;
+	double nextTickTime;
+	double offTime;
+	int64 tickIndex;
+	bool isOn;
+
+	double getPeriod(double syncBPM) const;
+	double getTickTime(int64 index, double origin, double period);
+	bool getSyncInfo(double now, double& bpm, double& beatOrigin);
+	void schedule(double now);
+	bool syncHasChanged(double now);
+	double processTicks(double now, Array<MetronomeScheduler::TickEvent>& events);
+	void reschedule();
+	void resetPhase();
 	
 	void onContainerParameterChangedInternal(Parameter* p) override;
 	void onControllableFeedbackUpdateInternal(ControllableContainer * cc, Controllable * c) override;
 
-	virtual void run() override;
-
 	String getTypeString() const override { return "Metronome"; }
 	static MetronomeModule * create() { return new MetronomeModule(); }
 
+	static void showAndGetSyncModule(ControllableContainer* startFromCC, std::function<void(ControllableContainer*)> returnFunc);
+
 	void tapTempoPressed();
 
-};
\ No newline at end of file
+};
@@ -59,9 +59,9 @@ Array<var> GenericScriptCommand::getArgs(int multiplexIndex)
 	return args;
 }
 
-void GenericScriptCommand::updateMappingInputValue(var value, int multiplexIndex)
+void GenericScriptCommand::updateMappingInputValue(var value, int multiplexIndex, const BigInteger* changedComponents)
 {
-	for (auto& pLink : scriptParamContainer->paramLinks) if (pLink != nullptr) pLink->updateMappingInputValue(value, multiplexIndex);
+	for (auto& pLink : scriptParamContainer->paramLinks) if (pLink != nullptr) pLink->updateMappingInputValue(value, multiplexIndex, changedComponents);
 }
 
 void GenericScriptCommand::setInputNamesFromParams(Array<WeakReference<Parameter>> outParams)
@@ -124,7 +124,7 @@ void MIDINoteAndCCCommand::updateNoteParams()
 
 }
 
-void MIDINoteAndCCCommand::setValue(var value, int multiplexIndex)
+void MIDINoteAndCCCommand::setValue(var value, int multiplexIndex, const BigInteger* changedComponents)
 {
 	var newVal;
 	float mapFactor = (remap01To127 != nullptr && remap01To127->boolValue()) ? maxRemap : 1;
@@ -132,7 +132,7 @@ void MIDINoteAndCCCommand::setValue(var value, int multiplexIndex)
 	if (value.isArray()) for (int i = 0; i < value.size(); i++) newVal.append((float)value[i] * mapFactor);
 	else newVal = (float)value * mapFactor;
 
-	MIDICommand::setValue(newVal, multiplexIndex);
+	MIDICommand::setValue(newVal, multiplexIndex, changedComponents);
 }
 
 int MIDINoteAndCCCommand::getPitchFromNote(int multiplexIndex)
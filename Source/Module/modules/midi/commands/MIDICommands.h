@@ -56,7 +56,7 @@ public:
 
 	void updateNoteParams();
 
-	void setValue(var value, int multiplexIndex) override;
+	void setValue(var value, int multiplexIndex, const BigInteger* changedComponents = nullptr) override;
 	void triggerInternal(int multiplexIndex) override;
 
 	int getPitchFromNote(int multiplexIndex);
@@ -173,7 +173,7 @@ void OSCModule::processMessage(const OSCMessage& msg)
 
 	processMessageInternal(msg);
 
-	if (scriptManager->items.size() > 0)
+	if (hasScriptCallback(oscEventId) || (scriptManager->items.size() > 0 && !scriptCallbacks.isEmpty()))
 	{
 		Array<var> params;
 		params.add(msg.getAddressPattern().toString());
@@ -279,6 +279,30 @@ void OSCModule::sendOSC(const OSCMessage& msg, String ip, int port)
 	}
 }
 
+void OSCModule::sendOSCBatch(const Array<OSCMessage>& messages)
+{
+	if (messages.isEmpty()) return;
+	if (isClearing || outputManager == nullptr) return;
+	if (!enabled->boolValue()) return;
+
+	if (!outputManager->enabled->boolValue()) return;
+
+	if (logOutgoingData->boolValue())
+	{
+		NLOG(niceName, "Send OSC batch : " << messages.size() << " messages");
+		for (auto& m : messages)
+		{
+			String s = m.getAddressPattern().toString();
+			for (auto& a : m) s += " " + OSCHelpers::getStringArg(a);
+			LOG(s);
+		}
+	}
+
+	outActivityTrigger->trigger();
+
+	for (auto& o : outputManager->items) o->sendOSCBatch(messages);
+}
+
 void OSCModule::setupZeroConf()
 {
 	if (Engine::mainEngine->isClearing || localPort == nullptr) return;
@@ -501,40 +525,61 @@ void OSCModule::handleRoutedModuleValue(Controllable* c, RouteParams* p)
 {
 	if (c == nullptr || p == nullptr) return;
 
-
 	if (OSCRouteParams* op = dynamic_cast<OSCRouteParams*>(p))
 	{
-		try
+		OSCMessage m("/");
+		if (createRoutedMessage(c, op, m)) sendOSC(m);
+	}
+}
+
+void OSCModule::handleRoutedModuleValues(const Array<Controllable*>& values, const Array<RouteParams*>& params)
+{
+	Array<OSCMessage> messages;
+	for (int i = 0; i < values.size(); i++)
+	{
+		OSCRouteParams* op = dynamic_cast<OSCRouteParams*>(params[i]);
+		if (values[i] == nullptr || op == nullptr) continue;
+
+		OSCMessage m("/");
+		if (createRoutedMessage(values[i], op, m)) messages.add(m);
+	}
+
+	sendOSCBatch(messages);
+}
+
+bool OSCModule::createRoutedMessage(Controllable* c, OSCRouteParams* op, OSCMessage& m)
+{
+	try
+	{
+		m = OSCMessage(getAddressForRoutedValue(c, op));
+
+		if (c->type != Controllable::TRIGGER)
 		{
-			OSCMessage m(getAddressForRoutedValue(c, op));
+			var v = dynamic_cast<Parameter*>(c)->getValue();
 
-			if (c->type != Controllable::TRIGGER)
+			if (c->type == Parameter::COLOR)
 			{
-				var v = dynamic_cast<Parameter*>(c)->getValue();
-
-				if (c->type == Parameter::COLOR)
-				{
-					m.addArgument(OSCHelpers::getOSCColour(((ColorParameter*)c)->getColor()));
-				}
+				m.addArgument(OSCHelpers::getOSCColour(((ColorParameter*)c)->getColor()));
+			}
+			else
+			{
+				if (!v.isArray())  m.addArgument(OSCHelpers::varToArgument(v, getBoolMode()));
 				else
 				{
-					if (!v.isArray())  m.addArgument(OSCHelpers::varToArgument(v, getBoolMode()));
-					else
-					{
-						for (int i = 0; i < v.size(); ++i) m.addArgument(OSCHelpers::varToArgument(v[i], getBoolMode()));
-					}
+					for (int i = 0; i < v.size(); ++i) m.addArgument(OSCHelpers::varToArgument(v[i], getBoolMode()));
 				}
-
 			}
 
-			sendOSC(m);
-		}
-		catch (const OSCFormatError&)
-		{
-			NLOGERROR(niceName, "Address is invalid : " << op->address->stringValue() << "\nAddresses should always start with a forward slash");
 		}
+
+		return true;
+	}
+	catch (const OSCFormatError&)
+	{
+		NLOGERROR(niceName, "Address is invalid : " << op->address->stringValue() << "\nAddresses should always start with a forward slash");
 	}
 
+	return false;
 }
 
 String OSCModule::getAddressForRoutedValue(Controllable*, OSCRouteParams* op)
@@ -672,6 +717,7 @@ OSCOutput::OSCOutput() :
 	remoteHost->setEnabled(!useLocal->boolValue());
 	remotePort = addIntParameter("Remote port", "Port on which the remote host is listening to", 9000, 1, 65535);
 	listenToOutputFeedback = addBoolParameter("Listen to Feedback", "If checked, this will listen to the (randomly set) bound port of this sender. This is useful when some softwares automatically detect incoming host and port to send back messages.", false);
+	bundleBatches = addBoolParameter("Bundle Batches", "If checked, messages sent together (e.g. a command triggered on all multiplex indices at once) are packed in OSC bundles instead of one packet per message. The receiving software must support OSC bundles.", false);
 
 
 }
@@ -771,29 +817,85 @@ void OSCOutput::sendOSC(const OSCMessage& m)
 
 	{
 		const ScopedLock sl(queueLock);
-		messageQueue.push(std::make_unique<OSCMessage>(m));
+		messageQueue.push(std::make_unique<OSCBundle::Element>(m));
+	}
+	notify();
+}
+
+void OSCOutput::sendOSCBatch(const Array<OSCMessage>& messages)
+{
+	if (!enabled->boolValue() || forceDisabled || !senderIsConnected) return;
+
+	{
+		const ScopedLock sl(queueLock);
+
+		if (bundleBatches->boolValue())
+		{
+			//keep bundles under a typical ethernet MTU to avoid IP fragmentation
+			const int maxBundleSize = 1400;
+			const int bundleHeaderSize = 16; //"#bundle" + time tag
+
+			OSCBundle bundle;
+			int bundleSize = bundleHeaderSize;
+			for (auto& m : messages)
+			{
+				int mSize = getEstimatedPacketSize(m);
+				if (!bundle.isEmpty() && bundleSize + mSize > maxBundleSize)
+				{
+					messageQueue.push(std::make_unique<OSCBundle::Element>(bundle));
+					bundle = OSCBundle();
+					bundleSize = bundleHeaderSize;
+				}
+
+				bundle.addElement(m);
+				bundleSize += mSize;
+			}
+
+			if (!bundle.isEmpty()) messageQueue.push(std::make_unique<OSCBundle::Element>(bundle));
+		}
+		else
+		{
+			for (auto& m : messages) messageQueue.push(std::make_unique<OSCBundle::Element>(m));
+		}
 	}
 	notify();
 }
 
+int OSCOutput::getEstimatedPacketSize(const OSCMessage& m)
+{
+	//size prefix inside a bundle + padded address + padded type tags
+	int size = 4 + ((m.getAddressPattern().toString().getNumBytesAsUTF8() + 4) & ~3) + ((m.size() + 5) & ~3);
+	for (auto& a : m)
+	{
+		if (a.isString()) size += (a.getString().getNumBytesAsUTF8() + 4) & ~3;
+		else if (a.isBlob()) size += 4 + (((int)a.getBlob().getSize() + 3) & ~3);
+		else size += 4;
+	}
+
+	return size;
+}
+
 
 void OSCOutput::run()
 {
 	while (!Engine::mainEngine->isClearing && !threadShouldExit())
 	{
-		std::unique_ptr<OSCMessage> msgToSend;
+		std::unique_ptr<OSCBundle::Element> elementToSend;
 
 		{
 			const ScopedLock sl(queueLock);
 			if (!messageQueue.empty())
 			{
-				msgToSend = std::move(messageQueue.front());
+				elementToSend = std::move(messageQueue.front());
 				messageQueue.pop();
 			}
 		}
 
-		if (msgToSend)
-			sender.send(*msgToSend);
+		if (elementToSend)
+		{
+			if (elementToSend->isBundle()) sender.send(elementToSend->getBundle());
+			else sender.send(elementToSend->getMessage());
+		}
 		else
 			wait(1000); // notify() is called when a message is added to the queue
 	}
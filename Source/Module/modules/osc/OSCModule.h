@@ -33,6 +33,7 @@ public:
 	StringParameter * remoteHost;
 	IntParameter * remotePort;
 	BoolParameter* listenToOutputFeedback;
+	BoolParameter* bundleBatches;
 	std::unique_ptr<OSCReceiver> receiver;
 	std::unique_ptr<DatagramSocket> socket;
 
@@ -42,6 +43,9 @@ public:
 
 	virtual void setupSender();
 	void sendOSC(const OSCMessage & m);
+	void sendOSCBatch(const Array<OSCMessage>& messages);
+
+	static int getEstimatedPacketSize(const OSCMessage& m);
 
 	virtual void run() override;
 
@@ -51,7 +55,7 @@ public:
 
 private:
 	OSCSender sender;
-	std::queue<std::unique_ptr<OSCMessage>> messageQueue;
+	std::queue<std::unique_ptr<OSCBundle::Element>> messageQueue;
 	CriticalSection queueLock;
 };
 
@@ -101,6 +105,7 @@ public:
 	virtual void setupSenders();
 	virtual void sendOSC(const OSCMessage& msg) override;
 	virtual void sendOSC(const OSCMessage& msg, String ip, int port = 0);
+	virtual void sendOSCBatch(const Array<OSCMessage>& messages) override;
 
 	//ZEROCONF
 	void setupZeroConf();
@@ -133,6 +138,8 @@ public:
 
 	virtual RouteParams * createRouteParamsForSourceValue(Module * sourceModule, Controllable * c, int /*index*/) override { return new OSCRouteParams(sourceModule, c); }
 	virtual void handleRoutedModuleValue(Controllable * c, RouteParams * p) override;
+	virtual void handleRoutedModuleValues(const Array<Controllable*>& values, const Array<RouteParams*>& params) override;
+	bool createRoutedMessage(Controllable* c, OSCRouteParams* op, OSCMessage& m);
 	virtual String getAddressForRoutedValue(Controllable* c, OSCRouteParams* op);
 
 	virtual void onContainerParameterChangedInternal(Parameter * p) override;
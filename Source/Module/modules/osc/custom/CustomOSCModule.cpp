@@ -359,7 +359,7 @@ void CustomOSCModule::updateControllableAddressMap()
 
 void CustomOSCModule::childStructureChanged(ControllableContainer* cc)
 {
-	ControllableContainer::childStructureChanged(cc);
+	Module::childStructureChanged(cc);
 	if (!isCurrentlyLoadingData && !hierarchyStructureSwitch)
 	{
 		updateControllableAddressMap();
@@ -18,7 +18,8 @@ GenericOSCQueryModule::GenericOSCQueryModule(const String& name, int defaultRemo
 	remoteHost(nullptr),
 	remotePort(nullptr),
 	isUpdatingStructure(false),
-	hasListenExtension(false)
+	hasListenExtension(false),
+	fullSyncRequested(false)
 {
 	alwaysShowValues = true;
 	canHandleRouteValues = true;
@@ -36,6 +37,7 @@ GenericOSCQueryModule::GenericOSCQueryModule(const String& name, int defaultRemo
 	isConnected = moduleParams.addBoolParameter("Is Connected", "Is Connected to server's websocket", false);
 	isConnected->hideInEditor = true;
 	connectionFeedbackRef = isConnected;
+	addConnectionValues(&moduleParams);
 
 	listenAllTrigger = moduleParams.addTrigger("Listen to all", "This will automatically enable listen to all containers");
 	listenNoneTrigger = moduleParams.addTrigger("Listen to none", "This will automatically disable listen to all containers");
@@ -69,14 +71,20 @@ GenericOSCQueryModule::GenericOSCQueryModule(const String& name, int defaultRemo
 
 	if (Engine::mainEngine->isLoadingFile) Engine::mainEngine->addEngineListener(this);
 
+	ConnectionSupervisor::getInstance()->addClient(this);
+
 	startTimer(5000);
 }
 
 GenericOSCQueryModule::~GenericOSCQueryModule()
 {
 	if (Engine::mainEngine != nullptr) Engine::mainEngine->removeEngineListener(this);
+	if (ConnectionSupervisor* s = ConnectionSupervisor::getInstanceWithoutCreating()) s->removeClient(this);
 
-	if (wsClient != nullptr) wsClient->stop();
+	{
+		GenericScopedLock lock(wsLock);
+		if (wsClient != nullptr) wsClient->stop();
+	}
 	stopThread(2000);
 	valuesCC.clear();
 }
@@ -84,8 +92,18 @@ GenericOSCQueryModule::~GenericOSCQueryModule()
 void GenericOSCQueryModule::setupWSClient()
 {
 	isConnected->setValue(false);
-	if (wsClient != nullptr) wsClient->stop();
-	wsClient.reset();
+
+	//the old client is stopped outside the lock, its thread may be sending from a callback
+	std::unique_ptr<SimpleWebSocketClientBase> oldClient;
+	{
+		GenericScopedLock lock(wsLock);
+		oldClient.reset(wsClient.release());
+	}
+
+	if (oldClient != nullptr) oldClient->stop();
+	oldClient.reset();
+
+	GenericScopedLock lock(wsLock);
 	if (isCurrentlyLoadingData || !hasListenExtension) return;
 
 	if (!enabled->boolValue()) return;
@@ -101,6 +119,21 @@ void GenericOSCQueryModule::setupWSClient()
 	wsClient->start(url);
 }
 
+bool GenericOSCQueryModule::isSupervisedConnectionNeeded()
+{
+	return enabled->boolValue() && hasListenExtension && !isCurrentlyLoadingData;
+}
+
+bool GenericOSCQueryModule::isSupervisedConnected()
+{
+	return isConnected->boolValue();
+}
+
+void GenericOSCQueryModule::attemptConnection()
+{
+	setupWSClient();
+}
+
 void GenericOSCQueryModule::sendOSC(const OSCMessage& m)
 {
 	if (!enabled->boolValue()) return;
@@ -206,63 +239,208 @@ void GenericOSCQueryModule::syncData()
 {
 	if (isCurrentlyLoadingData || Engine::mainEngine->isLoadingFile) return;
 
+	{
+		GenericScopedLock lock(syncLock);
+		fullSyncRequested = true;
+		pathsToSync.clear(); //covered by the full sync
+	}
+
 	startThread();
 }
 
+void GenericOSCQueryModule::queuePathSync(const String& path)
+{
+	if (isCurrentlyLoadingData || Engine::mainEngine->isLoadingFile) return;
+
+	{
+		GenericScopedLock lock(syncLock);
+		if (fullSyncRequested) return;
+		pathsToSync.addIfNotAlreadyThere(path);
+	}
+
+	startThread(); //if already running, the thread will pick it up, otherwise the timer will restart it
+}
+
 void GenericOSCQueryModule::updateTreeFromData(var data)
 {
 	if (data.isVoid()) return;
 
+	GenericScopedLock lock(treeLock);
+
 	isUpdatingStructure = true;
 
-	Array<String> enableListenContainers;
-	Array<String> expandedContainers;
-	Array<WeakReference<ControllableContainer>> containers = valuesCC.getAllContainers(true);
+	//only touch what changed, existing controllables (and everything linked to them) are kept
+	if (treeData.isVoid() || (valuesCC.controllables.isEmpty() && valuesCC.controllableContainers.isEmpty())) updateContainerStructure(&valuesCC, data);
+	else diffContainer(&valuesCC, treeData, data);
+
+	isUpdatingStructure = false;
+
+	treeData = data;
+}
 
-	if (!keepValuesOnSync->boolValue())
+void GenericOSCQueryModule::diffContainer(ControllableContainer* cc, var oldData, var newData)
+{
+	var oldContents = oldData.getProperty("CONTENTS", var());
+	var newContents = newData.getProperty("CONTENTS", var());
+
+	if (!newContents.isObject() || !oldContents.isObject())
+	{
+		updateContainerStructure(cc, newData);
+		return;
+	}
+
+	NamedValueSet& oldProps = oldContents.getDynamicObject()->getProperties();
+	NamedValueSet& newProps = newContents.getDynamicObject()->getProperties();
+
+	bool structureChanged = oldProps.size() != newProps.size();
+	Array<ControllableContainer*> childContainers;
+	Array<var> childOldData;
+	Array<var> childNewData;
+	Array<Parameter*> valueParams;
+	Array<var> values;
+
+	for (int i = 0; i < newProps.size() && !structureChanged; i++)
 	{
-		for (auto& cc : containers)
+		String key = newProps.getName(i).toString();
+		var n = newProps.getValueAt(i);
+		var o = oldProps.getWithDefault(key, var());
+
+		if (o.isVoid() || isContainerNode(o) != isContainerNode(n))
 		{
-			if (OSCQueryHelpers::OSCQueryValueContainer* gcc = dynamic_cast<OSCQueryHelpers::OSCQueryValueContainer*>(cc.get()))
+			structureChanged = true;
+		}
+		else if (n.isObject() && n.getDynamicObject() == o.getDynamicObject())
+		{
+			continue; //same node, nothing to check (path-scoped updates only replace the changed branch)
+		}
+		else if (isContainerNode(n))
+		{
+			ControllableContainer* childCC = getChildContainerForKey(cc, key, n);
+			if (childCC == nullptr) structureChanged = true;
+			else
 			{
-				if (gcc->enableListen->boolValue())
-				{
-					enableListenContainers.add(gcc->getControlAddress(&valuesCC));
-					gcc->enableListen->setValue(false);
-					if (!gcc->editorIsCollapsed) expandedContainers.add(gcc->getControlAddress(&valuesCC));
-				}
+				childContainers.add(childCC);
+				childOldData.add(o);
+				childNewData.add(n);
+			}
+		}
+		else if (!isNodeDataEqual(o, n, "VALUE"))
+		{
+			structureChanged = true; //type, range, access... changed
+		}
+		else if (!keepValuesOnSync->boolValue())
+		{
+			Controllable* c = getChildControllableForKey(cc, key, n);
+			if (c == nullptr) structureChanged = true;
+			else if (c->type == Controllable::TRIGGER) continue;
+			else if (c->type == Controllable::COLOR || c->type == Controllable::ENUM)
+			{
+				//these need the helper's conversion
+				if (!isNodeDataEqual(o.getProperty("VALUE", var()), n.getProperty("VALUE", var()))) structureChanged = true;
+			}
+			else
+			{
+				valueParams.add((Parameter*)c);
+				values.add(n.getProperty("VALUE", var()));
 			}
 		}
 	}
 
+	if (structureChanged)
+	{
+		updateContainerStructure(cc, newData);
+		return;
+	}
+
+	for (int i = 0; i < childContainers.size(); i++) diffContainer(childContainers[i], childOldData[i], childNewData[i]);
 
-	var vData(new DynamicObject());
-	if (keepValuesOnSync->boolValue())
+	for (int i = 0; i < valueParams.size(); i++)
+	{
+		var v = values[i];
+		if (!v.isArray() || v.size() == 0) continue;
+		valueParams[i]->setValue(valueParams[i]->value.isArray() ? v : v[0]);
+	}
+}
+
+void GenericOSCQueryModule::updateContainerStructure(ControllableContainer* cc, var data)
+{
+	//the helper adds and updates nodes, removed ones are cleaned here
+	var contents = data.getProperty("CONTENTS", var());
+	OSCQueryHelpers::OSCQueryValueContainer* parentGCC = dynamic_cast<OSCQueryHelpers::OSCQueryValueContainer*>(cc);
+
+	//resolve children the same way the diff does (by key or DESCRIPTION), so nodes named from their description are kept
+	Array<ControllableContainer*> keptContainers;
+	Array<Controllable*> keptControllables;
+	if (contents.isObject())
 	{
-		Array<WeakReference<Parameter>> params = valuesCC.getAllParameters(true);
-		for (auto& p : params)
+		NamedValueSet& props = contents.getDynamicObject()->getProperties();
+		for (auto& nv : props)
 		{
-			vData.getDynamicObject()->setProperty(p->getControlAddress(&valuesCC), p->value);
+			String key = nv.name.toString();
+			if (isContainerNode(nv.value))
+			{
+				if (ControllableContainer* childCC = getChildContainerForKey(cc, key, nv.value)) keptContainers.add(childCC);
+			}
+			else if (Controllable* c = getChildControllableForKey(cc, key, nv.value)) keptControllables.add(c);
 		}
+	}
+
+	Array<ControllableContainer*> containersToRemove;
+	for (auto& childCC : cc->controllableContainers)
+	{
+		if (!keptContainers.contains(childCC)) containersToRemove.add(childCC);
+	}
+	for (auto& childCC : containersToRemove) cc->removeChildControllableContainer(childCC);
+
+	Array<Controllable*> controllablesToRemove;
+	for (auto& c : cc->controllables)
+	{
+		if (parentGCC != nullptr && (c == parentGCC->enableListen || c == parentGCC->syncContent)) continue;
+		if (!keptControllables.contains(c)) controllablesToRemove.add(c);
+	}
+	for (auto& c : controllablesToRemove) cc->removeControllable(c);
+
+	Array<String> enableListenContainers;
+	Array<String> expandedContainers;
+	var vData(new DynamicObject());
+
+	Array<WeakReference<ControllableContainer>> containers = cc->getAllContainers(true);
+	if (parentGCC != nullptr) containers.add(parentGCC);
 
-		for (auto& cc : containers)
+	if (keepValuesOnSync->boolValue())
+	{
+		Array<WeakReference<Parameter>> params = cc->getAllParameters(true);
+		for (auto& p : params) vData.getDynamicObject()->setProperty(p->getControlAddress(&valuesCC), p->value);
+
+		for (auto& gc : containers)
 		{
-			if (OSCQueryHelpers::OSCQueryValueContainer* gcc = dynamic_cast<OSCQueryHelpers::OSCQueryValueContainer*>(cc.get()))
+			if (OSCQueryHelpers::OSCQueryValueContainer* gcc = dynamic_cast<OSCQueryHelpers::OSCQueryValueContainer*>(gc.get()))
 			{
 				if (gcc->enableListen->boolValue()) gcc->enableListen->setValue(true, false, true); //force relistening
 			}
 		}
 	}
+	else
+	{
+		for (auto& gc : containers)
+		{
+			if (OSCQueryHelpers::OSCQueryValueContainer* gcc = dynamic_cast<OSCQueryHelpers::OSCQueryValueContainer*>(gc.get()))
+			{
+				if (gcc->enableListen->boolValue())
+				{
+					enableListenContainers.add(gcc->getControlAddress(&valuesCC));
+					gcc->enableListen->setValue(false);
+					if (!gcc->editorIsCollapsed) expandedContainers.add(gcc->getControlAddress(&valuesCC));
+				}
+			}
+		}
+	}
 
-	//valuesCC.clear();
-
-	OSCQueryHelpers::updateContainerFromData(&valuesCC, data, useAddressForNaming->boolValue());
-
-	isUpdatingStructure = false;
+	OSCQueryHelpers::updateContainerFromData(cc, data, useAddressForNaming->boolValue());
 
 	if (keepValuesOnSync->boolValue())
 	{
-		NamedValueSet nvs = vData.getDynamicObject()->getProperties();
+		NamedValueSet& nvs = vData.getDynamicObject()->getProperties();
 		for (auto& nv : nvs)
 		{
 			if (Parameter* p = dynamic_cast<Parameter*>(valuesCC.getControllableForAddress(nv.name.toString())))
@@ -283,15 +461,119 @@ void GenericOSCQueryModule::updateTreeFromData(var data)
 
 		for (auto& addr : expandedContainers)
 		{
-			if (ControllableContainer* cc = valuesCC.getControllableContainerForAddress(addr))
+			if (ControllableContainer* ecc = valuesCC.getControllableContainerForAddress(addr))
 			{
-				cc->editorIsCollapsed = false;
-				cc->queuedNotifier.addMessage(new ContainerAsyncEvent(ContainerAsyncEvent::ControllableContainerCollapsedChanged, cc)); //should move to a setCollapsed from ControllableContainer.cpp
+				ecc->editorIsCollapsed = false;
+				ecc->queuedNotifier.addMessage(new ContainerAsyncEvent(ContainerAsyncEvent::ControllableContainerCollapsedChanged, ecc)); //should move to a setCollapsed from ControllableContainer.cpp
 			}
 		}
 	}
+}
 
-	treeData = data;
+void GenericOSCQueryModule::applyPathData(const String& path, var nodeData)
+{
+	if (path.isEmpty() || path == "/")
+	{
+		updateTreeFromData(nodeData);
+		return;
+	}
+
+	GenericScopedLock lock(treeLock);
+
+	String parentPath = path.upToLastOccurrenceOf("/", false, false);
+	String key = path.fromLastOccurrenceOf("/", false, false);
+
+	var oldParent = getTreeNode(treeData, parentPath);
+	ControllableContainer* cc = parentPath.isEmpty() ? &valuesCC : valuesCC.getControllableContainerForAddress(parentPath);
+
+	if (!isContainerNode(oldParent) || cc == nullptr)
+	{
+		if (nodeData.isVoid()) return; //removing something we don't have
+		NLOGWARNING(niceName, "Unknown parent for " << path << ", syncing the whole structure");
+		syncData();
+		return;
+	}
+
+	//new branch sharing all unchanged nodes with the current tree, so the diff only walks the changed one
+	var newParent(new DynamicObject());
+	newParent.getDynamicObject()->getProperties() = oldParent.getDynamicObject()->getProperties();
+	var newContents(new DynamicObject());
+	newContents.getDynamicObject()->getProperties() = oldParent.getProperty("CONTENTS", var()).getDynamicObject()->getProperties();
+	if (nodeData.isVoid()) newContents.getDynamicObject()->removeProperty(key);
+	else newContents.getDynamicObject()->setProperty(key, nodeData);
+	newParent.getDynamicObject()->setProperty("CONTENTS", newContents);
+
+	isUpdatingStructure = true;
+	diffContainer(cc, oldParent, newParent);
+	isUpdatingStructure = false;
+
+	if (parentPath.isEmpty()) treeData = newParent;
+	else
+	{
+		var grandParent = getTreeNode(treeData, parentPath.upToLastOccurrenceOf("/", false, false));
+		grandParent.getProperty("CONTENTS", var()).getDynamicObject()->setProperty(parentPath.fromLastOccurrenceOf("/", false, false), newParent);
+	}
+}
+
+ControllableContainer* GenericOSCQueryModule::getChildContainerForKey(ControllableContainer* cc, const String& key, var nodeData)
+{
+	if (ControllableContainer* childCC = cc->getControllableContainerByName(key, true)) return childCC;
+	String description = nodeData.getProperty("DESCRIPTION", "");
+	if (description.isNotEmpty()) return cc->getControllableContainerByName(description, true);
+	return nullptr;
+}
+
+Controllable* GenericOSCQueryModule::getChildControllableForKey(ControllableContainer* cc, const String& key, var nodeData)
+{
+	if (Controllable* c = cc->getControllableByName(key, true)) return c;
+	String description = nodeData.getProperty("DESCRIPTION", "");
+	if (description.isNotEmpty()) return cc->getControllableByName(description, true);
+	return nullptr;
+}
+
+bool GenericOSCQueryModule::isNodeDataEqual(const var& a, const var& b, const Identifier& ignoreProperty)
+{
+	if (a.isObject() && b.isObject())
+	{
+		if (a.getDynamicObject() == b.getDynamicObject()) return true;
+
+		NamedValueSet& aProps = a.getDynamicObject()->getProperties();
+		NamedValueSet& bProps = b.getDynamicObject()->getProperties();
+		if (aProps.size() != bProps.size()) return false;
+
+		for (auto& nv : aProps)
+		{
+			if (nv.name == ignoreProperty) continue;
+			if (!bProps.contains(nv.name)) return false;
+			if (!isNodeDataEqual(nv.value, bProps[nv.name])) return false;
+		}
+		return true;
+	}
+
+	if (a.isArray() && b.isArray())
+	{
+		if (a.size() != b.size()) return false;
+		for (int i = 0; i < a.size(); i++) if (!isNodeDataEqual(a[i], b[i])) return false;
+		return true;
+	}
+
+	return a.equalsWithSameType(b);
+}
+
+var GenericOSCQueryModule::getTreeNode(var root, const String& path)
+{
+	StringArray split;
+	split.addTokens(path, "/", "");
+	split.removeEmptyStrings();
+
+	var node = root;
+	for (auto& s : split)
+	{
+		node = node.getProperty("CONTENTS", var()).getProperty(s, var());
+		if (node.isVoid()) return var();
+	}
+
+	return node;
 }
 
 
@@ -310,6 +592,8 @@ void GenericOSCQueryModule::updateAllListens()
 void GenericOSCQueryModule::updateListenToContainer(OSCQueryHelpers::OSCQueryValueContainer* gcc, bool onlySendIfListen)
 {
 	if (!enabled->boolValue() || !hasListenExtension || isCurrentlyLoadingData || isUpdatingStructure) return;
+
+	GenericScopedLock lock(wsLock);
 	if (wsClient == nullptr || !wsClient->isConnected)
 	{
 		NLOGWARNING(niceName, "Websocket not connected, can't LISTEN");
@@ -443,6 +727,26 @@ void GenericOSCQueryModule::messageReceived(const String& message)
 	}
 
 	inActivityTrigger->trigger();
+
+	var o = JSON::parse(message);
+	if (!o.isObject()) return;
+
+	//namespace change notifications, only the concerned path is updated
+	String command = o.getProperty("COMMAND", "");
+	var d = o.getProperty("DATA", var());
+
+	if (command == "PATH_CHANGED") queuePathSync(d.toString());
+	else if (command == "PATH_ADDED")
+	{
+		if (d.isObject() && d.hasProperty("FULL_PATH")) applyPathData(d.getProperty("FULL_PATH", "").toString(), d);
+		else queuePathSync(d.toString());
+	}
+	else if (command == "PATH_REMOVED") applyPathData(d.toString(), var());
+	else if (command == "PATH_RENAMED")
+	{
+		applyPathData(d.getProperty("OLD", "").toString(), var());
+		queuePathSync(d.getProperty("NEW", "").toString());
+	}
 }
 
 var GenericOSCQueryModule::getJSONData(bool includeNonOverriden)
@@ -474,7 +778,12 @@ void GenericOSCQueryModule::endLoadFile()
 
 void GenericOSCQueryModule::timerCallback()
 {
-	if (hasListenExtension && !isConnected->boolValue()) setupWSClient();
+	bool hasPendingPaths = false;
+	{
+		GenericScopedLock lock(syncLock);
+		hasPendingPaths = !pathsToSync.isEmpty();
+	}
+	if (hasPendingPaths && !isThreadRunning()) startThread();
 }
 
 void GenericOSCQueryModule::run()
@@ -482,7 +791,28 @@ void GenericOSCQueryModule::run()
 	if (useLocal == nullptr || remoteHost == nullptr || remotePort == nullptr) return;
 
 	wait(100); //safety
-	requestHostInfo();
+
+	bool doFullSync = false;
+	{
+		GenericScopedLock lock(syncLock);
+		doFullSync = fullSyncRequested;
+		fullSyncRequested = false;
+	}
+
+	if (doFullSync) requestHostInfo();
+
+	while (!threadShouldExit())
+	{
+		String path;
+		{
+			GenericScopedLock lock(syncLock);
+			if (pathsToSync.isEmpty()) break;
+			path = pathsToSync[0];
+			pathsToSync.remove(0);
+		}
+
+		requestPathStructure(path);
+	}
 }
 
 void GenericOSCQueryModule::requestHostInfo()
@@ -561,6 +891,7 @@ void GenericOSCQueryModule::requestHostInfo()
 			requestStructure();
 
 			if (hasListenExtension) NLOG(niceName, "Server has LISTEN extension, setting up websocket");
+			ConnectionSupervisor::getInstance()->connectionAttemptStarted(this);
 			setupWSClient();
 		}
 
@@ -625,6 +956,29 @@ void GenericOSCQueryModule::requestStructure()
 	}
 }
 
+void GenericOSCQueryModule::requestPathStructure(const String& path)
+{
+	URL url("http://" + (useLocal->boolValue() ? "127.0.0.1" : remoteHost->stringValue()) + ":" + String(remotePort->intValue()) + path);
+	int statusCode = 0;
+
+	std::unique_ptr<InputStream> stream(url.createInputStream(
+		URL::InputStreamOptions(URL::ParameterHandling::inAddress)
+		.withConnectionTimeoutMs(5000)
+		.withStatusCode(&statusCode)
+	));
+
+	if (stream == nullptr || statusCode != 200)
+	{
+		if (logIncomingData->boolValue()) NLOGWARNING(niceName, "Error requesting path " << path << ", status code : " << statusCode);
+		return;
+	}
+
+	inActivityTrigger->trigger();
+
+	var data = JSON::parse(stream->readEntireStreamAsString());
+	if (data.isObject()) applyPathData(path, data);
+}
+
 void GenericOSCQueryModule::handleRoutedModuleValue(Controllable* c, RouteParams* p)
 {
 	if (!enabled->boolValue()) return;
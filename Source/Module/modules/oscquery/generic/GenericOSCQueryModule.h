@@ -30,7 +30,8 @@ class GenericOSCQueryModule :
 	public SimpleWebSocketClientBase::Listener,
 	public Thread,
 	public Timer,
-	public EngineListener
+	public EngineListener,
+	public ConnectionSupervisor::Client
 {
 public:
 	GenericOSCQueryModule(const String& name = "OSCQuery", int defaultRemotePort = 5678);
@@ -56,16 +57,28 @@ public:
 	IntParameter* remoteWSPort;
 
 	OSCSender sender;
+	CriticalSection wsLock;
 	std::unique_ptr<SimpleWebSocketClientBase> wsClient;
 	bool isUpdatingStructure;
 	bool hasListenExtension;
 	var treeData; //to keep on save
+	CriticalSection treeLock;
+
+	//path-scoped syncs requested by the server, processed by the thread
+	CriticalSection syncLock;
+	bool fullSyncRequested;
+	StringArray pathsToSync;
 
 	Array<Controllable*> noFeedbackList;
 
 
 	void setupWSClient();
 
+	//Websocket reconnection is handled by the connection supervisor
+	bool isSupervisedConnectionNeeded() override;
+	bool isSupervisedConnected() override;
+	void attemptConnection() override;
+
 	void sendOSC(const OSCMessage& m) override;
 	void sendOSCForControllable(Controllable* c);
 
@@ -75,8 +88,20 @@ public:
 	static OSCArgument varToArgument(const var& v);
 
 	virtual void syncData();
+	void queuePathSync(const String& path);
 	virtual void updateTreeFromData(var data);
 
+	//Structure diff
+	void diffContainer(ControllableContainer* cc, var oldData, var newData);
+	void updateContainerStructure(ControllableContainer* cc, var data);
+	void applyPathData(const String& path, var nodeData);
+	ControllableContainer* getChildContainerForKey(ControllableContainer* cc, const String& key, var nodeData);
+	Controllable* getChildControllableForKey(ControllableContainer* cc, const String& key, var nodeData);
+
+	static bool isContainerNode(const var& data) { return data.hasProperty("CONTENTS"); }
+	static bool isNodeDataEqual(const var& a, const var& b, const Identifier& ignoreProperty = Identifier());
+	static var getTreeNode(var root, const String& path);
+
 	void updateAllListens();
 	void updateListenToContainer(OSCQueryHelpers::OSCQueryValueContainer* gcc, bool onlySendIfListen = false);
 
@@ -102,6 +127,7 @@ public:
 	virtual void run() override;
 	virtual void requestHostInfo();
 	virtual void requestStructure();
+	void requestPathStructure(const String& path);
 
 	//Routing
 	class OSCQueryRouteParams :
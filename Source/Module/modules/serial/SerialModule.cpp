@@ -12,7 +12,11 @@
 
 SerialModule::SerialModule(const String& name) :
 	StreamingModule(name),
-	port(nullptr)
+	port(nullptr),
+	readPos(0),
+	scanPos(0),
+	writePos(0),
+	firstPendingTime(0)
 {
 	portParam = new SerialDeviceParameter("Port", "Serial Port to connect", true);
 	portParam->openOnSet = false;
@@ -25,6 +29,14 @@ SerialModule::SerialModule(const String& name) :
 	portParam->setDTR(dtr->boolValue());
 	portParam->setDTR(rts->boolValue());
 
+	receiveBatchSize = moduleParams.addIntParameter("Receive Batch Size", "Minimum number of new bytes before incoming data is parsed. 1 parses every chunk as soon as it arrives, higher values lower the load on fast links", 1, 1, receiveBufferSize / 2);
+	receiveMaxLatency = moduleParams.addIntParameter("Receive Max Latency", "When batching, maximum time in milliseconds incoming data can wait before being parsed", 5, 1, 1000);
+	frameLength = moduleParams.addIntParameter("Frame Length", "In Raw mode, if not 0, incoming bytes are split in frames of this size instead of being processed as they come", 0, 0, receiveBufferSize / 2);
+
+	receiveBuffer.malloc(receiveBufferSize);
+	frameBuffer.malloc(receiveBufferSize);
+	decodeBuffer.malloc(receiveBufferSize);
+
 	isConnected = moduleParams.addBoolParameter("Is Connected", "This is checked if a serial port is connected.", false);
 	isConnected->setControllableFeedbackOnly(true);
 	isConnected->isSavable = false;
@@ -32,10 +44,13 @@ SerialModule::SerialModule(const String& name) :
 
 	SerialManager::getInstance()->addSerialManagerListener(this);
 
+	updateReceiveTimer();
 }
 
 SerialModule::~SerialModule()
 {
+	stopTimer();
+
 	if (SerialManager::getInstanceWithoutCreating() != nullptr)
 	{
 		SerialManager::getInstance()->removeSerialManagerListener(this);
@@ -56,7 +71,7 @@ bool SerialModule::setPortStatus(bool status)
 
 	if (shouldOpen)  //We want to open the port, it's not already opened and the module is enabled
 	{
-		port->setMode(streamingType->getValueDataAsEnum<SerialDevice::PortMode>()); //always set mode, port might be already open with default mode
+		port->setMode(SerialDevice::RAW); //always set mode, port might be already open with default mode. Framing is done on the module's receive buffer
 		port->setBaudRate(baudRate->intValue());
 		setupPortInternal();
 		if (port->isOpen()) port->close();
@@ -98,6 +113,11 @@ void SerialModule::setCurrentPort(SerialDevice* _port)
 
 	port = _port;
 
+	{
+		GenericScopedLock lock(receiveLock);
+		clearReceiveBuffer();
+	}
+
 	if (port != nullptr)
 	{
 		setPortStatus(true);
@@ -154,9 +174,14 @@ void SerialModule::onControllableFeedbackUpdateInternal(ControllableContainer* c
 			DBG("Manually set no ghost port");
 			lastOpenedPortID = ""; //forces no ghosting when user chose to manually disable port
 		}
-	}if (c == streamingType)
+	}if (c == streamingType || c == frameLength)
+	{
+		GenericScopedLock lock(receiveLock);
+		clearReceiveBuffer();
+	}
+	else if (c == receiveBatchSize || c == receiveMaxLatency)
 	{
-		if (port != nullptr) port->setMode((SerialDevice::PortMode)(int)streamingType->getValueData());
+		updateReceiveTimer();
 	}
 }
 bool SerialModule::isReadyToSend()
@@ -200,32 +225,172 @@ void SerialModule::portRemoved(SerialDevice*)
 
 void SerialModule::serialDataReceived(SerialDevice*, const var& data)
 {
-	switch (port->mode)
+	if (data.isBinaryData() && data.getBinaryData() != nullptr)
 	{
-
-	case SerialDevice::LINES:
+		receiveData((const uint8*)data.getBinaryData()->getData(), (int)data.getBinaryData()->getSize());
+	}
+	else if (data.isString())
+	{
+		//the port was set to lines mode from somewhere else
 		processDataLine(data.toString());
-		break;
+	}
+	else
+	{
+		NLOGWARNING(niceName, "Wrong data type detected, skipping");
+	}
+}
+
+void SerialModule::receiveData(const uint8* data, int numBytes)
+{
+	if (numBytes <= 0) return;
 
-	case SerialDevice::DATA255:
-	case SerialDevice::RAW:
-	case SerialDevice::COBS:
-		if (data.isBinaryData() && data.getBinaryData() != nullptr)
+	GenericScopedLock lock(receiveLock);
+
+	if (numBytes > receiveBufferSize - (int)(writePos - readPos))
+	{
+		processReceiveBuffer();
+
+		if (numBytes > receiveBufferSize - (int)(writePos - readPos))
 		{
-			Array<uint8> bytes((const uint8_t*)data.getBinaryData()->getData(), (int)data.getBinaryData()->getSize());
-			processDataBytes(bytes);
+			NLOGWARNING(niceName, "Receive buffer full, dropping " << (int)(writePos - readPos) << " bytes without frame end");
+			clearReceiveBuffer();
+
+			if (numBytes > receiveBufferSize)
+			{
+				data += numBytes - receiveBufferSize;
+				numBytes = receiveBufferSize;
+			}
 		}
-		else
+	}
+
+	if (scanPos == writePos) firstPendingTime = Time::getMillisecondCounterHiRes();
+
+	int start = (int)(writePos & (receiveBufferSize - 1));
+	int firstPart = jmin(numBytes, receiveBufferSize - start);
+	memcpy(receiveBuffer + start, data, (size_t)firstPart);
+	if (numBytes > firstPart) memcpy(receiveBuffer.get(), data + firstPart, (size_t)(numBytes - firstPart));
+	writePos += (uint32)numBytes;
+
+	if ((int)(writePos - scanPos) >= receiveBatchSize->intValue()) processReceiveBuffer();
+}
+
+void SerialModule::processReceiveBuffer()
+{
+	StreamingType t = streamingType->getValueDataAsEnum<StreamingType>();
+
+	switch (t)
+	{
+	case LINES:
+	case DATA255:
+	case COBS:
+	{
+		const uint8 delimiter = t == LINES ? '\n' : (t == DATA255 ? 255 : 0);
+
+		while (scanPos != writePos)
 		{
-			NLOGWARNING(niceName, "Wrong data type detected, skipping");
+			int start = (int)(scanPos & (receiveBufferSize - 1));
+			int numBytes = jmin((int)(writePos - scanPos), receiveBufferSize - start);
+			const uint8* found = (const uint8*)memchr(receiveBuffer + start, delimiter, (size_t)numBytes);
+
+			if (found == nullptr)
+			{
+				scanPos += (uint32)numBytes;
+				continue;
+			}
+
+			uint32 endPos = scanPos + (uint32)(found - (receiveBuffer + start));
+			int frameSize = (int)(endPos - readPos) + (t == COBS ? 1 : 0); //COBS decoding expects the terminating zero
+			processFrame(t, getFrameData(readPos, frameSize), frameSize);
+
+			readPos = scanPos = endPos + 1;
 		}
+	}
+	break;
+
+	case RAW:
+	{
+		int length = frameLength->intValue();
+		if (length > 0)
+		{
+			while ((int)(writePos - readPos) >= length)
+			{
+				processFrame(t, getFrameData(readPos, length), length);
+				readPos += (uint32)length;
+			}
+		}
+		else if (writePos != readPos)
+		{
+			int numBytes = (int)(writePos - readPos);
+			processFrame(t, getFrameData(readPos, numBytes), numBytes);
+			readPos = writePos;
+		}
+
+		scanPos = writePos;
+	}
+	break;
+
+	default:
+		readPos = scanPos = writePos;
 		break;
+	}
+}
+
+const uint8* SerialModule::getFrameData(uint32 start, int numBytes)
+{
+	int offset = (int)(start & (receiveBufferSize - 1));
+	if (offset + numBytes <= receiveBufferSize) return receiveBuffer + offset;
+
+	int firstPart = receiveBufferSize - offset;
+	memcpy(frameBuffer.get(), receiveBuffer + offset, (size_t)firstPart);
+	memcpy(frameBuffer + firstPart, receiveBuffer.get(), (size_t)(numBytes - firstPart));
+	return frameBuffer.get();
+}
+
+void SerialModule::processFrame(StreamingType t, const uint8* data, int numBytes)
+{
+	switch (t)
+	{
+	case LINES:
+	{
+		if (numBytes > 0 && data[numBytes - 1] == '\r') numBytes--;
+		if (CharPointer_UTF8::isValidString((const char*)data, numBytes)) processDataLine(String::fromUTF8((const char*)data, numBytes));
+	}
+	break;
+
+	case COBS:
+	{
+		if (numBytes < 2) return;
+		size_t numDecoded = cobs_decode(const_cast<uint8*>(data), (size_t)numBytes, decodeBuffer.get());
+		if (numDecoded > 1) processDataBytes(decodeBuffer.get(), (int)numDecoded - 1);
+	}
+	break;
 
 	default:
+		if (numBytes > 0) processDataBytes(data, numBytes);
 		break;
 	}
 }
 
+void SerialModule::clearReceiveBuffer()
+{
+	readPos = scanPos = writePos = 0;
+}
+
+void SerialModule::updateReceiveTimer()
+{
+	if (receiveBatchSize->intValue() > 1) startTimer(jmax(1, receiveMaxLatency->intValue() / 2));
+	else stopTimer();
+}
+
+void SerialModule::hiResTimerCallback()
+{
+	GenericScopedLock lock(receiveLock);
+	if (scanPos == writePos) return;
+	if (Time::getMillisecondCounterHiRes() - firstPendingTime < receiveMaxLatency->intValue()) return;
+
+	processReceiveBuffer();
+}
+
 var SerialModule::getJSONData(bool includeNonOverriden)
 {
 	var data = StreamingModule::getJSONData(includeNonOverriden);
@@ -13,7 +13,8 @@
 class SerialModule :
 	public StreamingModule,
 	public SerialDevice::SerialDeviceListener,
-	public SerialManager::SerialManagerListener
+	public SerialManager::SerialManagerListener,
+	public HighResolutionTimer
 {
 public:
 	SerialModule(const String& name = "Serial");
@@ -31,6 +32,30 @@ public:
 	SerialDevice* port;
 	BoolParameter* isConnected;
 
+	IntParameter* receiveBatchSize;
+	IntParameter* receiveMaxLatency;
+	IntParameter* frameLength;
+
+	//Receive ring buffer, allocated once. The port is read in raw mode and frames are cut directly in this buffer
+	static constexpr int receiveBufferSize = 1 << 16;
+	CriticalSection receiveLock;
+	HeapBlock<uint8> receiveBuffer;
+	HeapBlock<uint8> frameBuffer; //frames that wrap around the end of the ring are made contiguous here
+	HeapBlock<uint8> decodeBuffer; //for COBS
+	uint32 readPos; //positions are free running and masked when accessing the buffer
+	uint32 scanPos;
+	uint32 writePos;
+	double firstPendingTime;
+
+	void receiveData(const uint8* data, int numBytes);
+	void processReceiveBuffer();
+	const uint8* getFrameData(uint32 start, int numBytes);
+	void processFrame(StreamingType t, const uint8* data, int numBytes);
+	void clearReceiveBuffer();
+	void updateReceiveTimer();
+
+	virtual void hiResTimerCallback() override;
+
 	virtual void setCurrentPort(SerialDevice* port);
 	virtual bool setPortStatus(bool status);
 	virtual void setupPortInternal() {}
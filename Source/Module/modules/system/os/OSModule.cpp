@@ -35,6 +35,8 @@
 #define CLOSESOCKET closesocket
 #else
 #include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
 #include <arpa/inet.h>
 #include <netinet/ip_icmp.h>
 #include <netinet/in.h>
@@ -80,10 +82,14 @@ OSModule::OSModule() :
 	Thread("OS-ChildProcess"),
 	osInfoCC("OS Infos"),
 	networkInfoCC("Network Infos"),
+	processesCC("Processes"),
 	appControlNamesCC("App Control"),
 	appControlStatusCC("App Control"),
 	pingIPsCC("Ping IPs"),
 	pingStatusCC("Ping Status"),
+	pingRTTCC("Ping RTT"),
+	pingLossCC("Ping Loss"),
+	lastProcessId(0),
 	osThread(this),
 	pingThread(this)
 {
@@ -98,6 +104,12 @@ OSModule::OSModule() :
 	pingInterval = moduleParams.addIntParameter("Ping Interval", "Time between each ping routine, in seconds.", 5);
 	pingTimeout = moduleParams.addFloatParameter("Ping Timeout", "Timeout for each ping routine, in seconds.", 0.5f, 0.1f, 10.0f);
 
+	maxConcurrentProcesses = moduleParams.addIntParameter("Max Concurrent Processes", "Maximum number of processes launched from scripts running at the same time, the others wait for a free slot. A change applies to the next launched process, the ones already running or queued keep their slots", 4, 1, 64);
+	processTimeout = moduleParams.addFloatParameter("Process Timeout", "If enabled, processes launched from scripts that run longer than this are killed", 10, .1f);
+	processTimeout->defaultUI = FloatParameter::TIME;
+	processTimeout->canBeDisabledByUser = true;
+	processTimeout->setEnabled(false);
+
 	appControlNamesCC.userCanAddControllables = true;
 	appControlNamesCC.customUserCreateControllableFunc = std::bind(&OSModule::appControlCreateControllable, this, std::placeholders::_1);
 	moduleParams.addChildControllableContainer(&appControlNamesCC);
@@ -136,6 +148,8 @@ OSModule::OSModule() :
 
 	ips = networkInfoCC.addStringParameter("IP", "IP that has been detected than most probable to be a LAN IP", NetworkHelpers::getLocalIP());
 	networkInfoCC.addChildControllableContainer(&pingStatusCC);
+	networkInfoCC.addChildControllableContainer(&pingRTTCC);
+	networkInfoCC.addChildControllableContainer(&pingLossCC);
 	valuesCC.addChildControllableContainer(&networkInfoCC);
 
 	Array<MACAddress> macList = MACAddress::getAllAddresses();
@@ -145,6 +159,14 @@ OSModule::OSModule() :
 	mac = networkInfoCC.addStringParameter("MAC", "Mac address of the IP", macs);
 	mac->multiline = true;
 
+	runningProcesses = processesCC.addIntParameter("Running Processes", "Number of processes launched from scripts that are currently running", 0, 0);
+	lastProcessCommand = processesCC.addStringParameter("Last Command", "Command of the last process that finished", "");
+	lastProcessExitCode = processesCC.addIntParameter("Last Exit Code", "Exit code of the last process that finished, -1 if it could not be started", 0);
+	lastProcessDuration = processesCC.addFloatParameter("Last Duration", "Running time of the last process that finished", 0, 0);
+	lastProcessDuration->defaultUI = FloatParameter::TIME;
+	processFinished = processesCC.addTrigger("Process Finished", "Triggered each time a process launched from scripts finishes");
+	valuesCC.addChildControllableContainer(&processesCC);
+
 
 	Array<WeakReference<Controllable>> cont = valuesCC.getAllControllables(true);
 	for (auto& c : cont) c->isControllableFeedbackOnly = true;
@@ -167,6 +189,7 @@ OSModule::OSModule() :
 	scriptObject.getDynamicObject()->setMethod(launchProcessId, &OSModule::launchProcessFromScript);
 	scriptObject.getDynamicObject()->setMethod(getRunningProcessesId, &OSModule::getRunningProcessesFromScript);
 	scriptObject.getDynamicObject()->setMethod(isProcessRunningId, &OSModule::isProcessRunningFromScript);
+	scriptObject.getDynamicObject()->setMethod(stopProcessId, &OSModule::stopProcessFromScript);
 
 	startTimer(OS_IP_TIMER, 5000);
 	startTimer(OS_APP_TIMER, 1000);
@@ -178,7 +201,10 @@ OSModule::~OSModule()
 {
 	stopTimer(OS_IP_TIMER);
 	stopTimer(OS_APP_TIMER);
-	stopThread(100);
+	stopAllChildProcesses();
+	processPool.reset();
+	retiredProcessPools.clear();
+	stopThread(1000);
 	pingThread.stopThread(2000);
 	osThread.stopThread(2000);
 }
@@ -221,10 +247,35 @@ void OSModule::launchCommand(const String& command, bool silentMode)
 	outActivityTrigger->trigger();
 }
 
-void OSModule::launchChildProcess(const String& command)
+int OSModule::launchChildProcess(const String& command)
 {
-	commandsToRun.add(command);
+	int processId = 0;
+
+	{
+		GenericScopedLock lock(processLock);
+
+		for (int i = retiredProcessPools.size() - 1; i >= 0; i--) if (retiredProcessPools[i]->getNumJobs() == 0) retiredProcessPools.remove(i);
+
+		//a pool can't be resized, a busy one is retired and keeps running its jobs while new ones go to the new pool
+		int numThreads = maxConcurrentProcesses->intValue();
+		if (processPool != nullptr && processPool->getNumThreads() != numThreads)
+		{
+			if (processPool->getNumJobs() > 0) retiredProcessPools.add(processPool.release());
+			else processPool.reset();
+		}
+
+		if (processPool == nullptr) processPool.reset(new ThreadPool(numThreads));
+
+		//the pool owns and may delete the job as soon as it's added, keep the id locally
+		processId = ++lastProcessId;
+		processPool->addJob(new ProcessJob(this, processId, command, processTimeout->enabled ? processTimeout->floatValue() * 1000 : 0), true);
+	}
+
+	if (logOutgoingData->boolValue()) NLOG(niceName, "Launching process " << processId << " : " << command);
+	outActivityTrigger->trigger();
+
 	startThread();
+	return processId;
 }
 
 String OSModule::launchChildProcessBlocking(const String& command)
@@ -302,19 +353,38 @@ void OSModule::updatePingStatusValues()
 {
 	pingThread.stopThread(2000);
 	var data = pingStatusCC.getJSONData();
+	var rttData = pingRTTCC.getJSONData();
+	var lossData = pingLossCC.getJSONData();
 	pingStatusCC.clear();
+	pingRTTCC.clear();
+	pingLossCC.clear();
 
 	for (auto& c : pingIPsCC.controllables)
 	{
 		String s = ((StringParameter*)c)->niceName;
-		BoolParameter* b = pingStatusCC.addBoolParameter(s.isNotEmpty() ? s : "[noip]", "Status for this IP", false);
+		if (s.isEmpty()) s = "[noip]";
+
+		BoolParameter* b = pingStatusCC.addBoolParameter(s, "Status for this IP", false);
 		b->saveValueOnly = false;
+
+		FloatParameter* rtt = pingRTTCC.addFloatParameter(s, "Round trip time of the last reply from this IP, in milliseconds. 0 if the last ping had no reply", 0, 0);
+		rtt->saveValueOnly = false;
+
+		FloatParameter* loss = pingLossCC.addFloatParameter(s, "Ratio of pings without reply for this IP, over the last " + String(PingThread::lossHistorySize) + " pings", 0, 0, 1);
+		loss->saveValueOnly = false;
 	}
 
 	pingStatusCC.loadJSONData(data, false); //force reload styles
-	for (auto& c : pingIPsCC.controllables)
+	pingRTTCC.loadJSONData(rttData, false);
+	pingLossCC.loadJSONData(lossData, false);
+
+	for (auto& cc : { &pingStatusCC, &pingRTTCC, &pingLossCC })
 	{
-		if (BoolParameter* p = dynamic_cast<BoolParameter*>(c)) p->setValue(false);
+		for (auto& c : cc->controllables)
+		{
+			c->isControllableFeedbackOnly = true;
+			((Parameter*)c)->resetValue();
+		}
 	}
 
 	if (enabled->boolValue() && pingIPsCC.controllables.size() > 0) pingThread.startThread();
@@ -328,8 +398,15 @@ var OSModule::launchProcessFromScript(const var::NativeFunctionArgs& args)
 	if (!checkNumArgs(m->niceName, args, 1)) return var();
 
 	if (args.numArguments > 1 && (int)args.arguments[1] > 0) return m->launchChildProcessBlocking(args.arguments[0].toString());
-	else m->launchChildProcess(args.arguments[0]);
+	return m->launchChildProcess(args.arguments[0]);
+}
 
+var OSModule::stopProcessFromScript(const var::NativeFunctionArgs& args)
+{
+	OSModule* m = getObjectFromJS<OSModule>(args);
+	if (!checkNumArgs(m->niceName, args, 1)) return var();
+
+	m->stopChildProcess((int)args.arguments[0]);
 	return var();
 }
 
@@ -478,32 +555,218 @@ void OSModule::timerCallback(int timerID)
 	}
 }
 
+void OSModule::stopChildProcess(int id)
+{
+	GenericScopedLock lock(processLock);
+	for (auto& job : activeProcesses)
+	{
+		if (job->id != id) continue;
+		job->process.kill();
+		return;
+	}
+}
+
+void OSModule::stopAllChildProcesses()
+{
+	{
+		GenericScopedLock lock(processLock);
+		for (auto& job : activeProcesses) job->process.kill();
+	}
+
+	//jobs need the lock to finish
+	if (processPool != nullptr) processPool->removeAllJobs(true, 2000);
+	for (auto& p : retiredProcessPools) p->removeAllJobs(true, 2000);
+}
+
+void OSModule::addProcessOutput(ProcessJob* job, const StringArray& lines, bool finished)
+{
+	GenericScopedLock lock(processLock);
+
+	//merge with the pending batch of this process if there is one
+	ProcessOutput* output = nullptr;
+	for (int i = processOutputs.size() - 1; i >= 0; i--)
+	{
+		if (processOutputs[i]->id != job->id) continue;
+		if (!processOutputs[i]->finished) output = processOutputs[i];
+		break;
+	}
+
+	if (output == nullptr)
+	{
+		output = processOutputs.add(new ProcessOutput());
+		output->id = job->id;
+		output->command = job->command;
+	}
+
+	output->lines.addArray(lines);
+
+	if (finished)
+	{
+		output->finished = true;
+		output->timedOut = job->timedOut;
+		output->exitCode = (!job->started || job->process.isRunning()) ? -1 : (int)job->process.getExitCode();
+		output->duration = (Time::getMillisecondCounterHiRes() - job->startTime) / 1000.0;
+	}
+}
+
+void OSModule::checkProcessTimeouts()
+{
+	double now = Time::getMillisecondCounterHiRes();
+
+	GenericScopedLock lock(processLock);
+	for (auto& job : activeProcesses)
+	{
+		if (job->timeoutMS <= 0 || job->timedOut || now - job->startTime < job->timeoutMS) continue;
+		job->timedOut = true;
+		job->process.kill();
+	}
+}
+
+void OSModule::dispatchProcessOutputs()
+{
+	OwnedArray<ProcessOutput> outputs;
+	int numRunning = 0;
+
+	{
+		GenericScopedLock lock(processLock);
+		outputs.swapWith(processOutputs);
+		numRunning = activeProcesses.size();
+	}
+
+	runningProcesses->setValue(numRunning);
+
+	for (auto& o : outputs)
+	{
+		if (threadShouldExit()) return;
+
+		if (!o->lines.isEmpty())
+		{
+			String text = o->lines.joinIntoString("\n");
+			if (logIncomingData->boolValue()) NLOG(niceName, "Process " << o->id << " :\n" << text);
+			inActivityTrigger->trigger();
+
+			var lines;
+			for (auto& l : o->lines) lines.append(l);
+
+			Array<var> args;
+			args.add(text);
+			args.add(o->command);
+			args.add(lines);
+			args.add(o->id);
+			scriptManager->callFunctionOnAllItems("processDataReceived", args);
+		}
+
+		if (o->finished)
+		{
+			if (o->timedOut) NLOGWARNING(niceName, "Process " << o->id << " timed out and was killed : " << o->command);
+			else if (logIncomingData->boolValue()) NLOG(niceName, "Process " << o->id << " finished with code " << o->exitCode << " in " << String(o->duration, 3) << "s");
+
+			lastProcessCommand->setValue(o->command);
+			lastProcessExitCode->setValue(o->exitCode);
+			lastProcessDuration->setValue(o->duration);
+			processFinished->trigger();
+
+			Array<var> args;
+			args.add(o->command);
+			args.add(o->exitCode);
+			args.add(o->duration);
+			args.add(o->id);
+			scriptManager->callFunctionOnAllItems("processFinished", args);
+		}
+	}
+}
+
 void OSModule::run()
 {
-	while (!threadShouldExit() && !commandsToRun.isEmpty())
+	while (!threadShouldExit())
+	{
+		bool isActive = false;
+		{
+			GenericScopedLock lock(processLock);
+			isActive = !activeProcesses.isEmpty() || !processOutputs.isEmpty();
+		}
+
+		//jobs wake this thread when they start and finish, output lines are dispatched in batches in between
+		wait(isActive ? 20 : -1);
+		if (threadShouldExit()) return;
+
+		checkProcessTimeouts();
+		dispatchProcessOutputs();
+	}
+}
+
+OSModule::ProcessJob::ProcessJob(OSModule* m, int id, const String& command, double timeoutMS) :
+	ThreadPoolJob("Process " + String(id)),
+	osModule(m),
+	id(id),
+	command(command),
+	timeoutMS(timeoutMS),
+	startTime(0),
+	started(false),
+	timedOut(false)
+{
+}
+
+ThreadPoolJob::JobStatus OSModule::ProcessJob::runJob()
+{
 	{
-		String command = commandsToRun.removeAndReturn(0);
-		if (command.isEmpty()) continue;
+		GenericScopedLock lock(osModule->processLock);
+		startTime = Time::getMillisecondCounterHiRes(); //timeout starts when the process starts, not when it's queued
+		started = !shouldExit() && process.start(command);
+		if (started) osModule->activeProcesses.add(this);
+	}
 
-		ChildProcess process;
-		process.start(command);
+	osModule->notify();
 
-		char buffer[1024];
-		while (!threadShouldExit() && process.isRunning())
+	if (started)
+	{
+		//output is cut in lines, an incomplete line waits for the rest of its data
+		MemoryBlock pendingData;
+		char buffer[4096];
+
+		while (!shouldExit())
 		{
-			int numRead = process.readProcessOutput(buffer, 1024);
-			if (numRead > 0)
-			{
-				String s(buffer, numRead);
-				Array<var> args;
-				args.add(s);
-				args.add(command);
-				scriptManager->callFunctionOnAllItems("processDataReceived", args);
-			}
+			int numRead = process.readProcessOutput(buffer, sizeof(buffer));
+			if (numRead <= 0) break;
+
+			pendingData.append(buffer, numRead);
+
+			const char* data = (const char*)pendingData.getData();
+			int lastLineEnd = (int)pendingData.getSize() - 1;
+			while (lastLineEnd >= 0 && data[lastLineEnd] != '\n') lastLineEnd--;
+			if (lastLineEnd < 0) continue;
+
+			StringArray lines;
+			lines.addLines(String::fromUTF8(data, lastLineEnd));
+			pendingData.removeSection(0, lastLineEnd + 1);
+
+			osModule->addProcessOutput(this, lines, false);
+		}
+
+		//output closed but the process may still be running, timeouts and stopProcess still apply
+		while (!shouldExit() && process.isRunning()) Thread::sleep(10);
+		if (process.isRunning()) process.kill();
+
+		if (pendingData.getSize() > 0)
+		{
+			StringArray lines;
+			lines.addLines(String::fromUTF8((const char*)pendingData.getData(), (int)pendingData.getSize()));
+			osModule->addProcessOutput(this, lines, false);
 		}
+	}
+	else
+	{
+		NLOGERROR(osModule->niceName, "Could not start process : " << command);
+	}
 
-		process.kill();
+	{
+		GenericScopedLock lock(osModule->processLock);
+		osModule->activeProcesses.removeFirstMatchingValue(this);
+		osModule->addProcessOutput(this, StringArray(), true);
 	}
+
+	osModule->notify();
+	return jobHasFinished;
 }
 
 void OSModule::afterLoadJSONDataInternal()
@@ -520,9 +783,41 @@ void OSModule::afterLoadJSONDataInternal()
 }
 
 
+#if PING_SUPPORT
+static uint32 resolvePingHost(const String& host)
+{
+	uint32 addr = inet_addr(host.toRawUTF8());
+	if (addr != INADDR_NONE) return addr;
+
+	struct addrinfo hints;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_INET;
+
+	struct addrinfo* info = nullptr;
+	if (getaddrinfo(host.toRawUTF8(), nullptr, &hints, &info) != 0 || info == nullptr) return INADDR_NONE;
+
+	addr = ((struct sockaddr_in*)info->ai_addr)->sin_addr.s_addr;
+	freeaddrinfo(info);
+	return addr;
+}
+
+#if !JUCE_WINDOWS
+static uint16 getICMPChecksum(const uint8* data, int size)
+{
+	uint32 sum = 0;
+	for (int i = 0; i + 1 < size; i += 2) sum += (data[i] << 8) | data[i + 1];
+	if (size % 2 == 1) sum += data[size - 1] << 8;
+	while (sum >> 16) sum = (sum & 0xffff) + (sum >> 16);
+	return htons((uint16)~sum);
+}
+#endif
+#endif // PING_SUPPORT
+
 void OSModule::PingThread::run()
 {
 #if PING_SUPPORT
+	OwnedArray<HostState> hosts;
+
 	while (!threadShouldExit() && !moduleRef.wasObjectDeleted())
 	{
 		wait(osModule->pingInterval->intValue() * 1000);
@@ -530,27 +825,47 @@ void OSModule::PingThread::run()
 
 		Array<WeakReference<Parameter>> ipParams = osModule->pingIPsCC.getAllParameters();
 		Array<WeakReference<Parameter>> statusParams = osModule->pingStatusCC.getAllParameters();
+		Array<WeakReference<Parameter>> rttParams = osModule->pingRTTCC.getAllParameters();
+		Array<WeakReference<Parameter>> lossParams = osModule->pingLossCC.getAllParameters();
 
 		if (ipParams.isEmpty()) return;
-		//
+
+		//keep the loss history of hosts that didn't change
+		hosts.removeRange(ipParams.size(), hosts.size());
 		for (int i = 0; i < ipParams.size(); i++)
 		{
-			if (threadShouldExit() || moduleRef.wasObjectDeleted()) return;
-			if (ipParams[i].wasObjectDeleted() || statusParams[i].wasObjectDeleted()) continue;
-			String ip = ipParams[i]->stringValue();
-			if (ip.isEmpty()) continue;
-			//
-			if (osModule->logOutgoingData->boolValue()) NLOG(osModule->niceName, "Pinging " + ipParams[i]->stringValue() + " ...");
+			String ip = ipParams[i].wasObjectDeleted() ? "" : ipParams[i]->stringValue();
+			if (i >= hosts.size()) hosts.add(new HostState());
+			if (hosts[i]->ip != ip)
+			{
+				*hosts[i] = HostState();
+				hosts[i]->ip = ip;
+			}
+		}
+
+		bool logOutgoing = osModule->logOutgoingData->boolValue();
+		if (logOutgoing) NLOG(osModule->niceName, "Pinging " << hosts.size() << " hosts...");
+
+		if (!sweep(hosts)) continue;
+		if (threadShouldExit() || moduleRef.wasObjectDeleted()) return;
+
+		for (int i = 0; i < hosts.size(); i++)
+		{
+			HostState* h = hosts[i];
+			if (h->ip.isEmpty()) continue;
 
-			bool success = icmpPing(ip);
+			h->lostHistory = (h->lostHistory << 1) | (h->replied ? 0 : 1);
+			h->numSweeps = jmin(h->numSweeps + 1, lossHistorySize);
 
-			if (osModule->logOutgoingData->boolValue())
+			if (logOutgoing)
 			{
-				if (success) NLOG(osModule->niceName, ipParams[i]->stringValue() << " is alive");
-				else NLOGWARNING(osModule->niceName, ipParams[i]->stringValue() << " is dead");
+				if (h->replied) NLOG(osModule->niceName, h->ip << " is alive (" << String(h->rtt, 1) << " ms)");
+				else NLOGWARNING(osModule->niceName, h->ip << " is dead");
 			}
 
-			if (!statusParams[i].wasObjectDeleted()) statusParams[i]->setValue(success);
+			if (i < statusParams.size() && !statusParams[i].wasObjectDeleted()) statusParams[i]->setValue(h->replied);
+			if (i < rttParams.size() && !rttParams[i].wasObjectDeleted()) rttParams[i]->setValue(h->replied ? h->rtt : 0);
+			if (i < lossParams.size() && !lossParams[i].wasObjectDeleted()) lossParams[i]->setValue(h->getLoss());
 		}
 	}
 
@@ -558,117 +873,186 @@ void OSModule::PingThread::run()
 #endif
 }
 
-bool OSModule::PingThread::icmpPing(const String& host)
+bool OSModule::PingThread::sweep(OwnedArray<HostState>& hosts)
 {
 #if PING_SUPPORT
-	int timeout_ms = osModule->pingTimeout->floatValue() * 1000;
+	int timeoutMS = (int)(osModule->pingTimeout->floatValue() * 1000);
+	for (auto& h : hosts) h->replied = false;
 
 #if JUCE_WINDOWS
-	HANDLE hIcmpFile = IcmpCreateFile();
-	if (hIcmpFile == INVALID_HANDLE_VALUE) {
-		DBG("IcmpCreateFile failed");
+	//IcmpSendEcho2 with an event returns immediately, so all requests are in flight together
+	HANDLE icmpFile = IcmpCreateFile();
+	if (icmpFile == INVALID_HANDLE_VALUE)
+	{
+		osModule->setWarningMessage("Could not create ICMP handle for ping check : " + String((int)GetLastError()), "ping");
 		return false;
 	}
 
-	const int bufferSize = 32; // Size of the buffer in bytes
-	BYTE sendBuffer[bufferSize];
-	memset(sendBuffer, 'E', sizeof(sendBuffer)); // Filling buffer with arbitrary data
+	osModule->clearWarning("ping");
 
-	int replySize = sizeof(ICMP_ECHO_REPLY) + bufferSize;
-	LPVOID replyBuffer = malloc(replySize);
-	if (replyBuffer == nullptr) {
-		DBG("Memory allocation error");
-		IcmpCloseHandle(hIcmpFile);
-		return false;
+	struct PendingRequest
+	{
+		HANDLE event = nullptr;
+		HeapBlock<uint8> reply;
+		HostState* host = nullptr;
+	};
+
+	const int payloadSize = 32;
+	uint8 payload[payloadSize];
+	memset(payload, 'E', payloadSize);
+	const DWORD replySize = sizeof(ICMP_ECHO_REPLY) + payloadSize + 8;
+
+	OwnedArray<PendingRequest> requests;
+	for (auto& h : hosts)
+	{
+		if (h->ip.isEmpty()) continue;
+		uint32 addr = resolvePingHost(h->ip);
+		if (addr == INADDR_NONE) continue;
+
+		PendingRequest* r = new PendingRequest();
+		r->event = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+		r->reply.calloc(replySize);
+		r->host = h;
+		h->sendTime = Time::getMillisecondCounterHiRes();
+
+		DWORD result = IcmpSendEcho2(icmpFile, r->event, nullptr, nullptr, addr, payload, payloadSize, nullptr, r->reply.getData(), replySize, timeoutMS);
+		if (result == 0 && GetLastError() != ERROR_IO_PENDING)
+		{
+			CloseHandle(r->event);
+			delete r;
+			continue;
+		}
+
+		requests.add(r);
 	}
 
-	DWORD reply = IcmpSendEcho(hIcmpFile, inet_addr(host.toStdString().c_str()), sendBuffer, sizeof(sendBuffer), nullptr, replyBuffer, replySize, timeout_ms);
+	//each request times out by itself, waiting for them one after the other still takes one timeout overall
+	double deadline = Time::getMillisecondCounterHiRes() + timeoutMS + 100;
+	for (auto& r : requests)
+	{
+		DWORD remaining = (DWORD)jmax(0.0, deadline - Time::getMillisecondCounterHiRes());
+		DWORD waitResult = WaitForSingleObject(r->event, remaining);
+		if (waitResult != WAIT_OBJECT_0) waitResult = WaitForSingleObject(r->event, 1000); //the reply buffer must not be freed while the request is pending
 
-	bool success = false;
-	if (reply != 0) {
-		success = true;
-		//LOG("ICMP echo request successful");
-		// Process the ICMP echo reply if needed
-	}
-	else {
-		DBG("ICMP echo request failed: " << GetLastError());
-	}
+		if (waitResult == WAIT_OBJECT_0 && IcmpParseReplies(r->reply.getData(), replySize) > 0)
+		{
+			ICMP_ECHO_REPLY* echoReply = (ICMP_ECHO_REPLY*)r->reply.getData();
+			if (echoReply->Status == IP_SUCCESS)
+			{
+				r->host->replied = true;
+				r->host->rtt = echoReply->RoundTripTime;
+			}
+		}
 
-	free(replyBuffer);
-	IcmpCloseHandle(hIcmpFile);
+		CloseHandle(r->event);
+	}
 
-	return success;
+	IcmpCloseHandle(icmpFile);
+	return true;
 
-#elif JUCE_LINUX
-	int sock = socket(AF_INET, SOCK_RAW, IPPROTO_ICMP);
-	if (sock < 0) {
-		DBG("Socket creation error " << sock);
-        osModule->setWarningMessage("Could create socket for ping check : "+String(sock), "ping");
-		return false;
+#else
+	//Unprivileged datagram ICMP socket when the system allows it, raw socket otherwise
+	bool isDatagram = true;
+	int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_ICMP);
+	if (sock < 0)
+	{
+		isDatagram = false;
+		sock = socket(AF_INET, SOCK_RAW, IPPROTO_ICMP);
 	}
-    
-    osModule->clearWarning("ping");
-
-	struct timeval tv;
-	tv.tv_sec = timeout_ms / 1000;
-	tv.tv_usec = (timeout_ms % 1000) * 1000;
-	setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&tv), sizeof(tv));
-
-	char packet[1024];
-	memset(packet, 0, sizeof(packet));
-
-	struct icmphdr* icmp = reinterpret_cast<struct icmphdr*>(packet);
-	icmp->type = ICMP_ECHO;
-	icmp->code = 0;
-	icmp->checksum = 0;
-	icmp->un.echo.id = getpid();
-	icmp->un.echo.sequence = 0;
-	icmp->checksum = 0; // Calculate checksum
-
-	struct sockaddr_in dest_addr;
-	memset(&dest_addr, 0, sizeof(dest_addr));
-	dest_addr.sin_family = AF_INET;
-	dest_addr.sin_addr.s_addr = inet_addr(host.toStdString().c_str());
-
-	int bytes_sent = sendto(sock, packet, sizeof(packet), 0, reinterpret_cast<struct sockaddr*>(&dest_addr), sizeof(dest_addr));
-	if (bytes_sent == -1 || bytes_sent != sizeof(packet)) {
-		LOGWARNING("Error sending ICMP packet, you may need administrator/root privileges");
-		close(sock);
+
+	if (sock < 0)
+	{
+		osModule->setWarningMessage("Could not create socket for ping check, you may need administrator/root privileges : " + String(strerror(errno)), "ping");
 		return false;
 	}
 
-	// Receive ICMP reply
-	struct sockaddr_in from;
-	socklen_t fromlen = sizeof(from);
-	int bytes_received = recvfrom(sock, packet, sizeof(packet), 0, reinterpret_cast<struct sockaddr*>(&from), &fromlen);
+	osModule->clearWarning("ping");
+	fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
 
-	if (bytes_received > 0) {
-		DBG("Received ICMP reply");
-		// Process the ICMP reply if needed
-	}
-	else if (bytes_received == 0) {
-		DBG("No data received");
-	}
-	else {
-		if (errno == EAGAIN || errno == EWOULDBLOCK) {
-			DBG("Timeout reached");
+#if JUCE_LINUX
+	bool checkId = !isDatagram; //the kernel rewrites the id of datagram ICMP sockets, and only gives them their own replies
+#else
+	bool checkId = true;
+#endif
+
+	HashMap<int, HostState*> pendingHosts; //by sequence
+
+	for (auto& h : hosts)
+	{
+		if (h->ip.isEmpty()) continue;
+
+		struct sockaddr_in destAddr;
+		memset(&destAddr, 0, sizeof(destAddr));
+		destAddr.sin_family = AF_INET;
+		destAddr.sin_addr.s_addr = resolvePingHost(h->ip);
+		if (destAddr.sin_addr.s_addr == INADDR_NONE) continue;
+
+		uint8 packet[64];
+		memset(packet, 'E', sizeof(packet));
+
+		struct icmphdr* icmp = reinterpret_cast<struct icmphdr*>(packet);
+		icmp->type = ICMP_ECHO;
+		icmp->code = 0;
+		icmp->checksum = 0;
+		icmp->un.echo.id = htons(pingId);
+		icmp->un.echo.sequence = htons(++sequence);
+		icmp->checksum = getICMPChecksum(packet, sizeof(packet));
+
+		h->sendTime = Time::getMillisecondCounterHiRes();
+		if (sendto(sock, packet, sizeof(packet), 0, reinterpret_cast<struct sockaddr*>(&destAddr), sizeof(destAddr)) != sizeof(packet))
+		{
+			DBG("Error sending ICMP packet to " << h->ip << " : " << strerror(errno));
+			continue;
 		}
-		else {
-			DBG("Receive error: " << strerror(errno));
+
+		pendingHosts.set(sequence, h);
+	}
+
+	double deadline = Time::getMillisecondCounterHiRes() + timeoutMS;
+	uint8 buffer[1500];
+
+	while (pendingHosts.size() > 0 && !threadShouldExit())
+	{
+		int remaining = (int)std::ceil(deadline - Time::getMillisecondCounterHiRes());
+		if (remaining <= 0) break;
+
+		struct pollfd pfd;
+		pfd.fd = sock;
+		pfd.events = POLLIN;
+		pfd.revents = 0;
+		if (poll(&pfd, 1, jmin(remaining, 100)) <= 0) continue;
+
+		//drain everything that arrived
+		while (pendingHosts.size() > 0)
+		{
+			struct sockaddr_in from;
+			socklen_t fromLen = sizeof(from);
+			int numRead = (int)recvfrom(sock, buffer, sizeof(buffer), 0, reinterpret_cast<struct sockaddr*>(&from), &fromLen);
+			if (numRead <= 0) break;
+
+			double receiveTime = Time::getMillisecondCounterHiRes();
+
+			//raw sockets (and datagram sockets on macOS) also give the IP header
+			int offset = (buffer[0] >> 4) == 4 ? (buffer[0] & 0x0f) * 4 : 0;
+			if (numRead < offset + 8) continue;
+
+			struct icmphdr* reply = reinterpret_cast<struct icmphdr*>(buffer + offset);
+			if (reply->type != ICMP_ECHOREPLY) continue;
+			if (checkId && ntohs(reply->un.echo.id) != pingId) continue;
+
+			int seq = ntohs(reply->un.echo.sequence);
+			if (!pendingHosts.contains(seq)) continue;
+
+			HostState* h = pendingHosts[seq];
+			pendingHosts.remove(seq);
+
+			h->replied = true;
+			h->rtt = receiveTime - h->sendTime;
 		}
 	}
 
 	close(sock);
-	return true; // Placeholder for successful ping
-#elif JUCE_MAC
-    
-    String command = String("ping -c 3 "+host);
-        
-    int result = system(command.toStdString().c_str());
-    
-    return result == 0;
-#else
-	return false; //PLATFORM
+	return true;
 #endif
 
 #else// PING_SUPPORT
@@ -676,6 +1060,13 @@ bool OSModule::PingThread::icmpPing(const String& host)
 #endif // PING_SUPPORT
 }
 
+float OSModule::PingThread::HostState::getLoss() const
+{
+	if (numSweeps == 0) return 0;
+	uint32 mask = numSweeps >= 32 ? 0xffffffff : ((1u << numSweeps) - 1);
+	return countNumberOfBits(lostHistory & mask) * 1.0f / numSweeps;
+}
+
 void OSModule::OSThread::run()
 {
 	while (!threadShouldExit() && !moduleRef.wasObjectDeleted())
@@ -27,6 +27,8 @@ public:
 	Trigger* listIPs;
 	IntParameter* pingInterval; // in seconds
 	FloatParameter* pingTimeout;
+	IntParameter* maxConcurrentProcesses;
+	FloatParameter* processTimeout;
 
 	Trigger* terminateTrigger;
 	Trigger* crashedTrigger;
@@ -43,11 +45,20 @@ public:
 	StringParameter* ips;
 	StringParameter* mac;
 
+	ControllableContainer processesCC;
+	IntParameter* runningProcesses;
+	StringParameter* lastProcessCommand;
+	IntParameter* lastProcessExitCode;
+	FloatParameter* lastProcessDuration;
+	Trigger* processFinished;
+
 	ControllableContainer appControlNamesCC;
 	ControllableContainer appControlStatusCC;
 
 	ControllableContainer pingIPsCC;
 	ControllableContainer pingStatusCC;
+	ControllableContainer pingRTTCC;
+	ControllableContainer pingLossCC;
 
 	static float timeAtProcessStart;
 
@@ -57,9 +68,45 @@ public:
 	const Identifier launchProcessId = "launchProcess";
 	const Identifier getRunningProcessesId = "getRunningProcesses";
 	const Identifier isProcessRunningId = "isProcessRunning";
+	const Identifier stopProcessId = "stopProcess";
+
+	//child processes, run in a pool and their output is sent to scripts line by line, in batches
+	class ProcessJob :
+		public ThreadPoolJob
+	{
+	public:
+		ProcessJob(OSModule* m, int id, const String& command, double timeoutMS);
+		~ProcessJob() {}
+
+		OSModule* osModule;
+		int id;
+		String command;
+		double timeoutMS; //0 means no timeout
+		double startTime;
+		bool started;
+		bool timedOut;
+		ChildProcess process;
+
+		JobStatus runJob() override;
+	};
 
-	//child process
-	Array<String, CriticalSection> commandsToRun;
+	struct ProcessOutput
+	{
+		int id = 0;
+		String command;
+		StringArray lines;
+		bool finished = false;
+		bool timedOut = false;
+		int exitCode = 0;
+		double duration = 0; //seconds
+	};
+
+	std::unique_ptr<ThreadPool> processPool;
+	OwnedArray<ThreadPool> retiredProcessPools; //replaced after a Max Concurrent Processes change, deleted once their jobs are done
+	CriticalSection processLock;
+	Array<ProcessJob*> activeProcesses;
+	OwnedArray<ProcessOutput> processOutputs;
+	int lastProcessId;
 
 	class OSThread :
 		public Thread
@@ -75,18 +122,36 @@ public:
 
 	OSThread osThread;
 
+	//Pings all hosts at once with a single non-blocking ICMP socket, so a sweep takes one timeout whatever the number of hosts
 	class PingThread :
 		public Thread
 	{
 	public:
-		PingThread(OSModule* m) : Thread("Ping"), osModule(m), moduleRef(m) {}
+		PingThread(OSModule* m) : Thread("Ping"), osModule(m), moduleRef(m), pingId((uint16)Random::getSystemRandom().nextInt(0x10000)), sequence(0) {}
 		~PingThread() {}
 
 		OSModule* osModule;
 		WeakReference<Inspectable> moduleRef;
 
+		struct HostState
+		{
+			String ip;
+			bool replied = false;
+			double sendTime = 0;
+			double rtt = 0; //ms
+			uint32 lostHistory = 0; //one bit per sweep, 1 means no reply
+			int numSweeps = 0;
+
+			float getLoss() const;
+		};
+
+		static const int lossHistorySize = 16;
+
+		uint16 pingId;
+		uint16 sequence;
+
 		void run() override;
-		bool icmpPing(const String& host);
+		bool sweep(OwnedArray<HostState>& hosts);
 	};
 
 	PingThread pingThread;
@@ -95,8 +160,13 @@ public:
 
 	bool launchFile(File f, String args = "");
 	void launchCommand(const String& command, bool silentMode);
-	void launchChildProcess(const String& command);
+	int launchChildProcess(const String& command);
 	String launchChildProcessBlocking(const String& command);
+	void stopChildProcess(int id);
+	void stopAllChildProcesses();
+	void addProcessOutput(ProcessJob* job, const StringArray& lines, bool finished);
+	void checkProcessTimeouts();
+	void dispatchProcessOutputs();
 	void killProcess(const String& processName, bool hardKillMode);
 
 	void checkAppControl();
@@ -115,6 +185,7 @@ public:
 	static var launchProcessFromScript(const var::NativeFunctionArgs& args);
 	static var isProcessRunningFromScript(const var::NativeFunctionArgs& args);
 	static var getRunningProcessesFromScript(const var::NativeFunctionArgs& args);
+	static var stopProcessFromScript(const var::NativeFunctionArgs& args);
 
 	bool isProcessRunning(const String& processName);
 	StringArray getRunningProcesses();
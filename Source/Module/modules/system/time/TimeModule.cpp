@@ -9,7 +9,10 @@
 */
 
 TimeModule::TimeModule(const String & name) :
-	Module(name)
+	Module(name),
+	alarmTimesCC("Alarms"),
+	alarmsCC("Alarms"),
+	lastAlarmCheckTime(0)
 {
 	setupIOConfiguration(true, false);
 
@@ -29,34 +32,240 @@ TimeModule::TimeModule(const String & name) :
 	dayTime = valuesCC.addFloatParameter("Full Day Time", "The current time in the day, second accurate.\nA convenient way to check a particular time in the day", 0, 0, 86400); //86400 seconds in a day
 	dayTime->defaultUI = FloatParameter::TIME;
 
-	moduleParams.hideInEditor = true;
+	milliseconds = valuesCC.addIntParameter("Milliseconds", "Current millisecond relative to the current second (0 > 999). Only updated if Sub Second Rate is enabled", 0, 0, 999);
+	preciseDayTime = valuesCC.addFloatParameter("Precise Day Time", "The current time in the day, with milliseconds. Only updated if Sub Second Rate is enabled", 0, 0, 86400);
+	preciseDayTime->defaultUI = FloatParameter::TIME;
+
+	subSecondRate = moduleParams.addIntParameter("Sub Second Rate", "If enabled, Milliseconds and Precise Day Time are updated this many times per second", 10, 1, 100);
+	subSecondRate->canBeDisabledByUser = true;
+	subSecondRate->setEnabled(false);
+
+	alarmTimesCC.userCanAddControllables = true;
+	alarmTimesCC.customUserCreateControllableFunc = std::bind(&TimeModule::alarmTimesCreateControllable, this, std::placeholders::_1);
+	moduleParams.addChildControllableContainer(&alarmTimesCC);
+
+	valuesCC.addChildControllableContainer(&alarmsCC);
+
 	for (auto &c : valuesCC.controllables) c->isControllableFeedbackOnly = true;
 
-	startTimer(1000);
-	timerCallback(); //force one
+	timerCallback(); //force one, it will schedule the next ones
 }
 
 TimeModule::~TimeModule()
 {
-
+	for (auto& c : alarmTimesCC.controllables) c->removeControllableListener(this);
 }
 
 void TimeModule::timerCallback()
 {
+	stopTimer();
 	if (!enabled->boolValue()) return;
+
 	Time time = Time::getCurrentTime();
-	
-	year->setValue(time.getYear());
-	monthName->setValueWithData((Month)time.getMonth());
-	month->setValue(time.getMonth() + 1);
-	monthDay->setValue(time.getDayOfMonth());
-	int wDay = (time.getDayOfWeek() +6) % 7;
-	weekDayName->setValueWithData((Day)wDay);
-	weekDay->setValue(wDay + 1);
-	hour->setValue(time.getHours());
-	minutes->setValue(time.getMinutes());
-	seconds->setValue(time.getSeconds());
-	dayTime->setValue(time.getHours()*3600 + time.getMinutes()*60 + time.getSeconds());
-
-	inActivityTrigger->trigger();
+	updateValues(time);
+	checkAlarms(time);
+
+	//restart the timer to the next boundary so values change on time and don't drift
+	startTimer(getMillisToNextUpdate(Time::getCurrentTime()));
+}
+
+void TimeModule::updateValues(const Time& time)
+{
+	bool changed = false;
+
+	//only notify the values that actually changed
+	auto updateInt = [&changed](IntParameter* p, int value)
+	{
+		if (p->intValue() == value) return;
+		p->setValue(value);
+		changed = true;
+	};
+
+	updateInt(year, time.getYear());
+	if (monthName->getValueDataAsEnum<Month>() != (Month)time.getMonth())
+	{
+		monthName->setValueWithData((Month)time.getMonth());
+		changed = true;
+	}
+	updateInt(month, time.getMonth() + 1);
+	updateInt(monthDay, time.getDayOfMonth());
+
+	int wDay = (time.getDayOfWeek() + 6) % 7;
+	if (weekDayName->getValueDataAsEnum<Day>() != (Day)wDay)
+	{
+		weekDayName->setValueWithData((Day)wDay);
+		changed = true;
+	}
+	updateInt(weekDay, wDay + 1);
+
+	updateInt(hour, time.getHours());
+	updateInt(minutes, time.getMinutes());
+	updateInt(seconds, time.getSeconds());
+
+	int secondsInDay = time.getHours() * 3600 + time.getMinutes() * 60 + time.getSeconds();
+	if ((int)dayTime->floatValue() != secondsInDay)
+	{
+		dayTime->setValue(secondsInDay);
+		changed = true;
+	}
+
+	if (subSecondRate->enabled)
+	{
+		updateInt(milliseconds, time.getMilliseconds());
+		preciseDayTime->setValue(getMillisInDay(time) / 1000.0);
+	}
+
+	if (changed) inActivityTrigger->trigger();
+}
+
+void TimeModule::checkAlarms(const Time& time)
+{
+	int64 now = time.toMilliseconds();
+	int64 last = lastAlarmCheckTime;
+	lastAlarmCheckTime = now;
+
+	//first check, or the clock jumped (sleep, clock change...) : don't fire everything in between
+	if (last == 0 || now < last || now - last > 2000) return;
+
+	double nowInDay = getMillisInDay(time);
+	double lastInDay = nowInDay - (now - last);
+
+	for (auto& c : alarmTimesCC.controllables)
+	{
+		Trigger* t = alarmTriggers[c];
+		if (t == nullptr) continue;
+
+		double alarmTime = ((FloatParameter*)c)->floatValue() * 1000.0;
+
+		//lastInDay may be negative when passing midnight
+		bool reached = (alarmTime > lastInDay && alarmTime <= nowInDay) || (lastInDay < 0 && alarmTime > lastInDay + 86400000.0);
+		if (!reached) continue;
+
+		t->trigger();
+		inActivityTrigger->trigger();
+	}
+}
+
+int TimeModule::getMillisToNextUpdate(const Time& time) const
+{
+	int ms = time.getMilliseconds();
+	int result = 1000 - ms; //next second
+
+	if (subSecondRate->enabled)
+	{
+		int period = jmax(1, 1000 / subSecondRate->intValue());
+		result = jmin(result, period - ms % period);
+	}
+
+	double nowInDay = getMillisInDay(time);
+	for (auto& c : alarmTimesCC.controllables)
+	{
+		double delta = ((FloatParameter*)c)->floatValue() * 1000.0 - nowInDay;
+		if (delta <= 0) delta += 86400000.0;
+		result = jmin(result, (int)std::ceil(delta));
+	}
+
+	return jmax(1, result);
+}
+
+double TimeModule::getMillisInDay(const Time& time)
+{
+	return ((time.getHours() * 60 + time.getMinutes()) * 60 + time.getSeconds()) * 1000.0 + time.getMilliseconds();
+}
+
+void TimeModule::updateAlarmValues()
+{
+	//only add and remove the triggers of added and removed alarms, so mappings and references to the others stay valid
+	HashMap<Controllable*, Trigger*> newTriggers;
+	Array<Controllable*> keptTriggers;
+	for (auto& c : alarmTimesCC.controllables)
+	{
+		Trigger* t = alarmTriggers[c];
+		if (t == nullptr || !alarmsCC.controllables.contains(t))
+		{
+			t = alarmsCC.addTrigger(c->niceName, "Triggered when the time of the day reaches this alarm");
+			t->isControllableFeedbackOnly = true;
+		}
+		else if (t->niceName != c->niceName) t->setNiceName(c->niceName);
+
+		c->addControllableListener(this); //for renames
+		newTriggers.set(c, t);
+		keptTriggers.add(t);
+	}
+
+	Array<Controllable*> toRemove;
+	for (auto& t : alarmsCC.controllables) if (!keptTriggers.contains(t)) toRemove.add(t);
+	for (auto& t : toRemove) alarmsCC.removeControllable(t);
+
+	alarmTriggers.swapWith(newTriggers);
+
+	if (enabled->boolValue()) timerCallback(); //reschedule
+}
+
+void TimeModule::alarmTimesCreateControllable(ControllableContainer* c)
+{
+	FloatParameter* p = new FloatParameter("Alarm 1", "Time in the day at which the corresponding alarm value is triggered", 0, 0, 86400);
+	p->defaultUI = FloatParameter::TIME;
+	p->userCanChangeName = true;
+	p->saveValueOnly = false;
+	p->isRemovableByUser = true;
+	c->addParameter(p);
+}
+
+void TimeModule::onContainerParameterChangedInternal(Parameter* p)
+{
+	Module::onContainerParameterChangedInternal(p);
+
+	if (p == enabled)
+	{
+		lastAlarmCheckTime = 0;
+		timerCallback();
+	}
+}
+
+void TimeModule::onControllableFeedbackUpdateInternal(ControllableContainer* cc, Controllable* c)
+{
+	Module::onControllableFeedbackUpdateInternal(cc, c);
+
+	if (c == subSecondRate || c->parentContainer.get() == &alarmTimesCC)
+	{
+		if (!isCurrentlyLoadingData && enabled->boolValue()) timerCallback(); //reschedule
+	}
+}
+
+void TimeModule::onControllableStateChanged(Controllable* c)
+{
+	Module::onControllableStateChanged(c);
+
+	//Sub Second Rate is toggled through its enabled state, which doesn't send a feedback update
+	if (c == subSecondRate && !isCurrentlyLoadingData && enabled->boolValue()) timerCallback(); //reschedule
+}
+
+void TimeModule::controllableNameChanged(Controllable* c)
+{
+	Module::controllableNameChanged(c);
+
+	if (c->parentContainer.get() != &alarmTimesCC) return;
+	if (Trigger* t = alarmTriggers[c]) t->setNiceName(c->niceName);
+}
+
+void TimeModule::childStructureChanged(ControllableContainer* c)
+{
+	Module::childStructureChanged(c);
+
+	if (!isCurrentlyLoadingData && c == &moduleParams) updateAlarmValues();
+}
+
+void TimeModule::afterLoadJSONDataInternal()
+{
+	Module::afterLoadJSONDataInternal();
+
+	for (auto& c : alarmTimesCC.controllables)
+	{
+		c->userCanChangeName = true;
+		c->saveValueOnly = false;
+		c->isRemovableByUser = true;
+	}
+
+	updateAlarmValues();
 }
@@ -31,10 +31,34 @@ public:
 	IntParameter * minutes;
 	IntParameter * seconds;
 	FloatParameter * dayTime;
+	IntParameter* milliseconds;
+	FloatParameter* preciseDayTime;
+
+	IntParameter* subSecondRate;
+
+	ControllableContainer alarmTimesCC;
+	ControllableContainer alarmsCC;
+	HashMap<Controllable*, Trigger*> alarmTriggers; //alarm time > its trigger, triggers are kept as long as their alarm exists
+	int64 lastAlarmCheckTime;
+
+	void updateValues(const Time& time);
+	void checkAlarms(const Time& time);
+	void updateAlarmValues();
+	void alarmTimesCreateControllable(ControllableContainer* c);
+	int getMillisToNextUpdate(const Time& time) const;
+
+	static double getMillisInDay(const Time& time);
+
+	void onContainerParameterChangedInternal(Parameter* p) override;
+	void onControllableFeedbackUpdateInternal(ControllableContainer* cc, Controllable* c) override;
+	void onControllableStateChanged(Controllable* c) override;
+	void controllableNameChanged(Controllable* c) override;
+	void childStructureChanged(ControllableContainer* c) override;
+	void afterLoadJSONDataInternal() override;
 
 	virtual String getDefaultTypeString() const override { return "Time"; }
 	static TimeModule * create() { return new TimeModule(); }
 
-	// Inherited via Timer
+	//The timer is restarted at each call, to the next time a value changes
 	virtual void timerCallback() override;
 };
\ No newline at end of file
@@ -11,12 +11,22 @@
 #include "Module/ModuleIncludes.h"
 #include "PJLinkModule.h"
 
+#if JUCE_WINDOWS
+#include <winsock2.h>
+typedef SOCKET PJLinkSocketHandle;
+#else
+#include <sys/select.h>
+typedef int PJLinkSocketHandle;
+#endif
+
 PJLinkModule::PJLinkModule() :
 	StreamingModule(getDefaultTypeString()),
 	Thread("PJLink"),
 	clientsParamsCC("Projectors"),
 	clientsValuesCC("Projectors"),
-	autoRequestIsPower(true)
+	autoRequestIsPower(true),
+	nextAutoRequestTime(0),
+	requestTimeout(3000)
 {
 	alwaysShowValues = true;
 	includeValuesInSave = true;
@@ -33,6 +43,8 @@ PJLinkModule::PJLinkModule() :
 	autoRequestTime = moduleParams.addIntParameter("Auto Request Timer", "If enabled, this is the number of seconds between auto request, alternating power and shutter status", 5, 1, 100, true);
 	autoRequestTime->canBeDisabledByUser = true;
 
+	maxPendingRequests = moduleParams.addIntParameter("Max Pending Requests", "Number of requests sent to a projector before waiting for its replies. 1 is the safest, some projectors accept more and update faster", 1, 1, 8);
+
 	allProjectorsPoweredOn = valuesCC.addBoolParameter("All Powered On", "Are all projectors powered on ?", false);
 	allProjectorsPoweredOff = valuesCC.addBoolParameter("All Powered Off", "Are all projectors powered off ?", false);
 
@@ -71,7 +83,6 @@ PJLinkModule::PJLinkModule() :
 
 	updateClientsSetup();
 
-	startTimer(autoRequestTime->intValue() * 1000);
 	startThread();
 }
 
@@ -137,7 +148,7 @@ void PJLinkModule::onControllableFeedbackUpdateInternal(ControllableContainer* c
 	Module::onControllableFeedbackUpdateInternal(cc, c);
 
 	if (c == numClients) updateClientsSetup();
-	else if (c == autoRequestTime) startTimer(autoRequestTime->intValue() * 1000);
+	else if (c == autoRequestTime) nextAutoRequestTime = Time::getMillisecondCounterHiRes() + autoRequestTime->intValue() * 1000;
 	else if (cc == &valuesCC)
 	{
 		ControllableContainer* pc = c->parentContainer.get();
@@ -168,15 +179,15 @@ void PJLinkModule::onControllableFeedbackUpdateInternal(ControllableContainer* c
 					messageToSendInput.append(chooseInput[0], 20);
 
 					sendMessageToClient(messageToSendInput, client->id);
-					sendMessageToClient("%2IRES ?", client->id);
+					queueStatusRequest("%2IRES ?", client->id);
 				}
 			}
 
 			if (c == client->updateInput)
 			{
-				sendMessageToClient("%1INPT ?", client->id);
-				wait(500);
-				sendMessageToClient("%2IRES ?", client->id);
+				//replies come in order, no need to wait for the input before asking its resolution
+				queueStatusRequest("%1INPT ?", client->id);
+				queueStatusRequest("%2IRES ?", client->id);
 			}
 
 			if (c == client->updateInfo) requestInfos();
@@ -194,6 +205,8 @@ void PJLinkModule::onControllableFeedbackUpdateInternal(ControllableContainer* c
 					client->setupClient();
 				}
 
+				if (c == client->password) client->updateAuth();
+
 				if (c == client->isConnected || c == client->paramsCC.enabled)
 				{
 					updateConnectedStatus();
@@ -249,14 +262,24 @@ void PJLinkModule::sendMessageInternal(const String& message, var params)
 }
 
 void PJLinkModule::sendMessageToClient(const String& message, int id)
+{
+	queueMessage(message, id, true);
+}
+
+void PJLinkModule::queueStatusRequest(const String& message, int id)
+{
+	queueMessage(message, id, false);
+}
+
+void PJLinkModule::queueMessage(const String& message, int id, bool isCommand)
 {
 	if (!enabled->boolValue()) return;
 
-	outActivityTrigger->trigger();
+	if (isCommand) outActivityTrigger->trigger();
 
 	if (id == -1)
 	{
-		for (int i = 1; i <= clients.size(); i++) sendMessageToClient(message, i);
+		for (int i = 1; i <= clients.size(); i++) queueMessage(message, i, isCommand);
 		return;
 	}
 
@@ -265,23 +288,9 @@ void PJLinkModule::sendMessageToClient(const String& message, int id)
 	PJLinkClient* client = clients[id - 1];
 	if (client == nullptr) return;
 
-	String msg = message + "\r";
-
-	String encodedPass = juce::MD5((client->passBytes + client->password->stringValue()).toUTF8()).toHexString();
-	String encodedMessage = client->password->stringValue().isEmpty() ? msg : (encodedPass + msg);
-
 	if (client->isConnected->boolValue() && client->paramsCC.enabled->boolValue())
 	{
-		int numWritten = client->client.write(encodedMessage.toStdString().c_str(), encodedMessage.length());
-		if (numWritten == -1)
-		{
-			NLOGERROR(niceName, "Error writing to client " << client->id);
-			client->isConnected->setValue(false);
-		}
-		else
-		{
-			if (logOutgoingData->boolValue()) NLOG(niceName, message << " sent to projector " << client->id);
-		}
+		client->queueRequest(message, isCommand);
 	}
 	else
 	{
@@ -289,77 +298,162 @@ void PJLinkModule::sendMessageToClient(const String& message, int id)
 	}
 }
 
-
-void PJLinkModule::timerCallback()
+bool PJLinkModule::writeToClient(PJLinkClient* c, const String& message)
 {
-	if (!autoRequestTime->enabled) return;
+	String encodedMessage = c->authPrefix + message + "\r";
 
-	for (auto& c : clients)
+	int numWritten = c->client.write(encodedMessage.toRawUTF8(), (int)encodedMessage.getNumBytesAsUTF8());
+	if (numWritten == -1)
 	{
-		if (c == nullptr) return;
-		if (!c->isConnected->boolValue() || !c->lastRequestReplied) c->setupClient();
-		c->lastRequestReplied = false;
+		NLOGERROR(niceName, "Error writing to client " << c->id);
+		return false;
 	}
 
-	sendMessageToClient(autoRequestIsPower ? "%1POWR ?" : "%1AVMT ?");
+	if (logOutgoingData->boolValue()) NLOG(niceName, message << " sent to projector " << c->id);
+	return true;
+}
+
+void PJLinkModule::sendPendingRequests(PJLinkClient* c, double now)
+{
+	GenericScopedTryLock socketLock(c->socketLock);
+	if (!socketLock.isLocked()) return; //connection attempt running
+	if (!c->isConnected->boolValue()) return;
+
+	bool connectionLost = false;
+
+	{
+		GenericScopedLock lock(c->queueLock);
+
+		if (!c->pendingRequests.isEmpty() && now - c->pendingRequests.getReference(0).sendTime > requestTimeout)
+		{
+			NLOGWARNING(niceName, "Projector " << c->id << " did not reply to " << c->pendingRequests.getReference(0).message << ", reconnecting");
+			connectionLost = true;
+		}
+		else if (c->handshakeReceived || now - c->timeAtConnect > requestTimeout) //the greeting gives the seed needed to authenticate
+		{
+			while (c->pendingRequests.size() < maxPendingRequests->intValue())
+			{
+				Array<String>& queue = c->commandQueue.isEmpty() ? c->pollQueue : c->commandQueue;
+				if (queue.isEmpty()) break;
 
-	autoRequestIsPower = !autoRequestIsPower;
+				PJLinkClient::Request r;
+				r.message = queue.removeAndReturn(0);
+				r.sendTime = now;
 
+				if (!writeToClient(c, r.message))
+				{
+					connectionLost = true;
+					break;
+				}
+
+				c->pendingRequests.add(r);
+			}
+		}
+	}
+
+	if (connectionLost) c->closeConnection();
 }
 
 void PJLinkModule::run()
 {
+	nextAutoRequestTime = Time::getMillisecondCounterHiRes() + autoRequestTime->intValue() * 1000;
+
 	while (!threadShouldExit())
 	{
-		wait(100);
-		for (auto& c : clients) processClient(c);
+		double now = Time::getMillisecondCounterHiRes();
+
+		if (now >= nextAutoRequestTime)
+		{
+			if (autoRequestTime->enabled)
+			{
+				queueStatusRequest(autoRequestIsPower ? "%1POWR ?" : "%1AVMT ?");
+				autoRequestIsPower = !autoRequestIsPower;
+			}
+
+			nextAutoRequestTime = now + autoRequestTime->intValue() * 1000;
+		}
+
+		//A single thread serves all the projectors : write what is queued, then wait for any of the sockets to have data
+		fd_set readSet;
+		FD_ZERO(&readSet);
+		int maxHandle = -1;
+
+		{
+			GenericScopedLock lock(clients.getLock());
+			for (auto& c : clients)
+			{
+				if (!enabled->boolValue() || !c->paramsCC.enabled->boolValue() || !c->isConnected->boolValue()) continue;
+
+				sendPendingRequests(c, now);
+
+				int handle = c->getSocketHandle();
+				if (handle < 0) continue;
+
+				FD_SET((PJLinkSocketHandle)handle, &readSet);
+				maxHandle = jmax(maxHandle, handle);
+			}
+		}
+
+		if (maxHandle < 0)
+		{
+			wait(20);
+			continue;
+		}
+
+		timeval timeout = { 0, 10000 }; //short, so newly queued commands don't wait
+		if (select(maxHandle + 1, &readSet, nullptr, nullptr, &timeout) <= 0) continue;
+
+		GenericScopedLock lock(clients.getLock());
+		for (auto& c : clients)
+		{
+			int handle = c->getSocketHandle();
+			if (handle >= 0 && FD_ISSET((PJLinkSocketHandle)handle, &readSet)) processClient(c);
+		}
 	}
 }
 
 void PJLinkModule::requestInfos()
 {
+	//all queued at once, the engine sends them as the projector replies
 	for (int i = 1; i <= clients.size(); i++)
 	{
-		sendMessageToClient("%1INST ?", i);		// input list
-		wait(100);
-		sendMessageToClient("%2IRES ?", i);		// Input resolution
-		wait(100);
-		sendMessageToClient("%2RRES ?", i);		// Recommended resolution
-		wait(100);
-		sendMessageToClient("%1INF1 ?", i);		// Manufacturer name
-		wait(100);
-		sendMessageToClient("%1INF2 ?", i);		// Product name
-		wait(100);
-		sendMessageToClient("%1NAME ?", i);		// Display name
-		wait(100);
-		sendMessageToClient("%2SVER ?", i);		// Firmware version
-		wait(100);
-		sendMessageToClient("%1LAMP ?", i);		// Lamp hours
-		wait(100);
-		sendMessageToClient("%2RLMP ?", i);		// Lamp model
-		wait(100);
-		sendMessageToClient("%2FILT ?", i);		// Filter time
-		wait(100);
-		sendMessageToClient("%2RFIL ?", i);		// Filter number
-		wait(100);
-		sendMessageToClient("%1ERST ?", i);		// chek errors
+		queueStatusRequest("%1INST ?", i);		// input list
+		queueStatusRequest("%2IRES ?", i);		// Input resolution
+		queueStatusRequest("%2RRES ?", i);		// Recommended resolution
+		queueStatusRequest("%1INF1 ?", i);		// Manufacturer name
+		queueStatusRequest("%1INF2 ?", i);		// Product name
+		queueStatusRequest("%1NAME ?", i);		// Display name
+		queueStatusRequest("%2SVER ?", i);		// Firmware version
+		queueStatusRequest("%1LAMP ?", i);		// Lamp hours
+		queueStatusRequest("%2RLMP ?", i);		// Lamp model
+		queueStatusRequest("%2FILT ?", i);		// Filter time
+		queueStatusRequest("%2RFIL ?", i);		// Filter number
+		queueStatusRequest("%1ERST ?", i);		// chek errors
 	}
 }
+
 void PJLinkModule::processClient(PJLinkModule::PJLinkClient* c)
 {
 	if (!enabled->boolValue()) return;
 	if (c == nullptr) return;
-	if (!c->isConnected->boolValue()) return;
-	if (!c->paramsCC.enabled->boolValue()) return;
 
 	uint8 bytes[2048];
-	int numRead = c->client.read(bytes, 2048, false);
+	int numRead = 0;
 
-	//if (numRead == 0)
-	//{
-	//	NLOGWARNING(niceName, "Connection to TCP Server seems lost, disconnecting");
-	//	c->isConnected->setValue(false);
-	//}
+	{
+		GenericScopedTryLock socketLock(c->socketLock);
+		if (!socketLock.isLocked()) return;
+		if (!c->isConnected->boolValue()) return;
+		numRead = c->client.read(bytes, 2048, false);
+	}
+
+	//the socket was reported readable, no data means the projector closed the connection (it does after 30s idle)
+	if (numRead <= 0)
+	{
+		if (logIncomingData->boolValue()) NLOG(niceName, "Projector " << c->id << " closed the connection");
+		c->closeConnection();
+		return;
+	}
 
 	if (CharPointer_UTF8::isValidString((char*)bytes, numRead))
 	{
@@ -369,20 +463,43 @@ void PJLinkModule::processClient(PJLinkModule::PJLinkClient* c)
 		for (int i = 0; i < sa.size() - 1; ++i) processClientLine(c, sa[i]);
 		c->stringBuffer = sa[sa.size() - 1];
 	}
+
+	//a slot was freed, send the next request right away
+	sendPendingRequests(c, Time::getMillisecondCounterHiRes());
 }
+
 void PJLinkModule::processClientLine(PJLinkClient* c, const String& message)
 {
 	inActivityTrigger->trigger();
 	if (logIncomingData->boolValue()) NLOG(niceName, "Received : " << message);
 
-	c->lastRequestReplied = true;
+	//replies come in the order of the requests, the greeting is the only line sent on its own.
+	//"PJLINK ERRA" is the reply to a request that failed authentication, so it also takes the place of a request
+	bool isGreeting = message == "PJLINK 0" || message.startsWith("PJLINK 1 ");
+	bool isAuthError = message.startsWith("PJLINK ERRA");
+
+	if (!isGreeting)
+	{
+		double requestTime = -1;
+		{
+			GenericScopedLock lock(c->queueLock);
+			if (!c->pendingRequests.isEmpty()) requestTime = c->pendingRequests.removeAndReturn(0).sendTime;
+		}
+
+		if (requestTime >= 0)
+		{
+			double t = Time::getMillisecondCounterHiRes() - requestTime;
+			c->lastResponseTime = t;
+			c->responseTime->setValue(t);
+		}
+	}
 
 	Array<var> args;
 	args.add(c->id);
 	args.add(message);
 	scriptManager->callFunctionOnAllItems(pjLinkDataReceivedId, args);
 
-	if (message.contains("PJLINK"))
+	if (isGreeting)
 	{
 		StringArray mSplit;
 		mSplit.addTokens(message, true);
@@ -393,15 +510,19 @@ void PJLinkModule::processClientLine(PJLinkClient* c, const String& message)
 				c->passBytes = mSplit[2];
 				if (logIncomingData->boolValue()) NLOG(niceName, "> PJLINK handshake with password gen key " << mSplit[2]);
 			}
+
+			c->updateAuth();
 		}
 		else if (mSplit[1] == "0")
 		{
 			if (logIncomingData->boolValue()) NLOG(niceName, "> PJLINK handshake, projector is not password protected");
 		}
-		else if (mSplit[1].contains("ERR"))
-		{
-			NLOGERROR(niceName, "PJLINK Authentication error for projector " << c->id << ", please verify password !");
-		}
+
+		c->handshakeReceived = true;
+	}
+	else if (isAuthError)
+	{
+		NLOGERROR(niceName, "PJLINK Authentication error for projector " << c->id << ", please verify password !");
 	}
 	else if (message.contains("%1POWR="))
 	{
@@ -417,8 +538,8 @@ void PJLinkModule::processClientLine(PJLinkClient* c, const String& message)
 			{
 				NLOG(niceName, " > Project power command accepted !");
 
-				sendMessageToClient("%1INPT ?", c->id);
-				sendMessageToClient("%2IRES ?", c->id);
+				queueStatusRequest("%1INPT ?", c->id);
+				queueStatusRequest("%2IRES ?", c->id);
 			}
 		}
 	}
@@ -593,7 +714,7 @@ void PJLinkModule::processClientLine(PJLinkClient* c, const String& message)
 
 			for (i = 0; i < (inputListVp.size()); i += 1)
 			{
-				sendMessageToClient("%2INNM ?" + inputListVp[i], c->id);
+				queueStatusRequest("%2INNM ?" + inputListVp[i], c->id);
 			}
 
 			NLOG(niceName, " > Received input list of projector " << c->id);
@@ -680,8 +801,8 @@ String PJLinkModule::convertError(String numError)
 
 void PJLinkModule::requestInputName(int id)
 {
-	if (indexInput <= inputListVp.size() - 1) sendMessageToClient("%2INNM ?" + inputListVp[indexInput], idVpInput);
-	if (indexInput == inputListVp.size()) sendMessageToClient("%1INPT ?", id);
+	if (indexInput <= inputListVp.size() - 1) queueStatusRequest("%2INNM ?" + inputListVp[indexInput], idVpInput);
+	if (indexInput == inputListVp.size()) queueStatusRequest("%1INPT ?", id);
 }
 
 var PJLinkModule::getJSONData(bool includeNonOverriden)
@@ -705,13 +826,14 @@ void PJLinkModule::loadJSONDataInternal(var data)
 }
 
 PJLinkModule::PJLinkClient::PJLinkClient(PJLinkModule* m, int id) :
-	Thread("PJLink Client " + String(id)),
 	pjlinkModule(m),
 	id(id),
 	passBytes(0),
 	paramsCC("Projector " + String(id)),
 	valuesCC("Projector " + String(id)),
 	infosCC("Informations"),
+	timeAtConnect(0),
+	handshakeReceived(false),
 	assigningFromRemote(false)
 {
 	paramsCC.nameCanBeChangedByUser = true;
@@ -775,45 +897,116 @@ PJLinkModule::PJLinkClient::PJLinkClient(PJLinkModule* m, int id) :
 	filterErrorInfo->setControllableFeedbackOnly(true);
 	otherErrorInfo = infosCC.addStringParameter("Other error", "Other error", "");									// Other error
 	otherErrorInfo->setControllableFeedbackOnly(true);
+
+	responseTime = valuesCC.addFloatParameter("Response Time", "Time in milliseconds between the last request and its reply", 0, 0);
+	responseTime->setControllableFeedbackOnly(true);
+	addConnectionValues(&valuesCC);
+
+	updateAuth();
+
+	ConnectionSupervisor::getInstance()->addClient(this, 1000);
 }
 
 PJLinkModule::PJLinkClient::~PJLinkClient()
 {
-	stopThread(1000);
+	if (ConnectionSupervisor* s = ConnectionSupervisor::getInstanceWithoutCreating()) s->removeClient(this);
+
+	GenericScopedLock lock(socketLock);
+	client.close();
 }
 
 void PJLinkModule::PJLinkClient::setupClient()
 {
-	startThread();
+	closeConnection();
+	ConnectionSupervisor::getInstance()->resetClient(this);
 }
 
-void PJLinkModule::PJLinkClient::run()
+void PJLinkModule::PJLinkClient::closeConnection()
 {
-	if (client.isConnected())
 	{
-		client.close();
+		GenericScopedLock lock(socketLock);
+		if (client.isConnected()) client.close();
 	}
 
+	clearRequests();
 	isConnected->setValue(false);
+}
+
+int PJLinkModule::PJLinkClient::getSocketHandle()
+{
+	//the supervisor closes and reopens the socket from its own threads
+	GenericScopedTryLock lock(socketLock);
+	if (!lock.isLocked()) return -1;
+	return client.getRawSocketHandle();
+}
 
-	if (!paramsCC.enabled->boolValue()) return;
+void PJLinkModule::PJLinkClient::clearRequests()
+{
+	GenericScopedLock lock(queueLock);
+	commandQueue.clear();
+	pollQueue.clear();
+	pendingRequests.clear();
+}
+
+void PJLinkModule::PJLinkClient::updateAuth()
+{
+	String pass = password->stringValue();
+
+	GenericScopedLock lock(queueLock);
+	authPrefix = pass.isEmpty() ? String() : juce::MD5((passBytes + pass).toUTF8()).toHexString();
+}
+
+void PJLinkModule::PJLinkClient::queueRequest(const String& message, bool isCommand)
+{
+	GenericScopedLock lock(queueLock);
+	if (isCommand) commandQueue.add(message);
+	else pollQueue.addIfNotAlreadyThere(message); //a slow projector should not pile up the same status requests
+}
+
+bool PJLinkModule::PJLinkClient::isSupervisedConnectionNeeded()
+{
+	return pjlinkModule->enabled->boolValue() && paramsCC.enabled->boolValue() && !pjlinkModule->isCurrentlyLoadingData && remoteHost->stringValue().isNotEmpty();
+}
+
+bool PJLinkModule::PJLinkClient::isSupervisedConnected()
+{
+	return isConnected->boolValue();
+}
+
+void PJLinkModule::PJLinkClient::attemptConnection()
+{
+	GenericScopedLock lock(socketLock);
+
+	if (client.isConnected()) client.close();
+	isConnected->setValue(false);
 
 	if (pjlinkModule->logOutgoingData->boolValue()) LOG("Connecting to " << remoteHost->stringValue() << ":" << remotePort->intValue() << "...");
 
 	bool result = client.connect(remoteHost->stringValue(), remotePort->intValue(), 500);
 	if (!result)
 	{
-
 		if (paramsCC.getWarningMessage().isEmpty()) paramsCC.setWarningMessage("Could not connect to " + remoteHost->stringValue() + ":" + remotePort->stringValue());
 		return;
 	}
 
+	clearRequests();
+	stringBuffer.clear();
+	handshakeReceived = false;
+	timeAtConnect = Time::getMillisecondCounterHiRes();
+
 	isConnected->setValue(true);
 	paramsCC.clearWarning();
 
 	if (pjlinkModule->logOutgoingData->boolValue()) LOG("Connected to projector " << (id) << " (" << remoteHost->stringValue() << ":" << remotePort->intValue() << ")");
 }
 
+bool PJLinkModule::PJLinkClient::probeConnection(double& latencyMS)
+{
+	//the periodic status requests are the round trips, dead connections are caught by their timeout
+	latencyMS = lastResponseTime.exchange(-1);
+	return isConnected->boolValue();
+}
+
 void PJLinkModule::PJLinkClient::controllableContainerNameChanged(ControllableContainer* cc)
 {
 	if (cc == &paramsCC)
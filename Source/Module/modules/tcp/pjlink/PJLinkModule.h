@@ -14,8 +14,7 @@
 
 class PJLinkModule :
 	public StreamingModule,
-	public Thread,
-	public Timer
+	public Thread
 {
 public:
 	PJLinkModule();
@@ -23,8 +22,8 @@ public:
 
 	String convertError(String numError);
 	class PJLinkClient :
-		public Thread,
-		public ControllableContainerListener
+		public ControllableContainerListener,
+		public ConnectionSupervisor::Client
 	{
 	public:
 		PJLinkClient(PJLinkModule* m, int id);
@@ -34,6 +33,8 @@ public:
 
 		int id;
 		StreamingSocket client;
+		CriticalSection socketLock;
+		int getSocketHandle(); //-1 if not connected or if the socket is being closed or reopened
 
 		EnablingControllableContainer paramsCC;
 		ControllableContainer valuesCC;
@@ -44,6 +45,7 @@ public:
 		BoolParameter* isConnected;
 		StringParameter* password;
 		String passBytes;
+		String authPrefix; //cached digest, only computed again when the projector sends a new seed or the password changes
 
 		EnumParameter* powerStatus;
 		BoolParameter* shutterVideoStatus;
@@ -67,22 +69,44 @@ public:
 		StringParameter* coverErrorInfo;
 		StringParameter* filterErrorInfo;
 		StringParameter* otherErrorInfo;
+		FloatParameter* responseTime;
+		std::atomic<double> lastResponseTime{ -1 }; //reply time not reported to the supervisor yet, -1 if none
 
-		float timeAtConnect;
+		double timeAtConnect;
+		bool handshakeReceived;
 		bool assigningFromRemote;
 
-		bool lastRequestReplied;
+		//Requests are written by the module's engine thread, commands always go before status requests
+		struct Request
+		{
+			String message;
+			double sendTime = 0;
+		};
+
+		CriticalSection queueLock;
+		Array<String> commandQueue;
+		Array<String> pollQueue;
+		Array<Request> pendingRequests;
 
 		String stringBuffer;
 
 		void setupClient();
-		void run() override;
+		void closeConnection();
+		void clearRequests();
+		void updateAuth();
+		void queueRequest(const String& message, bool isCommand);
+
+		bool isSupervisedConnectionNeeded() override;
+		bool isSupervisedConnected() override;
+		void attemptConnection() override;
+		bool probeConnection(double& latencyMS) override;
 
 		void controllableContainerNameChanged(ControllableContainer* cc) override;
 	};
 
 	IntParameter* numClients;
 	IntParameter* autoRequestTime;
+	IntParameter* maxPendingRequests;
 	OwnedArray<PJLinkClient, CriticalSection> clients;
 
 	ControllableContainer clientsParamsCC;
@@ -100,6 +124,8 @@ public:
 	const Identifier pjLinkDataReceivedId = "pjLinkDataReceived";
 
 	bool autoRequestIsPower;
+	double nextAutoRequestTime;
+	int requestTimeout; //ms without reply before the connection is considered dead
 
 	var ghostClientNames;
 
@@ -116,11 +142,14 @@ public:
 	void sendMessageInternal(const String& message, var params) override;
 
 	void sendMessageToClient(const String& message, int id = -1);
+	void queueStatusRequest(const String& message, int id = -1);
+	void queueMessage(const String& message, int id, bool isCommand);
 
 	bool isReadyToSend() override { return true; };
 
-	void timerCallback() override;
 	void run() override;
+	void sendPendingRequests(PJLinkClient* c, double now);
+	bool writeToClient(PJLinkClient* c, const String& message);
 	void processClient(PJLinkClient* c);
 	void processClientLine(PJLinkClient* c, const String& message);
 
@@ -16,9 +16,12 @@ TCPClientModule::TCPClientModule(const String& name, int defaultRemotePort, bool
 	autoReconnect(true)
 {
 	connectionFeedbackRef = senderIsConnected;
+	addConnectionValues(&moduleParams);
 
 	setupIOConfiguration(true, true);
 
+	if (autoConnect) ConnectionSupervisor::getInstance()->addClient(this, 2000);
+
 	if (!Engine::mainEngine->isLoadingFile)
 	{
 		setupSender();
@@ -28,6 +31,7 @@ TCPClientModule::TCPClientModule(const String& name, int defaultRemotePort, bool
 
 TCPClientModule::~TCPClientModule()
 {
+	if (ConnectionSupervisor* s = ConnectionSupervisor::getInstanceWithoutCreating()) s->removeClient(this);
 }
 
 void TCPClientModule::setupSender()
@@ -53,30 +57,30 @@ void TCPClientModule::initThread()
 {
 	if (!enabled->boolValue()) return;
 
-	if (senderIsConnected->boolValue() || sender.isConnected())
 	{
-		sender.close();
-		senderIsConnected->setValue(false);
+		GenericScopedLock lock(senderLock);
+		if (senderIsConnected->boolValue() || sender.isConnected())
+		{
+			sender.close();
+			senderIsConnected->setValue(false);
+		}
 	}
 
-	while (!senderIsConnected->boolValue() && !threadShouldExit())
+	if (!autoReconnect)
 	{
-		bool result = connect();
-		if (!result)
-		{
-			if (!autoReconnect)
-			{
-				signalThreadShouldExit();
-				break;
-			}
-			else wait(1000);
-		}
+		if (!connect()) signalThreadShouldExit();
+		return;
 	}
+
+	//the supervisor connects from its own threads with back-off, this thread only reads
+	ConnectionSupervisor::getInstance()->resetClient(this);
 }
 
 void TCPClientModule::clearThread()
 {
 	NetworkStreamingModule::clearThread();
+
+	GenericScopedLock lock(senderLock);
 	if (sender.isConnected())
 	{
 		sender.close();
@@ -87,7 +91,10 @@ void TCPClientModule::clearThread()
 bool TCPClientModule::checkReceiverIsReady()
 {
 	if (!senderIsConnected->boolValue()) return false;
-	int result = sender.waitUntilReady(true, 100);
+
+	//no blocking wait with the lock held, the receive loop already waits between checks
+	GenericScopedLock lock(senderLock);
+	int result = sender.waitUntilReady(true, 0);
 
 	if (result == -1)
 	{
@@ -105,6 +112,7 @@ bool TCPClientModule::isReadyToSend()
 
 void TCPClientModule::sendMessageInternal(const String& message, var)
 {
+	GenericScopedLock lock(senderLock);
 	int numBytes = sender.write(message.getCharPointer(), message.length());
 	if (numBytes == -1)
 	{
@@ -115,6 +123,7 @@ void TCPClientModule::sendMessageInternal(const String& message, var)
 
 void TCPClientModule::sendBytesInternal(Array<uint8> data, var)
 {
+	GenericScopedLock lock(senderLock);
 	int numBytes = sender.write(data.getRawDataPointer(), data.size());
 	if (numBytes == -1)
 	{
@@ -126,7 +135,11 @@ void TCPClientModule::sendBytesInternal(Array<uint8> data, var)
 Array<uint8> TCPClientModule::readBytes()
 {
 	uint8 bytes[2048];
-	int numRead = sender.read(bytes, 2048, false);
+	int numRead = 0;
+	{
+		GenericScopedLock lock(senderLock);
+		numRead = sender.read(bytes, 2048, false);
+	}
 
 	if (numRead == 0)
 	{
@@ -139,6 +152,7 @@ Array<uint8> TCPClientModule::readBytes()
 
 void TCPClientModule::clearInternal()
 {
+	GenericScopedLock lock(senderLock);
 	if (sender.isConnected())
 	{
 		sender.close();
@@ -148,17 +162,49 @@ void TCPClientModule::clearInternal()
 
 void TCPClientModule::runInternal()
 {
-	if (!sender.isConnected() || !senderIsConnected->boolValue())
+	bool socketConnected = false;
+	{
+		GenericScopedLock lock(senderLock);
+		socketConnected = sender.isConnected();
+	}
+
+	if (!socketConnected || !senderIsConnected->boolValue())
 	{
 		senderIsConnected->setValue(false);
-		wait(1000);
-		if (threadShouldExit()) return;
-		if (autoReconnect) initThread();
+		wait(100);
 	}
 }
 
+bool TCPClientModule::isSupervisedConnectionNeeded()
+{
+	return autoConnect && autoReconnect && enabled->boolValue() && !isCurrentlyLoadingData
+		&& sendCC != nullptr && sendCC->enabled->boolValue() && isThreadRunning();
+}
+
+bool TCPClientModule::isSupervisedConnected()
+{
+	return senderIsConnected->boolValue();
+}
+
+void TCPClientModule::attemptConnection()
+{
+	connect();
+}
+
+bool TCPClientModule::probeConnection(double& /*latencyMS*/)
+{
+	//raw TCP has no round trip to measure, only check that the socket is still usable
+	GenericScopedLock lock(senderLock);
+	if (sender.isConnected() && sender.waitUntilReady(false, 0) != -1) return true;
+
+	senderIsConnected->setValue(false);
+	return false;
+}
+
 bool TCPClientModule::connect()
 {
+	GenericScopedLock lock(senderLock);
+
 	String targetHost = useLocal->boolValue() ? "127.0.0.1" : remoteHost->stringValue();
 	sender.bindToPort(0, networkInterface->getIP());
 	bool result = sender.connect(targetHost, remotePort->intValue(), 200);
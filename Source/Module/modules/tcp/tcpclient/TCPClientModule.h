@@ -11,12 +11,14 @@
 #pragma once
 
 class TCPClientModule :
-	public NetworkStreamingModule
+	public NetworkStreamingModule,
+	public ConnectionSupervisor::Client
 {
 public:
 	TCPClientModule(const String &name = "TCP Client", int defaultRemotePort = 5001, bool autoConnect = true);
 	virtual ~TCPClientModule();
 
+	CriticalSection senderLock; //every access to sender, it's reconnected from the supervisor's threads
 	StreamingSocket sender;
 
 	bool autoConnect;
@@ -42,6 +44,12 @@ public:
 
 	bool connect();
 
+	//Reconnection is handled by the connection supervisor, connect() is called from its pool
+	virtual bool isSupervisedConnectionNeeded() override;
+	virtual bool isSupervisedConnected() override;
+	virtual void attemptConnection() override;
+	virtual bool probeConnection(double& latencyMS) override;
+
 	static TCPClientModule * create() { return new TCPClientModule(); }
 	virtual String getDefaultTypeString() const override { return "TCP Client"; }
 
@@ -22,20 +22,32 @@ WebSocketClientModule::WebSocketClientModule(const String& name, const String& d
 	isConnected = moduleParams.addBoolParameter("Connected", "Is the socket sucessfully bound and listening", false);
 	isConnected->setControllableFeedbackOnly(true);
 	connectionFeedbackRef = isConnected;
+	addConnectionValues(&moduleParams);
 
 	scriptManager->scriptTemplate += ChataigneAssetManager::getInstance()->getScriptTemplate("wsClient");
 
-	startTimer(1000);
+	ConnectionSupervisor::getInstance()->addClient(this);
 }
 
 WebSocketClientModule::~WebSocketClientModule()
 {
+	if (ConnectionSupervisor* s = ConnectionSupervisor::getInstanceWithoutCreating()) s->removeClient(this);
 }
 
 void WebSocketClientModule::setupClient()
 {
-	if (client != nullptr) client->stop();
-	client.reset();
+	//this runs on the supervisor's threads, senders only see the client under clientLock.
+	//The old client is stopped outside the lock as its thread may be sending from a callback
+	std::unique_ptr<SimpleWebSocketClientBase> oldClient;
+	{
+		GenericScopedLock lock(clientLock);
+		oldClient.reset(client.release());
+	}
+
+	if (oldClient != nullptr) oldClient->stop();
+	oldClient.reset();
+
+	GenericScopedLock lock(clientLock);
 	if (isCurrentlyLoadingData) return;
 
 	isConnected->setValue(false);
@@ -59,17 +71,20 @@ void WebSocketClientModule::setupClient()
 
 bool WebSocketClientModule::isReadyToSend()
 {
+	GenericScopedLock lock(clientLock);
 	return client != nullptr && isConnected->boolValue();
 }
 
 void WebSocketClientModule::sendMessageInternal(const String& message, var params)
 {
-	client->send(message);
+	GenericScopedLock lock(clientLock);
+	if (client != nullptr) client->send(message);
 }
 
 void WebSocketClientModule::sendBytesInternal(Array<uint8> data, var params)
 {
-	client->send((const char*)data.getRawDataPointer(), data.size());
+	GenericScopedLock lock(clientLock);
+	if (client != nullptr) client->send((const char*)data.getRawDataPointer(), data.size());
 }
 
 void WebSocketClientModule::connectionOpened()
@@ -159,8 +174,7 @@ void WebSocketClientModule::onContainerParameterChangedInternal(Parameter* p)
 			NLOG(niceName, "Disabling module, closing server.");
 		}
 
-		connectFirstTry = true;
-		setupClient();
+		reconnect();
 	}
 }
 
@@ -185,45 +199,46 @@ void WebSocketClientModule::onControllableFeedbackUpdateInternal(ControllableCon
 			return;
 		}
 
-		setupClient();
+		reconnect();
 	}
 	else if (c == isConnected)
 	{
-		if (isConnected->boolValue())
-		{
-			stopTimer();
-		}
-		else
-		{
-			connectFirstTry = true;
-			startTimer(1000);
-		}
+		if (!isConnected->boolValue()) connectFirstTry = true;
 	}
 	else if (c == useSecureConnection)
 	{
-		if (!isCurrentlyLoadingData)
-		{
-			connectFirstTry = true;
-			setupClient();
-		}
+		if (!isCurrentlyLoadingData) reconnect();
 	}
 }
 
-void WebSocketClientModule::timerCallback()
+bool WebSocketClientModule::isSupervisedConnectionNeeded()
 {
-	if (!isConnected->boolValue())
-	{
-		setupClient();
+	return enabled->boolValue() && !isCurrentlyLoadingData && serverPath->stringValue().isNotEmpty();
+}
 
-		if (connectFirstTry) startTimer(5000);
-		connectFirstTry = false;
-	}
+bool WebSocketClientModule::isSupervisedConnected()
+{
+	return isConnected->boolValue();
+}
+
+void WebSocketClientModule::attemptConnection()
+{
+	setupClient();
+	connectFirstTry = false;
+}
+
+void WebSocketClientModule::reconnect()
+{
+	//first try is done right away and logs its errors, retries are scheduled by the supervisor
+	connectFirstTry = true;
+	setupClient();
+	ConnectionSupervisor::getInstance()->connectionAttemptStarted(this);
 }
 
 void WebSocketClientModule::afterLoadJSONDataInternal()
 {
 	StreamingModule::afterLoadJSONDataInternal();
-	setupClient();
+	reconnect();
 }
 
 
@@ -16,7 +16,7 @@
 class WebSocketClientModule :
 	public StreamingModule,
 	public SimpleWebSocketClientBase::Listener,
-	public Timer
+	public ConnectionSupervisor::Client
 
 {
 public:
@@ -29,6 +29,7 @@ public:
 	BoolParameter* isConnected;
 	bool connectFirstTry;
 
+	CriticalSection clientLock;
 	std::unique_ptr<SimpleWebSocketClientBase> client;
 
 	const Identifier wsMessageReceivedId = "wsMessageReceived";
@@ -51,7 +52,11 @@ public:
 	virtual void onContainerParameterChangedInternal(Parameter* p) override;
 	virtual void onControllableFeedbackUpdateInternal(ControllableContainer* cc, Controllable* c) override;
 
-	virtual void timerCallback() override;
+	//Reconnection is handled by the connection supervisor
+	virtual bool isSupervisedConnectionNeeded() override;
+	virtual bool isSupervisedConnected() override;
+	virtual void attemptConnection() override;
+	void reconnect();
 
 	void afterLoadJSONDataInternal() override;
 
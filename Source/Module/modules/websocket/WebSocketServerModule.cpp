@@ -9,7 +9,8 @@
 */
 
 WebSocketServerModule::WebSocketServerModule(const String& name, int defaultRemotePort) :
-	StreamingModule(name)
+	StreamingModule(name),
+	sendThread(this)
 {
 	networkInterface = new NetworkInterfaceParameter();
 	moduleParams.addParameter(networkInterface);
@@ -22,8 +23,18 @@ WebSocketServerModule::WebSocketServerModule(const String& name, int defaultRemo
 	numClients = moduleParams.addIntParameter("Connected Clients", "Number of connected clients", 0);
 	numClients->setControllableFeedbackOnly(true);
 
+	asyncSend = moduleParams.addBoolParameter("Send Asynchronously", "If checked, messages are queued and sent from a dedicated thread, so slow clients don't block the thread that sends the message", false);
+	maxQueuedMessages = moduleParams.addIntParameter("Max Queued Messages", "Maximum number of queued messages for the same recipients, for each connection when sending to explicit clients or groups. When reached, the oldest one is dropped", 32, 1, 1000, false);
+	keepLatestOnly = moduleParams.addBoolParameter("Keep Latest Only", "If checked, a queued message that has not been sent yet is replaced by the new one for the same recipients. Useful when sending state at a high rate", false, false);
+
 	connectionFeedbackRef = isConnected;
 
+	scriptObject.getDynamicObject()->setMethod("addClientToGroup", WebSocketServerModule::addClientToGroupFromScript);
+	scriptObject.getDynamicObject()->setMethod("removeClientFromGroup", WebSocketServerModule::removeClientFromGroupFromScript);
+	scriptObject.getDynamicObject()->setMethod("getGroupClients", WebSocketServerModule::getGroupClientsFromScript);
+	scriptObject.getDynamicObject()->setMethod("sendToGroup", WebSocketServerModule::sendToGroupFromScript);
+	scriptObject.getDynamicObject()->setMethod("sendBytesToGroup", WebSocketServerModule::sendBytesToGroupFromScript);
+
 	scriptManager->scriptTemplate += ChataigneAssetManager::getInstance()->getScriptTemplate("wsServer");
 
 	setupServer();
@@ -31,16 +42,26 @@ WebSocketServerModule::WebSocketServerModule(const String& name, int defaultRemo
 
 WebSocketServerModule::~WebSocketServerModule()
 {
+	sendThread.stopThread(1000);
 }
 
 void WebSocketServerModule::setupServer()
 {
+	sendThread.stopThread(1000);
+
+	{
+		GenericScopedLock lock(queueLock);
+		sendQueues.clear();
+	}
+
 	if (server != nullptr)
 	{
 		server->stop();
 		server.reset();
 	}
 
+	clearClients();
+
 	if (isCurrentlyLoadingData) return;
 
 	isConnected->setValue(false);
@@ -85,6 +106,8 @@ void WebSocketServerModule::setupServer()
 	isConnected->setValue(true);
 
 	NLOG(niceName, "Server is running on port " << localPort->intValue());
+
+	updateSendThread();
 }
 
 bool WebSocketServerModule::isReadyToSend()
@@ -94,69 +117,263 @@ bool WebSocketServerModule::isReadyToSend()
 
 void WebSocketServerModule::sendMessageInternal(const String& message, var params)
 {
-	if (params.isObject())
+	if (asyncSend->boolValue())
 	{
-		if (params.hasProperty("include"))
-		{
-			var list = params.getProperty("include", var());
-			for (int i = 0; i < list.size(); i++) server->sendTo(message, list[i].toString());
-		}
-		else if (params.hasProperty("exclude"))
-		{
-			var list = params.getProperty("exclude", var());
-			StringArray excludes;
-			for (int i = 0; i < list.size(); i++) excludes.add(list[i].toString());
-			server->sendExclude(message, excludes);
-		}
-		else
-		{
-			server->send(message);
-		}
+		OutgoingMessage::Ptr m = new OutgoingMessage();
+		m->recipients = getRecipients(params);
+		m->message = message;
+		queueMessage(m);
+		return;
+	}
+
+	OutgoingMessage m;
+	m.recipients = getRecipients(params);
+	m.message = message;
+	sendToRecipients(m);
+}
+
+void WebSocketServerModule::sendBytesInternal(Array<uint8> data, var params)
+{
+	Recipients r = getRecipients(params);
+
+	if (r.mode == Recipients::ALL && !asyncSend->boolValue())
+	{
+		//no need to copy the payload for a direct broadcast
+		server->send((const char*)data.getRawDataPointer(), data.size());
+		return;
+	}
+
+	OutgoingMessage::Ptr m = new OutgoingMessage();
+	m->recipients = r;
+	m->isBinary = true;
+	m->data.replaceAll(data.getRawDataPointer(), data.size());
+
+	if (asyncSend->boolValue()) queueMessage(m);
+	else sendToRecipients(*m);
+}
+
+WebSocketServerModule::Recipients WebSocketServerModule::getRecipients(const var& params) const
+{
+	Recipients r;
+	if (!params.isObject()) return r;
+
+	if (params.hasProperty("group"))
+	{
+		r.mode = Recipients::GROUP;
+		r.group = params.getProperty("group", "").toString();
+		r.key = "group:" + r.group;
+		return r;
+	}
+
+	bool include = params.hasProperty("include");
+	if (!include && !params.hasProperty("exclude")) return r;
+
+	r.mode = include ? Recipients::INCLUDE : Recipients::EXCLUDE;
+	var list = params.getProperty(include ? "include" : "exclude", var());
+	for (int i = 0; i < list.size(); i++) r.ids.add(list[i].toString());
+	r.key = (include ? "include:" : "exclude:") + r.ids.joinIntoString(",");
+	return r;
+}
+
+StringArray WebSocketServerModule::getTargetIds(const Recipients& r)
+{
+	if (r.mode != Recipients::GROUP) return r.ids;
+
+	GenericScopedLock lock(clientsLock);
+	return groups[r.group];
+}
+
+void WebSocketServerModule::sendToRecipients(const OutgoingMessage& m)
+{
+	if (server == nullptr) return;
+
+	switch (m.recipients.mode)
+	{
+	case Recipients::ALL:
+		if (m.isBinary) server->send((const char*)m.data.getData(), (int)m.data.getSize());
+		else server->send(m.message);
+		break;
+
+	case Recipients::EXCLUDE:
+		if (m.isBinary) server->sendExclude(m.data, m.recipients.ids);
+		else server->sendExclude(m.message, m.recipients.ids);
+		break;
+
+	default:
+	{
+		//explicit recipients, a connection that is not known yet must never receive it
+		StringArray ids = getTargetIds(m.recipients);
+		for (auto& id : ids) sendToConnection(m, id);
+	}
+	break;
+	}
+}
+
+void WebSocketServerModule::sendToConnection(const OutgoingMessage& m, const String& connectionId)
+{
+	//the payload is shared, framing for each connection is done by the server
+	if (server == nullptr) return;
+	if (m.isBinary) server->sendTo(m.data, connectionId);
+	else server->sendTo(m.message, connectionId);
+}
+
+void WebSocketServerModule::queueMessage(OutgoingMessage::Ptr m)
+{
+	bool isBroadcast = m->recipients.mode == Recipients::ALL || m->recipients.mode == Recipients::EXCLUDE;
+	StringArray ids;
+	if (!isBroadcast) ids = getTargetIds(m->recipients); //resolved before taking the queue lock, clientsLock is never taken inside it
+
+	{
+		GenericScopedLock lock(queueLock);
+		if (isBroadcast) addToQueue(getSendQueue(String()), m.get());
+		else for (auto& id : ids) addToQueue(getSendQueue(id), m.get());
+	}
+
+	sendThread.notify();
+}
+
+WebSocketServerModule::ConnectionQueue* WebSocketServerModule::getSendQueue(const String& connectionId)
+{
+	for (auto& q : sendQueues) if (q->connectionId == connectionId) return q;
+
+	ConnectionQueue* q = sendQueues.add(new ConnectionQueue());
+	q->connectionId = connectionId;
+	return q;
+}
+
+void WebSocketServerModule::addToQueue(ConnectionQueue* q, OutgoingMessage* m)
+{
+	int numForTarget = 0;
+	int oldestIndex = -1;
+	for (int i = 0; i < q->messages.size(); i++)
+	{
+		OutgoingMessage* qm = q->messages.getObjectPointerUnchecked(i);
+		if (qm->isBinary != m->isBinary || qm->recipients.key != m->recipients.key) continue;
+		if (oldestIndex == -1) oldestIndex = i;
+		numForTarget++;
+	}
+
+	if (keepLatestOnly->boolValue() && oldestIndex != -1)
+	{
+		q->messages.set(oldestIndex, m); //replace the pending value, keeping its place in the queue
 	}
 	else
 	{
-		server->send(message);
+		if (numForTarget >= maxQueuedMessages->intValue()) q->messages.remove(oldestIndex);
+		q->messages.add(m);
 	}
 }
 
-void WebSocketServerModule::sendBytesInternal(Array<uint8> data, var params)
+void WebSocketServerModule::processSendQueue(Thread* thread)
 {
-	if (params.isObject())
+	StringArray ids;
+	ReferenceCountedArray<OutgoingMessage> messages;
+
+	while (thread == nullptr || !thread->threadShouldExit())
 	{
-		MemoryBlock b(data.getRawDataPointer(), data.size());
-		if (params.hasProperty("include"))
-		{
-			var list = params.getProperty("include", var());
-			for (int i = 0; i < list.size(); i++) server->sendTo(b, list[i].toString());
-		}
-		else if (params.hasProperty("exclude"))
+		//one message from each queue per pass, so a long backlog for one connection doesn't delay the others
+		ids.clearQuick();
+		messages.clearQuick();
 		{
-			var list = params.getProperty("exclude", var());
-			StringArray excludes;
-			for (int i = 0; i < list.size(); i++) excludes.add(list[i].toString());
-			server->sendExclude(b, excludes);
+			GenericScopedLock lock(queueLock);
+			for (auto& q : sendQueues)
+			{
+				if (q->messages.isEmpty()) continue;
+				ids.add(q->connectionId);
+				messages.add(q->messages.removeAndReturn(0));
+			}
 		}
-		else
+
+		if (messages.isEmpty()) return;
+
+		for (int i = 0; i < messages.size(); i++)
 		{
-			server->send((const char*)data.getRawDataPointer(), data.size());
+			if (ids[i].isEmpty()) sendToRecipients(*messages[i]);
+			else sendToConnection(*messages[i], ids[i]);
 		}
 	}
+}
+
+void WebSocketServerModule::updateSendThread()
+{
+	maxQueuedMessages->setEnabled(asyncSend->boolValue());
+	keepLatestOnly->setEnabled(asyncSend->boolValue());
+
+	if (asyncSend->boolValue())
+	{
+		if (server != nullptr && !sendThread.isThreadRunning()) sendThread.startThread();
+	}
 	else
 	{
-		server->send((const char*)data.getRawDataPointer(), data.size());
+		sendThread.stopThread(1000);
+		processSendQueue(); //flush what was queued before switching
+	}
+}
+
+void WebSocketServerModule::addClientToGroup(const String& connectionId, const String& group)
+{
+	GenericScopedLock lock(clientsLock);
+	StringArray ids = groups[group];
+	if (ids.contains(connectionId)) return;
+	ids.add(connectionId);
+	groups.set(group, ids);
+}
+
+void WebSocketServerModule::removeClientFromGroup(const String& connectionId, const String& group)
+{
+	GenericScopedLock lock(clientsLock);
+	if (!groups.contains(group)) return;
+	StringArray ids = groups[group];
+	ids.removeString(connectionId);
+	if (ids.isEmpty()) groups.remove(group);
+	else groups.set(group, ids);
+}
+
+void WebSocketServerModule::removeClient(const String& connectionId)
+{
+	{
+		GenericScopedLock lock(queueLock);
+		for (int i = sendQueues.size() - 1; i >= 0; i--) if (sendQueues[i]->connectionId == connectionId) sendQueues.remove(i);
+	}
+
+	GenericScopedLock lock(clientsLock);
+	connectedClients.removeString(connectionId);
+
+	StringArray emptyGroups;
+	for (HashMap<String, StringArray>::Iterator it(groups); it.next();)
+	{
+		StringArray ids = it.getValue();
+		if (!ids.contains(connectionId)) continue;
+		ids.removeString(connectionId);
+		if (ids.isEmpty()) emptyGroups.add(it.getKey());
+		else groups.set(it.getKey(), ids);
 	}
-	
+	for (auto& g : emptyGroups) groups.remove(g);
+}
+
+void WebSocketServerModule::clearClients()
+{
+	GenericScopedLock lock(clientsLock);
+	connectedClients.clear();
+	groups.clear();
 }
 
 void WebSocketServerModule::connectionOpened(const String& connectionId)
 {
 	NLOG(niceName, "Connection opened from : " << connectionId);
+
+	{
+		GenericScopedLock lock(clientsLock);
+		connectedClients.addIfNotAlreadyThere(connectionId);
+	}
+
 	numClients->setValue(server->getNumActiveConnections());
 }
 
 void WebSocketServerModule::connectionClosed(const String& connectionId, int status, const String& reason)
 {
 	NLOG(niceName, "Connection closed from : " << connectionId);
+	removeClient(connectionId);
 	numClients->setValue(server->getNumActiveConnections());
 }
 
@@ -243,6 +460,10 @@ void WebSocketServerModule::onControllableFeedbackUpdateInternal(ControllableCon
 	{
 		setupServer();
 	}
+	else if (c == asyncSend)
+	{
+		updateSendThread();
+	}
 }
 
 
@@ -341,3 +562,67 @@ ModuleUI* WebSocketServerModule::getModuleUI()
 {
 	return new WebSocketServerModuleUI(this);
 }
+
+var WebSocketServerModule::addClientToGroupFromScript(const var::NativeFunctionArgs& a)
+{
+	WebSocketServerModule* m = getObjectFromJS<WebSocketServerModule>(a);
+	if (!checkNumArgs(m->niceName, a, 2)) return false;
+	m->addClientToGroup(a.arguments[0].toString(), a.arguments[1].toString());
+	return var();
+}
+
+var WebSocketServerModule::removeClientFromGroupFromScript(const var::NativeFunctionArgs& a)
+{
+	WebSocketServerModule* m = getObjectFromJS<WebSocketServerModule>(a);
+	if (!checkNumArgs(m->niceName, a, 2)) return false;
+	m->removeClientFromGroup(a.arguments[0].toString(), a.arguments[1].toString());
+	return var();
+}
+
+var WebSocketServerModule::getGroupClientsFromScript(const var::NativeFunctionArgs& a)
+{
+	WebSocketServerModule* m = getObjectFromJS<WebSocketServerModule>(a);
+	if (!checkNumArgs(m->niceName, a, 1)) return var();
+
+	var result;
+	GenericScopedLock lock(m->clientsLock);
+	for (auto& id : m->groups[a.arguments[0].toString()]) result.append(id);
+	return result;
+}
+
+var WebSocketServerModule::sendToGroupFromScript(const var::NativeFunctionArgs& a)
+{
+	WebSocketServerModule* m = getObjectFromJS<WebSocketServerModule>(a);
+	if (!checkNumArgs(m->niceName, a, 2)) return false;
+
+	var params(new DynamicObject());
+	params.getDynamicObject()->setProperty("group", a.arguments[0].toString());
+	m->sendMessage(getStringFromArgs(a, 1), params);
+	return var();
+}
+
+var WebSocketServerModule::sendBytesToGroupFromScript(const var::NativeFunctionArgs& a)
+{
+	WebSocketServerModule* m = getObjectFromJS<WebSocketServerModule>(a);
+	if (!checkNumArgs(m->niceName, a, 2)) return false;
+
+	var params(new DynamicObject());
+	params.getDynamicObject()->setProperty("group", a.arguments[0].toString());
+	m->sendBytes(getByteFromArgs(a, 1), params);
+	return var();
+}
+
+WebSocketServerModule::SendThread::SendThread(WebSocketServerModule* module) :
+	Thread("WebSocket Server Send"),
+	module(module)
+{
+}
+
+void WebSocketServerModule::SendThread::run()
+{
+	while (!threadShouldExit())
+	{
+		module->processSendQueue(this);
+		wait(100); //woken up by new messages
+	}
+}
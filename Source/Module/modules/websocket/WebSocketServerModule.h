@@ -26,11 +26,64 @@ public:
 	IntParameter* numClients;
 	BoolParameter* isConnected;
 
+	BoolParameter* asyncSend;
+	IntParameter* maxQueuedMessages;
+	BoolParameter* keepLatestOnly;
+
 	std::unique_ptr<SimpleWebSocketServerBase> server;
 
 	const Identifier wsMessageReceivedId = "wsMessageReceived";
 	const Identifier wsDataReceivedId = "wsDataReceived";
 
+	//Recipients of a message, explicit ids and groups are sent to each of their connections so unknown connections never receive them
+	struct Recipients
+	{
+		enum Mode { ALL, INCLUDE, EXCLUDE, GROUP };
+		Mode mode = ALL;
+		StringArray ids;
+		String group;
+		String key; //identifies the target, used for coalescing
+	};
+
+	//Built once and shared by every queue it is sent from
+	struct OutgoingMessage :
+		public ReferenceCountedObject
+	{
+		Recipients recipients;
+		bool isBinary = false;
+		String message;
+		MemoryBlock data;
+
+		typedef ReferenceCountedObjectPtr<OutgoingMessage> Ptr;
+	};
+
+	//Broadcasts (all or exclude) share one queue and go out in a single server call,
+	//explicit recipients and groups get one bounded queue per connection so a backlog for one client only drops its own messages
+	struct ConnectionQueue
+	{
+		String connectionId; //empty for broadcasts
+		ReferenceCountedArray<OutgoingMessage> messages;
+	};
+
+	class SendThread :
+		public Thread
+	{
+	public:
+		SendThread(WebSocketServerModule* module);
+		~SendThread() {}
+
+		WebSocketServerModule* module;
+		void run() override;
+	};
+
+	CriticalSection clientsLock;
+	StringArray connectedClients;
+	HashMap<String, StringArray> groups; //group name > connection ids
+
+	CriticalSection queueLock;
+	OwnedArray<ConnectionQueue> sendQueues;
+	SendThread sendThread;
+
 	void setupServer();
 
 	virtual bool isReadyToSend() override;
@@ -38,6 +91,22 @@ public:
 	virtual void sendMessageInternal(const String& message, var) override;
 	virtual void sendBytesInternal(Array<uint8> data, var) override;
 
+	Recipients getRecipients(const var& params) const;
+	StringArray getTargetIds(const Recipients& r);
+
+	void sendToRecipients(const OutgoingMessage& m);
+	void sendToConnection(const OutgoingMessage& m, const String& connectionId);
+	void queueMessage(OutgoingMessage::Ptr m);
+	ConnectionQueue* getSendQueue(const String& connectionId);
+	void addToQueue(ConnectionQueue* q, OutgoingMessage* m);
+	void processSendQueue(Thread* thread = nullptr);
+	void updateSendThread();
+
+	void addClientToGroup(const String& connectionId, const String& group);
+	void removeClientFromGroup(const String& connectionId, const String& group);
+	void removeClient(const String& connectionId);
+	void clearClients();
+
 	void connectionOpened(const String &connectionId) override;
 	void connectionClosed(const String &connectionId, int status, const String &reason) override;
 	void connectionError(const String& connectionId, const String& errorMessage) override;
@@ -55,6 +124,12 @@ public:
 
 	ModuleUI* getModuleUI() override;
 
+	static var addClientToGroupFromScript(const var::NativeFunctionArgs& a);
+	static var removeClientFromGroupFromScript(const var::NativeFunctionArgs& a);
+	static var getGroupClientsFromScript(const var::NativeFunctionArgs& a);
+	static var sendToGroupFromScript(const var::NativeFunctionArgs& a);
+	static var sendBytesToGroupFromScript(const var::NativeFunctionArgs& a);
+
 	static WebSocketServerModule* create() { return new WebSocketServerModule(); }
 	virtual String getDefaultTypeString() const override { return "WebSocket Server"; }
 };
\ No newline at end of file
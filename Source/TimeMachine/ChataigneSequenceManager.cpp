@@ -28,6 +28,7 @@ ChataigneSequenceManager::ChataigneSequenceManager() :
 
 ChataigneSequenceManager::~ChataigneSequenceManager()
 {
+	stopTimer();
 }
 
 Sequence* ChataigneSequenceManager::createItem()
@@ -55,6 +56,74 @@ void ChataigneSequenceManager::createSequenceFromAudioFile(File f)
 	clip->filePath->setValue(f.getFullPathName());
 }
 
+void ChataigneSequenceManager::loadDeferredLayers(var sessionData)
+{
+	Array<ChataigneSequence*> sequences;
+	for (auto& i : items)
+	{
+		if (ChataigneSequence* s = dynamic_cast<ChataigneSequence*>(i))
+		{
+			if (s->hasDeferredLayers()) sequences.add(s);
+		}
+	}
+
+	if (sequences.isEmpty()) return;
+
+	//decoding doesn't touch the object tree, so it's done in parallel
+	Array<var> layersData;
+	layersData.resize(sequences.size());
+	SessionArchive::runParallel(sequences.size(), [&sequences, &layersData](int i) { layersData.getReference(i) = sequences[i]->decodeDeferredLayers(); });
+
+	//links (states, routers, other layers...) are resolved when they're loaded, so the layers they point to must already exist
+	StringArray referencedSequences;
+	collectLayerReferences(sessionData, referencedSequences);
+	for (auto& d : layersData) collectLayerReferences(d, referencedSequences);
+
+	for (auto& s : sequences)
+	{
+		if (referencedSequences.contains(s->shortName)) s->loadDeferredLayers();
+	}
+
+	startTimer(50);
+}
+
+void ChataigneSequenceManager::collectLayerReferences(const var& data, StringArray& sequenceNames)
+{
+	if (data.isString())
+	{
+		String s = data.toString();
+		int index = s.indexOf("/sequences/");
+		if (index == -1) return;
+
+		String address = s.substring(index + 11);
+		if (address.fromFirstOccurrenceOf("/", true, false).startsWith("/layers")) sequenceNames.addIfNotAlreadyThere(address.upToFirstOccurrenceOf("/", false, false));
+	}
+	else if (data.isArray())
+	{
+		for (auto& v : *data.getArray()) collectLayerReferences(v, sequenceNames);
+	}
+	else if (DynamicObject* o = data.getDynamicObject())
+	{
+		for (auto& nv : o->getProperties()) collectLayerReferences(nv.value, sequenceNames);
+	}
+}
+
+void ChataigneSequenceManager::timerCallback()
+{
+	//one sequence per callback so the UI stays responsive
+	for (auto& i : items)
+	{
+		if (ChataigneSequence* s = dynamic_cast<ChataigneSequence*>(i))
+		{
+			if (!s->hasDeferredLayers()) continue;
+			s->loadDeferredLayers();
+			return;
+		}
+	}
+
+	stopTimer();
+}
+
 void ChataigneSequenceManager::showMenuAndGetSequenceStatic(ControllableContainer* startFromCC, std::function<void(Sequence*)> returnFunc)
 {
 	getInstance()->showMenuAndGetSequence(startFromCC, returnFunc);
@@ -16,7 +16,8 @@ class ChataigneSequence;
 class SequenceModule;
 
 class ChataigneSequenceManager :
-	public SequenceManager
+	public SequenceManager,
+	public Timer
 {
 public:
 	juce_DeclareSingleton(ChataigneSequenceManager, false)
@@ -32,6 +33,11 @@ public:
 
 	void createSequenceFromAudioFile(File f) override;
 
+	//Layers other parts of the session point to are built during the load, the others on first use or progressively afterwards
+	void loadDeferredLayers(var sessionData);
+	static void collectLayerReferences(const var& data, StringArray& sequenceNames);
+	void timerCallback() override;
+
 	static void showMenuAndGetSequenceStatic(ControllableContainer* startFromCC, std::function<void(Sequence*)> returnFunc);
 	static void showMenuAndGetLayerStatic(ControllableContainer* startFromCC, std::function<void(SequenceLayer*)> returnFunc);
 	static void showMenuAndGetCueStatic(ControllableContainer* startFromCC, std::function<void(TimeCue*)> returnFunc);
@@ -17,7 +17,12 @@ ChataigneSequence::ChataigneSequence() :
 	masterAudioLayer(nullptr),
 	ltcAudioModule(nullptr),
 	ltcEncoder(nullptr, &ltc_encoder_free),
-	mtcFPS(nullptr)
+	mtcFPS(nullptr),
+	isChasing(false),
+	lastChaseHostTime(0),
+	hasPendingLayers(false),
+	layersLoadQueued(false),
+	lastSyncStatsUpdateTime(0)
 {
 	midiSyncDevice = new MIDIDeviceParameter("Sync Devices", "MIDI Devices to send and/or receive MTC to sync the sequence with external systems.");
 	midiSyncDevice->canBeDisabledByUser = true;
@@ -43,6 +48,13 @@ ChataigneSequence::ChataigneSequence() :
 	reverseOffset = addBoolParameter("Reverse Offset", "This allows negative offset", false);
 	resetTimeOnMTCStopped = addBoolParameter("Reset on MTC Stop", "If checked, sequence will stop and reset time when MTC doesn't send data anymore. If not checked, sequence will just keep its current time", false);
 
+	syncLocked = addBoolParameter("Sync Locked", "Is the sequence locked to the received MTC or LTC. When locked, playback is slightly sped up or slowed down to follow the timecode instead of jumping.", false);
+	syncLocked->setControllableFeedbackOnly(true);
+	syncLocked->isSavable = false;
+	syncJitter = addFloatParameter("Sync Jitter", "Measured jitter of the received timecode, in milliseconds", 0, 0);
+	syncJitter->setControllableFeedbackOnly(true);
+	syncJitter->isSavable = false;
+
 
 
 	std::function<bool(ControllableContainer*)> typeCheckFunc = [](ControllableContainer* cc) { return dynamic_cast<AudioModule*>(cc) != nullptr; };
@@ -76,11 +88,74 @@ void ChataigneSequence::clearItem()
 {
 	BaseItem::clearItem();
 
+	{
+		GenericScopedLock lock(deferredLayersLock);
+		deferredLayersData.reset();
+		pendingLayersData = var();
+		hasPendingLayers = false;
+	}
+
 	setMasterAudioLayer(nullptr);
 	setLTCAudioModule(nullptr);
 	Sequence::clearItem();
 }
 
+var ChataigneSequence::decodeDeferredLayers()
+{
+	MemoryBlock layersData;
+	{
+		GenericScopedLock lock(deferredLayersLock);
+		if (deferredLayersData.isEmpty()) return pendingLayersData;
+		layersData.swapWith(deferredLayersData);
+	}
+
+	var decoded = SessionArchive::decodeValue(layersData);
+
+	GenericScopedLock lock(deferredLayersLock);
+	pendingLayersData = decoded;
+	return decoded;
+}
+
+void ChataigneSequence::loadDeferredLayers()
+{
+	jassert(MessageManager::getInstance()->isThisTheMessageThread());
+	if (!hasPendingLayers) return;
+
+	decodeDeferredLayers();
+
+	var layersData;
+	{
+		GenericScopedLock lock(deferredLayersLock);
+		layersData = pendingLayersData;
+		pendingLayersData = var();
+		hasPendingLayers = false;
+	}
+
+	layersLoadQueued = false;
+	if (!layersData.isVoid()) layerManager->loadJSONData(layersData);
+}
+
+void ChataigneSequence::requestDeferredLayers()
+{
+	if (!hasPendingLayers) return;
+
+	if (MessageManager::getInstance()->isThisTheMessageThread())
+	{
+		loadDeferredLayers();
+		return;
+	}
+
+	//items are only created on the message thread, time changes from sync or play threads ask for them once
+	if (layersLoadQueued.exchange(true)) return;
+
+	WeakReference<ControllableContainer> ref(this);
+	MessageManager::callAsync([ref]()
+		{
+			if (ChataigneSequence* s = dynamic_cast<ChataigneSequence*>(ref.get())) s->loadDeferredLayers();
+		}
+	);
+}
+
 void ChataigneSequence::setMasterAudioModule(AudioModule* module)
 {
 	if (masterAudioModule == module) return;
@@ -253,10 +328,11 @@ bool ChataigneSequence::timeIsDrivenByAudio()
 	return Sequence::timeIsDrivenByAudio() && masterAudioModule != nullptr && masterAudioModule->enabled->boolValue();
 }
 
-void ChataigneSequence::addNewMappingLayerFromValues(Array<Point<float>> keys)
+Mapping1DLayer* ChataigneSequence::addNewMappingLayerFromValues(Array<Point<float>> keys)
 {
 	Mapping1DLayer* layer = (Mapping1DLayer*)layerManager->addItem(layerManager->factory.create("Mapping"));
 	layer->automation->addFromPointsAndSimplifyBezier(keys, false);
+	return layer;
 }
 
 void ChataigneSequence::updateLayersSnapKeys()
@@ -285,7 +361,11 @@ void ChataigneSequence::setupMidiSyncDevices()
 
 	//	if ((mtcReceiver != nullptr && midiSyncDevice->inputDevice != mtcReceiver->device) || midiSyncDevice->inputDevice != nullptr)
 	//	{
-	if (midiSyncDevice->inputDevice == nullptr || !midiSyncDevice->enabled) mtcReceiver.reset();
+	if (midiSyncDevice->inputDevice == nullptr || !midiSyncDevice->enabled)
+	{
+		if (mtcReceiver != nullptr) stopChasing();
+		mtcReceiver.reset();
+	}
 	else
 	{
 		mtcReceiver.reset(new MTCReceiver(midiSyncDevice->inputDevice));
@@ -335,6 +415,55 @@ void ChataigneSequence::setupLTCEncoder()
 	ltcEncoder.reset(ltc_encoder_create(sampleRate, fps, tv, 0));
 }
 
+double ChataigneSequence::getSyncOffsetTime() const
+{
+	return syncOffset->floatValue() * (reverseOffset->boolValue() ? -1 : 1);
+}
+
+void ChataigneSequence::chaseTimecode(TimecodeChaser* chaser)
+{
+	double hostTime = TimecodeChaser::getHostTime();
+	double offset = getSyncOffsetTime();
+	double time = chaser->getSourceTimeAt(hostTime) + offset;
+	double followerTime = currentTime->floatValue() - offset;
+
+	if (!isPlaying->boolValue() || chaser->shouldSeek(followerTime, hostTime))
+	{
+		setCurrentTime(time, true, true);
+	}
+	else
+	{
+		//soft correction, the sequence keeps running on its own clock at the user's play speed,
+		//the chase rate is applied as a small time nudge over the interval since the last update
+		if (isChasing)
+		{
+			double dt = jlimit(0.0, chaser->timeout, hostTime - lastChaseHostTime);
+			double rate = chaser->getCorrectedRate(followerTime, hostTime);
+			double nudge = (rate - playSpeed->floatValue()) * dt;
+			if (nudge != 0) setCurrentTime(currentTime->floatValue() + nudge, true, false);
+		}
+
+		isChasing = true;
+	}
+
+	lastChaseHostTime = hostTime;
+
+	uint32 t = Time::getMillisecondCounter();
+	if (t > lastSyncStatsUpdateTime + 250)
+	{
+		TimecodeChaser::Stats stats = chaser->getStats();
+		syncLocked->setValue(stats.isLocked);
+		syncJitter->setValue(stats.jitter * 1000);
+		lastSyncStatsUpdateTime = t;
+	}
+}
+
+void ChataigneSequence::stopChasing()
+{
+	isChasing = false;
+	syncLocked->setValue(false);
+}
+
 void ChataigneSequence::updateSampleRate()
 {
 	setupLTCEncoder();
@@ -352,6 +481,9 @@ void ChataigneSequence::audioDeviceIOCallbackWithContext(const float* const* inp
 
 void ChataigneSequence::onContainerParameterChangedInternal(Parameter* p)
 {
+	//first use of the sequence
+	if (p == isPlaying || p == currentTime) requestDeferredLayers();
+
 	Sequence::onContainerParameterChangedInternal(p);
 
 	if (p == fps)
@@ -441,7 +573,7 @@ void ChataigneSequence::onExternalParameterValueChanged(Parameter* p)
 			{
 				if (ltcAudioModule->ltcPlaying->boolValue())
 				{
-					double time = ltcAudioModule->ltcTime->floatValue() + (syncOffset->floatValue() * (reverseOffset->boolValue() ? -1 : 1));
+					double time = ltcAudioModule->ltcChaser.getSourceTimeAt(TimecodeChaser::getHostTime()) + getSyncOffsetTime();
 					if (time >= 0 && time < totalTime->floatValue())
 					{
 						setCurrentTime(time, true, true);
@@ -450,27 +582,55 @@ void ChataigneSequence::onExternalParameterValueChanged(Parameter* p)
 				}
 				else
 				{
+					stopChasing();
 					pauseTrigger->trigger();
 				}
 			}
 			else if (p == ltcAudioModule->ltcTime)
 			{
-				double time = ltcAudioModule->ltcTime->floatValue() + (syncOffset->floatValue() * (reverseOffset->boolValue() ? -1 : 1));
-				double diff = fabs(currentTime->floatValue() - time);
-				if (diff > 1) setCurrentTime(time, true, true);
+				if (ltcAudioModule->ltcPlaying->boolValue()) chaseTimecode(&ltcAudioModule->ltcChaser);
 			}
 		}
 	}
 }
 
+var ChataigneSequence::getJSONData(bool includeNonOverriden)
+{
+	//layers that were never used are saved as they were loaded, without being built
+	var layersData = hasPendingLayers ? decodeDeferredLayers() : var();
+
+	var data = Sequence::getJSONData(includeNonOverriden);
+	if (!layersData.isVoid()) data.getDynamicObject()->setProperty(layerManager->shortName, layersData);
+	return data;
+}
+
+void ChataigneSequence::loadJSONDataInternal(var data)
+{
+	var layersData = data.getProperty(layerManager->shortName, var());
+	if (layersData.isBinaryData())
+	{
+		{
+			GenericScopedLock lock(deferredLayersLock);
+			deferredLayersData = *layersData.getBinaryData();
+			pendingLayersData = var();
+			hasPendingLayers = true;
+		}
+
+		data.getDynamicObject()->removeProperty(layerManager->shortName);
+	}
+
+	Sequence::loadJSONDataInternal(data);
+}
+
 void ChataigneSequence::mtcStarted()
 {
-	double time = mtcReceiver->getTime() + (syncOffset->floatValue() * (reverseOffset->boolValue() ? -1 : 1));
+	double time = mtcReceiver->getTime() + getSyncOffsetTime();
 	if (time >= 0 && time < totalTime->floatValue()) playTrigger->trigger();
 }
 
 void ChataigneSequence::mtcStopped()
 {
+	stopChasing();
 	if (resetTimeOnMTCStopped->boolValue()) stopTrigger->trigger();
 	else pauseTrigger->trigger();
 }
@@ -479,10 +639,15 @@ void ChataigneSequence::mtcTimeUpdated(bool isFullFrame)
 {
 	if (mtcReceiver == nullptr) return;
 
-	double time = mtcReceiver->getTime() + (syncOffset->floatValue() * (reverseOffset->boolValue() ? -1 : 1));
-	double diff = fabs(currentTime->floatValue() - time);
-	bool isJump = diff > 1;
-	bool seekMode = isJump || !mtcReceiver->isPlaying;
-	if (mtcReceiver->isPlaying && !isPlaying->boolValue() && time >= 0 && time < totalTime->floatValue()) playTrigger->trigger();
-	setCurrentTime(time, isJump, seekMode);
+	double time = mtcReceiver->getTime() + getSyncOffsetTime();
+
+	//full frames are locate messages, always seek to them
+	if (isFullFrame || !mtcReceiver->isPlaying)
+	{
+		setCurrentTime(time, true, true);
+		return;
+	}
+
+	if (!isPlaying->boolValue() && time >= 0 && time < totalTime->floatValue()) playTrigger->trigger();
+	chaseTimecode(&mtcReceiver->chaser);
 }
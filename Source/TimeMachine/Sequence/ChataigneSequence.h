@@ -11,6 +11,7 @@
 #pragma once
 
 class ChataigneAudioLayer;
+class Mapping1DLayer;
 
 class AudioModule;
 class MTCSender;
@@ -47,8 +48,28 @@ public:
 	FloatParameter* syncOffset;
 	BoolParameter* reverseOffset;
 
+	//Chase
+	BoolParameter* syncLocked;
+	FloatParameter* syncJitter;
+	bool isChasing;
+	double lastChaseHostTime;
+	uint32 lastSyncStatsUpdateTime;
+
+	//Layers from a compact session are kept encoded until the sequence manager has loaded, so they can be decoded in parallel.
+	//Layers nothing else points to are then only built on first use (play, seek, save) or progressively once the session is ready
+	MemoryBlock deferredLayersData;
+	var pendingLayersData; //decoded, not built yet
+	CriticalSection deferredLayersLock;
+	std::atomic<bool> hasPendingLayers;
+	std::atomic<bool> layersLoadQueued;
+
 	virtual void clearItem() override;
 
+	bool hasDeferredLayers() const { return hasPendingLayers; }
+	var decodeDeferredLayers(); //thread safe, keeps the decoded data as pending and returns it
+	void loadDeferredLayers(); //message thread only, builds the pending layers
+	void requestDeferredLayers(); //any thread, layers are built right away on the message thread or as soon as possible from other threads
+
 	void setMasterAudioModule(AudioModule * module);
 
 	void updateTargetAudioLayer(ChataigneAudioLayer* excludeLayer = nullptr);
@@ -65,7 +86,7 @@ public:
 	
     virtual bool timeIsDrivenByAudio() override;
 
-	void addNewMappingLayerFromValues(Array<Point<float>> keys);
+	Mapping1DLayer* addNewMappingLayerFromValues(Array<Point<float>> keys);
 
 	void updateLayersSnapKeys();
 
@@ -75,6 +96,10 @@ public:
 
 	void setupLTCEncoder();
 
+	double getSyncOffsetTime() const;
+	void chaseTimecode(TimecodeChaser* chaser);
+	void stopChasing();
+
 	virtual void updateSampleRate() override;
 	virtual void audioDeviceIOCallbackWithContext(const float* const* inputChannelData,
 		int numInputChannels,
@@ -90,6 +115,9 @@ public:
 	virtual void onContainerTriggerTriggered(Trigger *) override;
 	virtual void onExternalParameterValueChanged(Parameter *) override;
 
+	var getJSONData(bool includeNonOverriden = false) override;
+	void loadJSONDataInternal(var data) override;
+
 	virtual void mtcStarted() override;
 	virtual void mtcStopped() override;
 	virtual void mtcTimeUpdated(bool isFullFrame) override;
@@ -15,7 +15,10 @@ ChataigneAudioLayer::ChataigneAudioLayer(ChataigneSequence* _sequence, var param
 	audioModule(nullptr),
 	chataigneSequence(_sequence),
 	timeAtStartRecord(0),
-	arm(nullptr)
+	arm(nullptr),
+	analysisToNewMappingLayers(false),
+	analysisToClipboard(false),
+	analysisDataOnly(false)
 {
 	ModuleManager::getInstance()->addBaseManagerListener(this);
 
@@ -24,6 +27,10 @@ ChataigneAudioLayer::ChataigneAudioLayer(ChataigneSequence* _sequence, var param
 	arm = addBoolParameter("Arm", "If checked, this will record audio and save it", false);
 	autoDisarm = addBoolParameter("Auto Disarm", "If checked, this will automatically set Arm to false when the sequence stops", false);
 
+	analysisProgress = addFloatParameter("Analysis Progress", "Progress of the current clip analysis", 0, 0, 1);
+	analysisProgress->setControllableFeedbackOnly(true);
+	analysisProgress->isSavable = false;
+
 
 	uiHeight->setValue(80);
 }
@@ -35,6 +42,7 @@ ChataigneAudioLayer::~ChataigneAudioLayer()
 
 void ChataigneAudioLayer::clearItem()
 {
+	analyzer.reset();
 	AudioLayer::clearItem();
 	if (ModuleManager::getInstanceWithoutCreating() != nullptr) ModuleManager::getInstance()->removeBaseManagerListener(this);
 	setAudioModule(nullptr);
@@ -152,62 +160,95 @@ float ChataigneAudioLayer::getVolumeFactor()
 
 void ChataigneAudioLayer::exportRMS(bool toNewMappingLayer, bool toClipboard, bool dataOnly)
 {
-	double frameLength = 1.0 / sequence->fps->intValue();
-	int numFrames = sequence->totalTime->floatValue() / frameLength;
-
-	Array<Point<float>> values;
-
-	AudioSampleBuffer buffer;
-	AudioLayerClip* curClip = nullptr;
-
+	ChataigneAudioLayerAnalyzer::Options options;
+	options.maxChannels = 1;
+	exportAnalysis(options, toNewMappingLayer, toClipboard, dataOnly);
+}
 
-	for (int i = 0; i < numFrames; ++i)
+void ChataigneAudioLayer::exportAnalysis(ChataigneAudioLayerAnalyzer::Options options, bool toNewMappingLayers, bool toClipboard, bool dataOnly)
+{
+	if (analyzer != nullptr && analyzer->isThreadRunning())
 	{
-		float t = i * frameLength;
-		float value = 0;
-		AudioLayerClip* clip = (AudioLayerClip*)clipManager.getBlockAtTime(t);
+		NLOGWARNING(niceName, "An analysis is already running");
+		return;
+	}
 
-		if (clip != curClip)
-		{
-			curClip = clip;
-			if (curClip != nullptr && curClip->readerSource != nullptr)
-			{
-				buffer.setSize(2, (int)curClip->readerSource->getAudioFormatReader()->lengthInSamples, false, true);
-				curClip->readerSource->getAudioFormatReader()->read(&buffer, 0, buffer.getNumSamples(), 0, true, true);
-			}
-		}
+	double fps = sequence->fps->intValue();
+	int numFrames = (int)(sequence->totalTime->floatValue() * fps);
 
+	Array<ChataigneAudioLayerAnalyzer::ClipInfo> clips;
+	for (auto& b : clipManager.items)
+	{
+		AudioLayerClip* clip = (AudioLayerClip*)b;
+		if (!clip->filePath->getFile().existsAsFile()) continue;
+
+		ChataigneAudioLayerAnalyzer::ClipInfo info;
+		info.file = clip->filePath->getFile();
+		info.startTime = clip->time->floatValue();
+		info.length = clip->coreLength->floatValue();
+		info.endTime = info.startTime + info.length;
+		clips.add(info);
+	}
 
-		if (curClip != nullptr)
-		{
-			int rmsSampleCount = frameLength * buffer.getNumSamples() / curClip->coreLength->floatValue() * 10;
-			int startSample = (t - clip->time->floatValue()) * buffer.getNumSamples() / curClip->coreLength->floatValue();
+	//clips are analyzed separately, a clip stops where the next one starts
+	struct ClipComparator { static int compareElements(const ChataigneAudioLayerAnalyzer::ClipInfo& a, const ChataigneAudioLayerAnalyzer::ClipInfo& b) { return a.startTime < b.startTime ? -1 : a.startTime > b.startTime ? 1 : 0; } };
+	ClipComparator comparator;
+	clips.sort(comparator);
+	for (int i = 0; i < clips.size() - 1; i++) clips.getReference(i).endTime = jmin(clips[i].endTime, clips[i + 1].startTime);
 
-			if (rmsSampleCount > 0) value = buffer.getRMSLevel(0, startSample, jmin(rmsSampleCount, buffer.getNumSamples() - startSample));
-		}
+	analysisToNewMappingLayers = toNewMappingLayers;
+	analysisToClipboard = toClipboard;
+	analysisDataOnly = dataOnly;
 
-		values.add({ t, value });
-	}
+	analysisProgress->setValue(0);
+	analyzer.reset(new ChataigneAudioLayerAnalyzer(clips, fps, numFrames, options));
+	analyzer->onProgress = [this](float progress) { analysisProgress->setValue(progress); };
 
-	String s = "";
-	for (int i = 0; i < values.size(); ++i)
+	WeakReference<Inspectable> layerRef(this);
+	analyzer->onFinished = [this, layerRef]()
 	{
-		if (i > 0) s += "\n";
-		if (!dataOnly) s += String(i) + "\t" + String(values[i].x, 3) + "\t";
-		s += String(values[i].y, 3);
-	}
+		if (layerRef.wasObjectDeleted()) return;
+		analysisFinished();
+	};
+
+	analyzer->startThread();
+}
 
+void ChataigneAudioLayer::analysisFinished()
+{
+	if (analyzer == nullptr || !analyzer->success) return;
+	analyzer->waitForThreadToExit(1000);
 
-	if (toClipboard)
+	if (analysisToClipboard)
 	{
-		SystemClipboard::copyTextToClipboard(s);
-		NLOG(niceName, values.size() << " keys copied to clipboard");
+		if (ChataigneAudioLayerAnalyzer::Feature* f = analyzer->getFeature("RMS 1"))
+		{
+			MemoryOutputStream os;
+			for (int i = 0; i < f->values.size(); ++i)
+			{
+				if (i > 0) os << "\n";
+				if (!analysisDataOnly) os << String(i) << "\t" << String(i / analyzer->fps, 3) << "\t";
+				os << String(f->values[i], 3);
+			}
+
+			SystemClipboard::copyTextToClipboard(os.toString());
+			NLOG(niceName, f->values.size() << " keys copied to clipboard");
+		}
 	}
 
-	if (toNewMappingLayer)
+	if (analysisToNewMappingLayers)
 	{
-		chataigneSequence->addNewMappingLayerFromValues(values);
+		for (auto& f : analyzer->features)
+		{
+			Array<Point<float>> keys = analyzer->getReducedKeys(f, .002f);
+			if (Mapping1DLayer* layer = chataigneSequence->addNewMappingLayerFromValues(keys))
+			{
+				layer->setNiceName(niceName + " " + f->name);
+			}
+		}
 	}
+
+	analyzer.reset();
 }
 
 void ChataigneAudioLayer::onContainerParameterChanged(Parameter* p)
@@ -32,6 +32,13 @@ public:
 	Array<AudioProcessorGraph::Connection> inputConnections;
 	float timeAtStartRecord;
 
+	//Analysis
+	FloatParameter* analysisProgress;
+	std::unique_ptr<ChataigneAudioLayerAnalyzer> analyzer;
+	bool analysisToNewMappingLayers;
+	bool analysisToClipboard;
+	bool analysisDataOnly;
+
 	virtual void clearItem() override;
 
 	void setAudioModule(AudioModule * newModule);
@@ -46,6 +53,8 @@ public:
 
 	virtual float getVolumeFactor() override;
 	void exportRMS(bool toNewMappingLayer, bool toClipboard, bool dataOnly = false);
+	void exportAnalysis(ChataigneAudioLayerAnalyzer::Options options, bool toNewMappingLayers, bool toClipboard, bool dataOnly = false);
+	void analysisFinished();
 
 
 	void onContainerParameterChanged(Parameter* p) override;
@@ -0,0 +1,202 @@
+/*
+  ==============================================================================
+
+	ChataigneAudioLayerAnalyzer.cpp
+	Created: 19 Oct 2026 4:21:37pm
+	Author:  bkupe
+
+  ==============================================================================
+*/
+
+ChataigneAudioLayerAnalyzer::Feature::Feature(const String& name, int numFrames) :
+	name(name)
+{
+	values.insertMultiple(0, 0, numFrames);
+}
+
+ChataigneAudioLayerAnalyzer::ChataigneAudioLayerAnalyzer(Array<ClipInfo> clips, double fps, int numFrames, Options options) :
+	Thread("Audio Layer Analyzer"),
+	clips(clips),
+	fps(fps),
+	numFrames(numFrames),
+	options(options),
+	success(false),
+	numFramesDone(0)
+{
+}
+
+ChataigneAudioLayerAnalyzer::~ChataigneAudioLayerAnalyzer()
+{
+	stopThread(3000);
+}
+
+void ChataigneAudioLayerAnalyzer::run()
+{
+	int totalFrames = 0;
+	for (auto& c : clips) totalFrames += jmax(0, jmin(numFrames, (int)std::ceil(c.endTime * fps)) - jmax(0, (int)std::ceil(c.startTime * fps)));
+
+	//clips don't share any frame, each job only writes its own range in the features
+	ThreadPool pool(jmax(1, jmin(clips.size(), SystemStats::getNumCpus())));
+	for (int i = 0; i < clips.size(); i++) pool.addJob([this, i]() { analyzeClip(clips.getReference(i)); });
+
+	while (pool.getNumJobs() > 0)
+	{
+		if (threadShouldExit())
+		{
+			pool.removeAllJobs(true, 3000);
+			return;
+		}
+
+		if (onProgress != nullptr && totalFrames > 0) onProgress(numFramesDone.load() * 1.0f / totalFrames);
+		wait(50);
+	}
+
+	success = true;
+	if (onProgress != nullptr) onProgress(1);
+	if (onFinished != nullptr) MessageManager::callAsync(onFinished);
+}
+
+void ChataigneAudioLayerAnalyzer::analyzeClip(const ClipInfo& clip)
+{
+	AudioFormatManager formatManager;
+	formatManager.registerBasicFormats();
+
+	std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(clip.file));
+	if (reader == nullptr || reader->lengthInSamples <= 0 || clip.length <= 0)
+	{
+		LOGWARNING("Could not read " << clip.file.getFileName() << " for analysis");
+		return;
+	}
+
+	int numChannels = (int)reader->numChannels;
+	if (options.maxChannels > 0) numChannels = jmin(numChannels, options.maxChannels);
+	if (numChannels == 0) return;
+
+	Array<Feature*> rmsFeatures;
+	Array<Feature*> peakFeatures;
+	for (int i = 0; i < numChannels; i++)
+	{
+		if (options.rms) rmsFeatures.add(getOrCreateFeature("RMS " + String(i + 1)));
+		if (options.peak) peakFeatures.add(getOrCreateFeature("Peak " + String(i + 1)));
+	}
+
+	Feature* lowFeature = options.bands ? getOrCreateFeature("Low") : nullptr;
+	Feature* midFeature = options.bands ? getOrCreateFeature("Mid") : nullptr;
+	Feature* highFeature = options.bands ? getOrCreateFeature("High") : nullptr;
+	Feature* onsetFeature = options.onsets ? getOrCreateFeature("Onsets") : nullptr;
+
+	//the file is stretched to the clip length in the sequence
+	const double samplesPerSecond = reader->lengthInSamples / clip.length;
+	const int firstFrame = jmax(0, (int)std::ceil(clip.startTime * fps));
+	const int endFrame = jmin(numFrames, (int)std::ceil(clip.endTime * fps));
+	const int maxFrameSamples = (int)std::ceil(samplesPerSecond / fps) + 1;
+
+	AudioBuffer<float> buffer((int)reader->numChannels, maxFrameSamples); //only one frame is in memory at a time
+	AudioBuffer<float> bandBuffer(3, maxFrameSamples);
+
+	IIRFilter lowFilter, midFilter, highFilter;
+	lowFilter.setCoefficients(IIRCoefficients::makeLowPass(reader->sampleRate, 200));
+	midFilter.setCoefficients(IIRCoefficients::makeBandPass(reader->sampleRate, 630, .5));
+	highFilter.setCoefficients(IIRCoefficients::makeHighPass(reader->sampleRate, 2000));
+
+	float prevLevelDB = -100;
+
+	for (int frame = firstFrame; frame < endFrame; frame++)
+	{
+		if (threadShouldExit()) return;
+
+		int64 startSample = jlimit<int64>(0, reader->lengthInSamples, (int64)((frame / fps - clip.startTime) * samplesPerSecond));
+		int64 endSample = jlimit<int64>(0, reader->lengthInSamples, (int64)(((frame + 1) / fps - clip.startTime) * samplesPerSecond));
+		int numSamples = (int)jmin<int64>(endSample - startSample, maxFrameSamples);
+
+		numFramesDone++;
+		if (numSamples <= 0) continue;
+
+		reader->read(&buffer, 0, numSamples, startSample, true, true);
+
+		float sumSquares = 0;
+		for (int c = 0; c < numChannels; c++)
+		{
+			float rms = buffer.getRMSLevel(c, 0, numSamples);
+			sumSquares += rms * rms;
+			if (options.rms) rmsFeatures[c]->values.set(frame, rms);
+			if (options.peak) peakFeatures[c]->values.set(frame, buffer.getMagnitude(c, 0, numSamples));
+		}
+
+		if (options.bands)
+		{
+			//filters keep their state from one frame to the next, frames are contiguous
+			for (int b = 0; b < 3; b++)
+			{
+				bandBuffer.copyFrom(b, 0, buffer.getReadPointer(0), numSamples, 1.0f / numChannels);
+				for (int c = 1; c < numChannels; c++) bandBuffer.addFrom(b, 0, buffer, c, 0, numSamples, 1.0f / numChannels);
+			}
+
+			lowFilter.processSamples(bandBuffer.getWritePointer(0), numSamples);
+			midFilter.processSamples(bandBuffer.getWritePointer(1), numSamples);
+			highFilter.processSamples(bandBuffer.getWritePointer(2), numSamples);
+
+			lowFeature->values.set(frame, bandBuffer.getRMSLevel(0, 0, numSamples));
+			midFeature->values.set(frame, bandBuffer.getRMSLevel(1, 0, numSamples));
+			highFeature->values.set(frame, bandBuffer.getRMSLevel(2, 0, numSamples));
+		}
+
+		if (options.onsets)
+		{
+			//rise of the level in dB, 24dB or more between two frames is a full onset
+			float levelDB = Decibels::gainToDecibels(std::sqrt(sumSquares / numChannels), -100.0f);
+			onsetFeature->values.set(frame, jlimit(0.0f, 1.0f, (levelDB - prevLevelDB) / 24.0f));
+			prevLevelDB = levelDB;
+		}
+	}
+}
+
+ChataigneAudioLayerAnalyzer::Feature* ChataigneAudioLayerAnalyzer::getOrCreateFeature(const String& name)
+{
+	GenericScopedLock lock(featuresLock);
+	if (Feature* f = getFeature(name)) return f;
+	return features.add(new Feature(name, numFrames));
+}
+
+ChataigneAudioLayerAnalyzer::Feature* ChataigneAudioLayerAnalyzer::getFeature(const String& name)
+{
+	GenericScopedLock lock(featuresLock);
+	for (auto& f : features) if (f->name == name) return f;
+	return nullptr;
+}
+
+Array<Point<float>> ChataigneAudioLayerAnalyzer::getReducedKeys(const Feature* f, float tolerance) const
+{
+	Array<Point<float>> keys;
+	const int n = f->values.size();
+	if (n == 0) return keys;
+
+	auto getKey = [f, this](int i) { return Point<float>((float)(i / fps), f->values[i]); };
+
+	//only keep the frames that can't be interpolated from the previous kept key
+	int anchor = 0;
+	keys.add(getKey(0));
+
+	for (int i = 2; i < n; i++)
+	{
+		bool fits = i - anchor <= maxReductionWindow;
+		const float startValue = f->values[anchor];
+		const float endValue = f->values[i];
+
+		for (int j = anchor + 1; j < i && fits; j++)
+		{
+			float interpolated = startValue + (endValue - startValue) * (j - anchor) / (float)(i - anchor);
+			if (std::abs(f->values[j] - interpolated) > tolerance) fits = false;
+		}
+
+		if (!fits)
+		{
+			anchor = i - 1;
+			keys.add(getKey(anchor));
+		}
+	}
+
+	if (n > 1) keys.add(getKey(n - 1));
+
+	return keys;
+}
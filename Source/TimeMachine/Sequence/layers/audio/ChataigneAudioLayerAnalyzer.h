@@ -0,0 +1,76 @@
+/*
+  ==============================================================================
+
+	ChataigneAudioLayerAnalyzer.h
+	Created: 19 Oct 2026 4:21:37pm
+	Author:  bkupe
+
+  ==============================================================================
+*/
+
+#pragma once
+
+/*
+Offline analysis of the clips of an audio layer, on the sequence frame grid.
+Each clip is read frame by frame with its own reader, so memory only depends on the number of frames and not on the length of the files.
+Clips are analyzed in parallel, each clip only writes the frames it owns.
+*/
+class ChataigneAudioLayerAnalyzer :
+	public Thread
+{
+public:
+	struct ClipInfo
+	{
+		File file;
+		double startTime = 0;
+		double length = 0; //length of the clip in the sequence, the file is stretched to fit
+		double endTime = 0; //analysis stops here, at the clip end or at the start of the next clip
+	};
+
+	struct Options
+	{
+		bool rms = true;
+		bool peak = false;
+		bool bands = false; //low / mid / high energies of the mixed channels
+		bool onsets = false;
+		int maxChannels = 0; //0 means all channels
+	};
+
+	struct Feature
+	{
+		Feature(const String& name, int numFrames);
+
+		String name;
+		Array<float> values; //one value per frame
+	};
+
+	ChataigneAudioLayerAnalyzer(Array<ClipInfo> clips, double fps, int numFrames, Options options);
+	~ChataigneAudioLayerAnalyzer();
+
+	Array<ClipInfo> clips;
+	double fps;
+	int numFrames;
+	Options options;
+
+	OwnedArray<Feature> features; //only complete when finished
+	bool success;
+
+	std::function<void(float)> onProgress; //called from the analysis thread
+	std::function<void()> onFinished; //called on the message thread
+
+	void run() override;
+
+	Feature* getFeature(const String& name);
+	Array<Point<float>> getReducedKeys(const Feature* f, float tolerance) const;
+
+private:
+	CriticalSection featuresLock;
+	std::atomic<int> numFramesDone;
+
+	void analyzeClip(const ClipInfo& clip);
+	Feature* getOrCreateFeature(const String& name);
+
+	static const int maxReductionWindow = 256;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ChataigneAudioLayerAnalyzer)
+};
@@ -85,6 +85,7 @@ void ChataigneAudioLayerPanel::mouseDown(const MouseEvent& e)
 			p.addItem(1, "Export Enveloppe to new mapping layer");
 			p.addItem(2, "Export Enveloppe to clipboard");
 			p.addItem(3, "Export Enveloppe to clipboard (data only)");
+			p.addItem(4, "Export full analysis to new mapping layers");
 
 			p.showMenuAsync(PopupMenu::Options(), [this](int result)
 				{
@@ -101,6 +102,16 @@ void ChataigneAudioLayerPanel::mouseDown(const MouseEvent& e)
 					case 3:
 						chataigneAudioLayer->exportRMS(false, true, true);
 						break;
+
+					case 4:
+					{
+						ChataigneAudioLayerAnalyzer::Options options;
+						options.peak = true;
+						options.bands = true;
+						options.onsets = true;
+						chataigneAudioLayer->exportAnalysis(options, true, false);
+					}
+					break;
 					}
 				}); 
 		}
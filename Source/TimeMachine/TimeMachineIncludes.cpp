@@ -16,6 +16,7 @@
 
 #include "ChataigneSequenceManager.cpp"
 #include "Sequence/ChataigneSequence.cpp"
+#include "Sequence/layers/audio/ChataigneAudioLayerAnalyzer.cpp"
 #include "Sequence/layers/audio/ChataigneAudioLayer.cpp"
 #include "Sequence/layers/audio/ui/ChataigneAudioLayerPanel.cpp"
 #include "Sequence/layers/audio/ui/ChataigneAudioLayerTimeline.cpp"
@@ -19,6 +19,7 @@
 #include "ChataigneSequenceManager.h"
 #include "Sequence/ChataigneSequence.h"
 
+#include "Sequence/layers/audio/ChataigneAudioLayerAnalyzer.h"
 #include "Sequence/layers/audio/ChataigneAudioLayer.h"
 #include "Sequence/layers/audio/ui/ChataigneAudioLayerPanel.h"
 #include "Sequence/layers/audio/ui/ChataigneAudioLayerTimeline.h"